@@ -0,0 +1,26 @@
+###
+ # THIS FILE IS AUTOMATICALLY GENERATED
+ # Do not edit this file. It will be overwritten when the configure script is run.
+###
+
+######
+# Build ID: 2374964c984ad618
+# Executable: ./bin/champsim_gate
+# Module Names: ('btbDbasic_btb', 'branchDbimodal', 'branchDgshare', 'branchDhashed_perceptron', 'branchDperceptron', 'branchDtage_sc', 'prefetcherDampm', 'prefetcherDampm_cheri', 'prefetcherDasd', 'prefetcherDberti', 'prefetcherDberti_cheri', 'prefetcherDcheri_ptr_chase', 'prefetcherDhasd', 'prefetcherDip_stride', 'prefetcherDip_stride_cheri', 'prefetcherDip_stride_cheri_dynamic', 'prefetcherDipcp', 'prefetcherDipcp_cheri', 'prefetcherDnext_line', 'prefetcherDnext_line_cheri', 'prefetcherDno', 'prefetcherDsms', 'prefetcherDsms_cheri', 'prefetcherDspp_cheri', 'prefetcherDspp_dev', 'prefetcherDspp_ppf', 'prefetcherDspp_ppf_cheri', 'prefetcherDva_ampm_lite', 'replacementDdrrip', 'replacementDlru', 'replacementDrandom', 'replacementDship', 'replacementDsrrip')
+######
+
+BIN_ROOT := bin
+$(BIN_ROOT)/champsim_gate: build_id := 2374964c984ad618
+nonbase_module_objs += $(filter-out $(base_module_objs),$(call get_module_list, btb/basic_btb \
+  branch/bimodal branch/gshare branch/hashed_perceptron \
+  branch/perceptron branch/tage_sc prefetcher/ampm \
+  prefetcher/ampm_cheri prefetcher/asd prefetcher/berti \
+  prefetcher/berti_cheri prefetcher/cheri_ptr_chase prefetcher/hasd \
+  prefetcher/ip_stride prefetcher/ip_stride_cheri prefetcher/ip_stride_cheri_dynamic \
+  prefetcher/ipcp prefetcher/ipcp_cheri prefetcher/next_line \
+  prefetcher/next_line_cheri prefetcher/no prefetcher/sms \
+  prefetcher/sms_cheri prefetcher/spp_cheri prefetcher/spp_dev \
+  prefetcher/spp_ppf prefetcher/spp_ppf_cheri prefetcher/va_ampm_lite \
+  replacement/drrip replacement/lru replacement/random \
+  replacement/ship replacement/srrip ))
+executable_name += $(BIN_ROOT)/champsim_gate
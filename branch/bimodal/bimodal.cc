@@ -10,3 +10,7 @@ void bimodal::last_branch_result(champsim::address ip, champsim::address branch_
 {
   bimodal_table[hash(ip)] += taken ? 1 : -1;
 }
+
+void bimodal::branch_predictor_save_state(champsim::checkpoint_writer& out) const { out.write(bimodal_table); }
+
+void bimodal::branch_predictor_load_state(champsim::checkpoint_reader& in) { in.read(bimodal_table); }
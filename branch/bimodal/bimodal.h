@@ -4,6 +4,7 @@
 #include <array>
 
 #include "address.h"
+#include "checkpoint.h"
 #include "modules.h"
 #include "msl/fwcounter.h"
 
@@ -23,6 +24,8 @@ public:
   // void initialize_branch_predictor();
   bool predict_branch(champsim::address ip);
   void last_branch_result(champsim::address ip, champsim::address branch_target, bool taken, uint8_t branch_type);
+  void branch_predictor_save_state(champsim::checkpoint_writer& out) const;
+  void branch_predictor_load_state(champsim::checkpoint_reader& in);
 };
 
 #endif
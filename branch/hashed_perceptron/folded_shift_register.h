@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "checkpoint.h"
 #include "modules.h"
 #include "msl/bits.h"
 #include "msl/fwcounter.h"
@@ -39,6 +40,9 @@ public:
    *  Insert this value into the shift register
    **/
   void push_back(bool ins);
+
+  void save_state(champsim::checkpoint_writer& out) const { out.write(words); }
+  void load_state(champsim::checkpoint_reader& in) { in.read(words); }
 };
 
 template <champsim::data::bits WORD_LEN>
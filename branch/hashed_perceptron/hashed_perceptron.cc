@@ -100,3 +100,23 @@ void hashed_perceptron::adjust_threshold(bool correct)
     }
   }
 }
+
+void hashed_perceptron::branch_predictor_save_state(champsim::checkpoint_writer& out) const
+{
+  out.write(tables);
+  for (const auto& word : ghist_words) {
+    word.save_state(out);
+  }
+  out.write(theta);
+  out.write(tc);
+}
+
+void hashed_perceptron::branch_predictor_load_state(champsim::checkpoint_reader& in)
+{
+  in.read(tables);
+  for (auto& word : ghist_words) {
+    word.load_state(in);
+  }
+  in.read(theta);
+  in.read(tc);
+}
@@ -6,6 +6,7 @@
 #include <tuple>
 #include <vector>
 
+#include "checkpoint.h"
 #include "folded_shift_register.h"
 #include "modules.h"
 #include "msl/bits.h"
@@ -51,6 +52,8 @@ public:
   bool predict_branch(champsim::address pc);
   void last_branch_result(champsim::address pc, champsim::address branch_target, bool taken, uint8_t branch_type);
   void adjust_threshold(bool correct);
+  void branch_predictor_save_state(champsim::checkpoint_writer& out) const;
+  void branch_predictor_load_state(champsim::checkpoint_reader& in);
 };
 
 #endif
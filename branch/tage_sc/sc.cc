@@ -2,12 +2,20 @@
 
 #ifdef ENABLE_SC
 
+// helper: point each GEHL table at its row of the backing store
+static void bind_gehl(int8_t** ptrs, int8_t* store, int nbr, int log_entries)
+{
+    int entries = 1 << log_entries;
+    for (int i = 0; i < nbr; i++)
+        ptrs[i] = store + i * entries;
+}
+
 // helper: initialize GEHL table arrays with alternating -1/0 pattern
 static void init_gehl(int8_t** ptrs, int8_t* store, int nbr, int log_entries)
 {
     int entries = 1 << log_entries;
+    bind_gehl(ptrs, store, nbr, log_entries);
     for (int i = 0; i < nbr; i++) {
-        ptrs[i] = store + i * entries;
         for (int j = 0; j < entries; j++)
             if (!(j & 1)) ptrs[i][j] = -1;
     }
@@ -50,6 +58,27 @@ StatisticalCorrector::StatisticalCorrector()
 #endif
 }
 
+void StatisticalCorrector::rebind_tables()
+{
+#ifdef ENABLE_SC_GEHL
+    bind_gehl(ggehl, &ggehl_store[0][0], GNB, LOGGNB);
+    bind_gehl(agehl, &agehl_store[0][0], ANB, LOGANB);
+    bind_gehl(bgehl, &bgehl_store[0][0], BNB, LOGBNB);
+    bind_gehl(fgehl, &fgehl_store[0][0], FNB, LOGFNB);
+    bind_gehl(pgehl, &pgehl_store[0][0], PNB, LOGPNB);
+#endif
+#ifdef ENABLE_SC_LOCAL
+    bind_gehl(lgehl, &lgehl_store[0][0], LNB, LOGLNB);
+#endif
+#ifdef ENABLE_SC_LOCALS
+    bind_gehl(sgehl, &sgehl_store[0][0], SNB, LOGSNB);
+#endif
+#ifdef ENABLE_SC_LOCALT
+    bind_gehl(tgehl, &tgehl_store[0][0], TNB, LOGTNB);
+    bind_gehl(qgehl, &qgehl_store[0][0], QNB, LOGQNB);
+#endif
+}
+
 int StatisticalCorrector::gehl_predict(uint64_t pc, uint64_t hist, const int* lengths, int8_t** tab, int nbr, int logs) const
 {
     int sum = 0;
@@ -91,6 +91,8 @@ public:
                  const history_state& hs, prediction_entry& pe);
     void update(const prediction_entry& pe, bool resolve_dir);
     int compute_storage() const;
+    // Point the GEHL tables back into this object's own storage, e.g. after its bytes were restored from a checkpoint
+    void rebind_tables();
 
 private:
     int gehl_predict(uint64_t pc, uint64_t hist, const int* lengths,
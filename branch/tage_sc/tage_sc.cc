@@ -66,4 +66,29 @@ void tage_sc::last_branch_result(champsim::address ip,champsim::address branch_t
 
     // update history for al branch types
     tage.update_history(ip.to<uint64_t>(), taken, target, branch_type, hist, ghist);
-}
\ No newline at end of file
+}
+
+// Predictions in flight are not saved, like the rest of the pipeline
+void tage_sc::branch_predictor_save_state(champsim::checkpoint_writer& out) const
+{
+    out.write(tage);
+#ifdef ENABLE_SC
+    out.write(sc);
+#endif
+    out.write(hist);
+    out.write(ghist);
+    out.write(initialized);
+}
+
+void tage_sc::branch_predictor_load_state(champsim::checkpoint_reader& in)
+{
+    in.read(tage);
+#ifdef ENABLE_SC
+    in.read(sc);
+    sc.rebind_tables();
+#endif
+    in.read(hist);
+    in.read(ghist);
+    in.read(initialized);
+    pred_buffer.clear();
+}
@@ -1,6 +1,7 @@
 #ifndef TAGE_SC_H
 #define TAGE_SC_H
 
+#include "checkpoint.h"
 #include "modules.h"
 #include "tage_helper.h"
 #include "tage_defines.h"
@@ -32,6 +33,8 @@ struct tage_sc : champsim::modules::branch_predictor {
     bool predict_branch(champsim::address ip);
     void last_branch_result(champsim::address ip, champsim::address branch_target,
                             bool taken, uint8_t branch_type);
+    void branch_predictor_save_state(champsim::checkpoint_writer& out) const;
+    void branch_predictor_load_state(champsim::checkpoint_reader& in);
 
     void print_storage_budget() const
     {
@@ -8,6 +8,8 @@
 
 #include "basic_btb.h"
 
+#include <vector>
+
 #include "instruction.h"
 
 std::pair<champsim::address, bool> basic_btb::btb_prediction(champsim::address ip)
@@ -46,3 +48,58 @@ void basic_btb::update_btb(champsim::address ip, champsim::address branch_target
 
   direct.update(ip, branch_target, branch_type);
 }
+
+namespace
+{
+// Addresses are written as their values, so that the padding of the slices that hold them never reaches the checkpoint
+void write_address(champsim::checkpoint_writer& out, champsim::address addr) { out.write(addr.to<uint64_t>()); }
+
+champsim::address read_address(champsim::checkpoint_reader& in)
+{
+  uint64_t value{};
+  in.read(value);
+  return champsim::address{value};
+}
+} // namespace
+
+void basic_btb::btb_save_state(champsim::checkpoint_writer& out) const
+{
+  direct.BTB.save_state(out, [](auto& writer, const direct_predictor::btb_entry_t& entry) {
+    write_address(writer, entry.ip_tag);
+    write_address(writer, entry.target);
+    writer.write(entry.type);
+  });
+  for (auto target : indirect.predictor) {
+    write_address(out, target);
+  }
+  out.write(indirect.conditional_history.to_ullong());
+  out.write(std::size(ras.stack));
+  for (auto target : ras.stack) {
+    write_address(out, target);
+  }
+  out.write(ras.call_size_trackers);
+}
+
+void basic_btb::btb_load_state(champsim::checkpoint_reader& in)
+{
+  direct.BTB.load_state(in, [](auto& reader, direct_predictor::btb_entry_t& entry) {
+    entry.ip_tag = read_address(reader);
+    entry.target = read_address(reader);
+    reader.read(entry.type);
+  });
+  for (auto& target : indirect.predictor) {
+    target = read_address(in);
+  }
+
+  unsigned long long history{};
+  in.read(history);
+  indirect.conditional_history = decltype(indirect.conditional_history){history};
+
+  std::size_t saved_stack{};
+  in.read(saved_stack);
+  ras.stack.clear();
+  for (std::size_t i = 0; i < saved_stack; ++i) {
+    ras.stack.push_back(read_address(in));
+  }
+  in.read(ras.call_size_trackers);
+}
@@ -21,6 +21,9 @@ struct return_stack {
    */
   std::array<typename champsim::address::difference_type, num_call_size_trackers> call_size_trackers;
 
+  // Warnings about returns to lower addresses are limited per return stack, so that cores simulated in parallel do not share a counter
+  int num_times_returned_backwards = 0;
+
   return_stack() { std::fill(std::begin(call_size_trackers), std::end(call_size_trackers), 4); }
 
   std::pair<champsim::address, bool> prediction();
@@ -93,10 +93,10 @@ if __name__ == '__main__':
         'compile_all_modules': args.compile_all_modules,
         'verbose': args.verbose
     }
-    parsed_configs = (config.parse.parse_config(*c, **parse_args) for c in config_files)
+    parsed_configs = ((config.parse.parse_config(*c, **parse_args), config.parse.parse_variants(*c, **parse_args)) for c in config_files)
 
     with config.filewrite.FileWriter(bindir_name=bindir_name, objdir_name=objdir_name, makedir_name=args.makedir, verbose=args.verbose) as wr:
-        for c in parsed_configs:
-            wr.write_files(c)
+        for c, variants in parsed_configs:
+            wr.write_files(c, variants=variants)
 
 # vim: set filetype=python:
@@ -21,8 +21,11 @@ import json
 import pathlib
 
 from .makefile import get_makefile_lines
+from .makefile import get_variant_makefile_lines
 from .instantiation_file import get_instantiation_lines
 from .instantiation_file import get_instantiation_header
+from .instantiation_file import get_variants_header
+from .instantiation_file import get_variants_lines
 from . import util
 
 warning_text = (
@@ -120,11 +123,34 @@ class Fragment:
         return Fragment(fileparts)
 
     @staticmethod
-    def from_config(parsed_config, bindir_name=None, srcdir_names=None, objdir_name=None, makedir_name=None, verbose=False):
+    def __build_id(parsed_config):
+        return hashlib.shake_128(json.dumps(parsed_config, sort_keys=True, default=try_int).encode('utf-8')).hexdigest(8)
+
+    @staticmethod
+    def __module_info(parsed_config, verbose=False):
+        _, _, modules_to_compile, module_info, _ = parsed_config
+        joined_module_info = util.subdict(util.chain(*module_info.values()), modules_to_compile) # remove module type tag
+
+        if verbose:
+            print('Modules:')
+            for module in joined_module_info.values():
+                print(f'  {module["name"]}: {module["path"]} -> {module["class"]}')
+
+        # Touch 'path/to/__legacy__' to ensure makefile will generate legacy files
+        for legacy_marker in (pathlib.Path(module['path'], '__legacy__') for module in joined_module_info.values() if module.get('legacy')):
+            if verbose:
+                print('Touching file:', str(legacy_marker))
+            legacy_marker.touch()
+
+        return joined_module_info
+
+    @staticmethod
+    def from_config(parsed_config, bindir_name=None, srcdir_names=None, objdir_name=None, makedir_name=None, verbose=False, variants=None):
         '''
         Produce a sequence of Fragments from the result of parse.parse_config().
 
         :param parsed_config: the result of parsing a configuration file
+        :param variants: pairs of the names and results of parse.parse_variants() for the variants to build into the executable
         :param bindir_name: the directory in which to place the binaries
         :param srcdir_name: the directory to search for source files
         :param objdir_name: the directory to place object files
@@ -143,25 +169,18 @@ class Fragment:
             print('Object directory:', objdir_name)
             print('Makefile directory:', makedir_name)
 
-        build_id = hashlib.shake_128(json.dumps(parsed_config, sort_keys=True, default=try_int).encode('utf-8')).hexdigest(8)
+        variants = variants or []
+        build_id = Fragment.__build_id(parsed_config)
 
-        executable_basename, elements, modules_to_compile, module_info, config_file = parsed_config
+        executable_basename, elements, _, _, config_file = parsed_config
 
-        joined_module_info = util.subdict(util.chain(*module_info.values()), modules_to_compile) # remove module type tag
         executable = os.path.join(bindir_name, executable_basename)
         if verbose:
             print('For Executable', executable)
-            print('Modules:')
-            for module in joined_module_info.values():
-                print(f'  {module["name"]}: {module["path"]} -> {module["class"]}')
+        joined_module_info = Fragment.__module_info(parsed_config, verbose=verbose)
+        if verbose:
             print('Writing objects to', objdir_name)
 
-        # Touch 'path/to/__legacy__' to ensure makefile will generate legacy files
-        for legacy_marker in (pathlib.Path(module['path'], '__legacy__') for module in joined_module_info.values() if module.get('legacy')):
-            if verbose:
-                print('Touching file:', str(legacy_marker))
-            legacy_marker.touch()
-
         fileparts = [
             # Instantiation file
             (os.path.join(objdir_name, 'core_inst.inc'), cxx_file(get_instantiation_header(len(elements['cores']), config_file, build_id=build_id))),
@@ -173,6 +192,36 @@ class Fragment:
                 *get_makefile_lines(build_id, executable, joined_module_info)
             ))
         ]
+
+        # Each variant is another environment in the same executable
+        variant_ids = []
+        for name, parsed_variant in variants:
+            variant_id = Fragment.__build_id(parsed_variant)
+            is_duplicate = variant_id == build_id or variant_id in variant_ids
+            variant_ids.append(variant_id)
+            if is_duplicate:
+                continue # the same environment is already instantiated
+            _, variant_elements, _, _, variant_config_file = parsed_variant
+
+            if verbose:
+                print('For Variant', name)
+            variant_module_info = Fragment.__module_info(parsed_variant, verbose=verbose)
+
+            fileparts.extend((
+                (os.path.join(objdir_name, 'core_inst.inc'), cxx_file(get_instantiation_header(len(variant_elements['cores']), variant_config_file, build_id=variant_id))),
+                (os.path.join(objdir_name, 'core_inst.cc.inc'), cxx_file(get_instantiation_lines(build_id=variant_id, **variant_elements))),
+                (os.path.join(makedir_name, '_configuration.mk'), (
+                    *make_generated_warning(),
+                    *get_variant_makefile_lines(variant_id, name, variant_module_info)
+                ))
+            ))
+
+        if variants:
+            fileparts.extend((
+                (os.path.join(objdir_name, 'core_inst.inc'), cxx_file(get_variants_header(build_id, [name for name,_ in variants]))),
+                (os.path.join(objdir_name, 'core_inst.cc.inc'), cxx_file(get_variants_lines(build_id, variant_ids)))
+            ))
+
         return Fragment(list(util.collect(fileparts, operator.itemgetter(0), Fragment.__part_joiner))) # hoist the parts
 
     def write(self, verbose=False):
@@ -207,12 +256,13 @@ class FileWriter:
         self.fragments = []
         return self
 
-    def write_files(self, parsed_config, bindir_name=None, srcdir_names=None, objdir_name=None, makedir_name=None):
+    def write_files(self, parsed_config, bindir_name=None, srcdir_names=None, objdir_name=None, makedir_name=None, variants=None):
         '''
         Accumulate the results of parsing a configuration into the File Writer.
         Parameters passed here will override parameters given in the constructor
 
         :param parsed_config: the result of parsing a configuration file
+        :param variants: the result of parse.parse_variants() for the configuration
         :param bindir_name: the directory in which to place the binaries
         :param srcdir_name: the directory to search for source files
         :param objdir_name: the directory to place object files
@@ -223,7 +273,8 @@ class FileWriter:
             srcdir_names=srcdir_names or [],
             objdir_name=os.path.abspath(objdir_name or self.objdir_name),
             makedir_name=makedir_name or self.makedir_name,
-            verbose=self.verbose
+            verbose=self.verbose,
+            variants=variants
         ))
 
     @staticmethod
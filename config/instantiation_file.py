@@ -22,7 +22,7 @@ import multiprocessing as mp
 from . import util
 from . import cxx
 
-pmem_fmtstr = 'champsim::chrono::picoseconds{{{clock_period_dbus}}}, champsim::chrono::picoseconds{{{clock_period_mc}}}, std::size_t{{{_tRP}}}, std::size_t{{{_tRCD}}}, std::size_t{{{_tCAS}}}, std::size_t{{{_tRAS}}}, champsim::chrono::microseconds{{{_refresh_period}}}, {{{_ulptr}}}, {rq_size}, {wq_size}, {channels}, champsim::data::bytes{{{channel_width}}}, {_bank_rows}, {_bank_columns}, {ranks}, {bankgroups}, {banks}, {_refreshes_per_period}'
+pmem_fmtstr = 'champsim::chrono::picoseconds{{{clock_period_dbus}}}, champsim::chrono::picoseconds{{{clock_period_mc}}}, std::size_t{{{_tRP}}}, std::size_t{{{_tRCD}}}, std::size_t{{{_tCAS}}}, std::size_t{{{_tRAS}}}, champsim::chrono::microseconds{{{_refresh_period}}}, {{{_ulptr}}}, {rq_size}, {wq_size}, {channels}, champsim::data::bytes{{{channel_width}}}, {_bank_rows}, {_bank_columns}, {ranks}, {bankgroups}, {banks}, {_refreshes_per_period}, {_scheduling}, {_model}'
 vmem_fmtstr = 'champsim::data::bytes{{{pte_page_size}}}, {num_levels}, champsim::chrono::picoseconds{{{clock_period}*{minor_fault_penalty}}}, {dram_name}, {_randomization}'
 
 queue_fmtstr = '{rq_size}, {pq_size}, {wq_size}, champsim::data::bits{{{_offset_bits}}}, {_queue_check_full_addr:b}'
@@ -53,8 +53,8 @@ core_builder_parts = {
     'dib_window': '  .dib_window({dib_window})',
     'L1I': ['.l1i(&{^l1i_ptr})', '.l1i_bandwidth({^l1i_ptr}.MAX_TAG)', '.fetch_queues(&{^fetch_queues})'],
     'L1D': ['.l1d_bandwidth({^l1d_ptr}.MAX_TAG)', '.data_queues(&{^data_queues})'],
-    '_branch_predictor_data': '.branch_predictor<{^branch_predictor_string}>()',
-    '_btb_data': '.btb<{^btb_string}>()',
+    '_branch_predictor_data': '.branch_predictor<{^branch_predictor_string}>({{{^branch_predictor_names}}})',
+    '_btb_data': '.btb<{^btb_string}>({{{^btb_names}}})',
     '_index': '.index({_index})',
     'frequency': '.clock_period(champsim::chrono::picoseconds{{{^clock_period}}})'
 }
@@ -73,6 +73,7 @@ cache_builder_parts = {
     'ways': '.ways({ways})',
     'log2_ways': '.log2_ways({log2_ways})',
     'pq_size': '.pq_size({pq_size})',
+    'prefetch_filter_size': '.prefetch_filter_size({prefetch_filter_size})',
     'mshr_size': '.mshr_size({mshr_size})',
     'latency': '.latency({latency})',
     'hit_latency': '.hit_latency({hit_latency})',
@@ -81,8 +82,8 @@ cache_builder_parts = {
     'max_fill': '.fill_bandwidth(champsim::bandwidth::maximum_type{{{max_fill}}})',
     '_offset_bits': '.offset_bits(champsim::data::bits{{{_offset_bits}}})',
     'prefetch_activate': '.prefetch_activate({^prefetch_activate_string})',
-    '_replacement_data': '.replacement<{^replacement_string}>()',
-    '_prefetcher_data': '.prefetcher<{^prefetcher_string}>()',
+    '_replacement_data': '.replacement<{^replacement_string}>({{{^replacement_names}}})',
+    '_prefetcher_data': '.prefetcher<{^prefetcher_string}>({{{^prefetcher_names}}})',
     'lower_translate': '.lower_translate(&{^lower_translate_queues})',
     'lower_level': '.lower_level(&{^lower_level_queues})',
     'frequency': '.clock_period(champsim::chrono::picoseconds{{{^clock_period}}})'
@@ -118,6 +119,8 @@ def get_cpu_builder(cpu, caches, ul_pairs):
     local_params = {
         '^branch_predictor_string': ', '.join(f'class {k["class"]}' for k in cpu.get('_branch_predictor_data',[])),
         '^btb_string': ', '.join(f'class {k["class"]}' for k in cpu.get('_btb_data',[])),
+        '^branch_predictor_names': ', '.join(f'"{k["name"]}"' for k in cpu.get('_branch_predictor_data',[])),
+        '^btb_names': ', '.join(f'"{k["name"]}"' for k in cpu.get('_btb_data',[])),
         '^fetch_queues': f'channels.at({ul_pairs.index((cpu.get("L1I"), cpu.get("name")))})',
         '^data_queues': f'channels.at({ul_pairs.index((cpu.get("L1D"), cpu.get("name")))})',
         '^l1i_ptr': f'(*std::next(std::begin(caches), {cache_index(cpu.get("L1I"))}))',
@@ -134,6 +137,45 @@ def get_cpu_builder(cpu, caches, ul_pairs):
     ), indent=1, line_end=''))
     yield from (part.format(**cpu, **local_params) for part in builder_parts)
 
+dram_schedulers = {
+    'fcfs': 'champsim::dram_scheduler::fcfs',
+    'frfcfs': 'champsim::dram_scheduler::frfcfs'
+}
+
+dram_page_policies = {
+    'open': 'champsim::dram_page_policy::open',
+    'closed': 'champsim::dram_page_policy::closed'
+}
+
+def get_dram_scheduling(pmem):
+    '''
+    Generate a champsim::dram_scheduling_policy
+    '''
+    scheduler = pmem.get('scheduler', 'fcfs')
+    page_policy = pmem.get('page_policy', 'open')
+    row_hit_cap = int(pmem.get('row_hit_cap', 0))
+    if scheduler not in dram_schedulers:
+        raise ValueError(f'DRAM scheduler must be one of {", ".join(dram_schedulers)}')
+    if page_policy not in dram_page_policies:
+        raise ValueError(f'DRAM page policy must be one of {", ".join(dram_page_policies)}')
+    if row_hit_cap < 0:
+        raise ValueError('DRAM row hit cap must not be negative')
+    return f'champsim::dram_scheduling_policy{{{dram_schedulers[scheduler]}, {dram_page_policies[page_policy]}, {row_hit_cap}}}'
+
+dram_models = {
+    'detailed': 'champsim::dram_model::detailed',
+    'analytical': 'champsim::dram_model::analytical'
+}
+
+def get_dram_model(pmem):
+    '''
+    Generate a champsim::dram_model
+    '''
+    model = pmem.get('model', 'detailed')
+    if model not in dram_models:
+        raise ValueError(f'DRAM model must be one of {", ".join(dram_models)}')
+    return dram_models[model]
+
 def get_cache_builder(elem, ul_pairs):
     '''
     Generate a champsim::cache_builder
@@ -159,6 +201,8 @@ def get_cache_builder(elem, ul_pairs):
         '^prefetch_activate_string': ', '.join('access_type::'+t for t in elem.get('prefetch_activate',[])),
         '^replacement_string': ', '.join(f'class {k["class"]}' for k in elem.get('_replacement_data',[])),
         '^prefetcher_string': ', '.join(f'class {k["class"]}' for k in elem.get('_prefetcher_data',[])),
+        '^replacement_names': ', '.join(f'"{k["name"]}"' for k in elem.get('_replacement_data',[])),
+        '^prefetcher_names': ', '.join(f'"{k["name"]}"' for k in elem.get('_prefetcher_data',[])),
         '^lower_level_queues': f'channels.at({ul_pairs.index((elem.get("lower_level"), elem.get("name")))})'
     }
     if 'frequency' in elem:
@@ -312,6 +356,37 @@ def decorate_queues(caches, ptws, pmem):
 def get_queue_info(ul_pairs, decoration):
     return [decoration.get(ll) for ll,_ in ul_pairs]
 
+def get_operable_domains(cores, caches, ptws, ul_pairs):
+    '''
+    Get the scheduling domain of each operable, in the order of the environment's operable view.
+
+    Each core and the caches used only by that core share a domain. All other elements, including the page table walkers
+    (which share the virtual memory), are in the shared domain, represented by None.
+    '''
+    core_index = {c['name']: c['_index'] for c in cores}
+
+    def owners(name):
+        # Translation paths form cycles (L1D -> PTW -> STLB -> DTLB -> L1D), so track the visited elements
+        visited, frontier = set(), [name]
+        while frontier:
+            elem = frontier.pop()
+            if elem not in visited:
+                visited.add(elem)
+                frontier.extend(upper for lower,upper in ul_pairs if lower == elem)
+        return set(core_index[v] for v in visited if v in core_index)
+
+    def private_owner(name):
+        owner_set = owners(name)
+        return next(iter(owner_set)) if len(owner_set) == 1 else None
+
+    # The environment builds each group of elements by emplacing at the front, so the view holds them in reverse order
+    return list(itertools.chain(
+        (c['_index'] for c in reversed(cores)),
+        (private_owner(c['name']) for c in reversed(caches)),
+        (None for _ in ptws),
+        (None,)
+    ))
+
 def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
     '''
     Generate the lines for a C++ file that instantiates a configuration.
@@ -347,6 +422,8 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
             _bank_columns=int(pmem['columns']*8 if 'columns' in pmem else pmem['bank_columns']),
             _refresh_period=int(1000*pmem['refresh_period']),
             _refreshes_per_period=int(pmem['refreshes_per_period']),
+            _scheduling=get_dram_scheduling(pmem),
+            _model=get_dram_model(pmem),
             _ulptr=vector_string(f'&channels.at({ul_pairs.index(v)})' for v in ul_pairs if v[0] == pmem['name']),
             **pmem),
         '},'
@@ -378,7 +455,12 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
         'cores {',
         *get_builder_function_call('O3_CPU',
                                    map(functools.partial(get_cpu_builder, caches=caches, ul_pairs=ul_pairs), cores)),
-        '}'
+        '},'
+    )
+
+    domain_strings = ('champsim::scheduler::shared_domain' if d is None else str(d) for d in get_operable_domains(cores, caches, ptws, ul_pairs))
+    scheduler_instantiation_body = (
+        f'schedule{{operable_view(), {{{", ".join(domain_strings)}}}}}',
     )
 
     yield f'champsim::configured::generated_environment<0x{build_id}>::generated_environment() :'
@@ -390,6 +472,7 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
     yield from ptw_instantiation_body
     yield from cache_instantiation_body
     yield from core_instantiation_body
+    yield from scheduler_instantiation_body
     yield '{'
     yield '}'
     yield ''
@@ -417,6 +500,9 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
     yield from cxx.function(f'{classname}::dram_view', [f'return {pmem["name"]};'], rtype='MEMORY_CONTROLLER&')
     yield ''
 
+    yield from cxx.function(f'{classname}::scheduler_view', ['return schedule;'], rtype='champsim::scheduler&')
+    yield ''
+
 def get_instantiation_header(num_cpus, env, build_id):
     yield '#include "environment.h"'
     yield '#include "vmem.h"'
@@ -430,6 +516,7 @@ def get_instantiation_header(num_cpus, env, build_id):
         'std::forward_list<PageTableWalker> ptws;',
         'std::forward_list<CACHE> caches;',
         'std::forward_list<O3_CPU> cores;',
+        'champsim::scheduler schedule;',
 
         'public:',
         f'constexpr static std::size_t num_cpus = {num_cpus};',
@@ -441,7 +528,36 @@ def get_instantiation_header(num_cpus, env, build_id):
         'std::vector<std::reference_wrapper<CACHE>> cache_view() final;',
         'std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() final;',
         'MEMORY_CONTROLLER& dram_view() final;',
-        'std::vector<std::reference_wrapper<operable>> operable_view() final;'
+        'std::vector<std::reference_wrapper<operable>> operable_view() final;',
+        'champsim::scheduler& scheduler_view() final;'
     )
     struct_name = f'champsim::configured::generated_environment<0x{build_id}> final'
     yield from cxx.struct(struct_name, struct_body, superclass='champsim::environment')
+
+def get_variants_header(build_id, variant_names):
+    '''
+    Declare the table of variants built alongside the given configuration.
+
+    :param build_id: The build ID of the configuration
+    :param variant_names: The names of the variants, in order
+    '''
+    names = ', '.join(f'"{n}"' for n in variant_names)
+    struct_body = (
+        f'constexpr static std::array<std::string_view, {len(variant_names)}> names{{{{{names}}}}};',
+        'static std::unique_ptr<champsim::environment> make(std::size_t index);'
+    )
+    yield 'template <>'
+    yield from cxx.struct(f'champsim::configured::variants<0x{build_id}>', struct_body)
+
+def get_variants_lines(build_id, variant_ids):
+    '''
+    Define the function that constructs each of the variants built alongside the given configuration.
+
+    :param build_id: The build ID of the configuration
+    :param variant_ids: The build IDs of the variants, in order
+    '''
+    cases = (f'case {i}: return std::make_unique<champsim::configured::generated_environment<0x{v}>>();' for i,v in enumerate(variant_ids))
+    body = ('switch (index) {', *cases, '}', 'return nullptr;')
+    yield from cxx.function(f'champsim::configured::variants<0x{build_id}>::make', body, args=(('std::size_t', 'index'),),
+                            rtype='std::unique_ptr<champsim::environment>')
+    yield ''
@@ -76,7 +76,13 @@ def get_makefile_lines(build_id, executable, module_info):
     exe_basename = os.path.join('$(BIN_ROOT)', exe_basename)
     yield from hard_assign_variable('BIN_ROOT', exe_dirname)
     yield from hard_assign_variable('build_id', build_id, targets=[exe_basename])
+    yield from get_module_lines(module_info)
+    yield from append_variable('executable_name', exe_basename)
+
+    yield ''
 
+def get_module_lines(module_info):
+    ''' Generate the lines that compile the given modules into every executable '''
     mod_paths = [relroot(mod["path"]) for mod in module_info.values()]
     yield from append_variable('nonbase_module_objs', '$(filter-out $(base_module_objs),$(call get_module_list,', *mod_paths, '))')
 
@@ -84,6 +90,13 @@ def get_makefile_lines(build_id, executable, module_info):
     if legacy_paths:
         yield from append_variable('prereq_for_generated', *legacy_paths, targets=['$(generated_files)'])
 
-    yield from append_variable('executable_name', exe_basename)
-
+def get_variant_makefile_lines(build_id, name, module_info):
+    ''' Generate the lines to be written for a variant, which is built into its configuration's executable '''
+    yield from header({
+        'Build ID': build_id,
+        'Variant': name,
+        'Module Names': tuple(module_info.keys())
+    })
+    yield ''
+    yield from get_module_lines(module_info)
     yield ''
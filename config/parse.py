@@ -331,7 +331,8 @@ class NormalizedConfiguration:
         pmem = util.chain(self.pmem, {
             'name': 'DRAM', 'data_rate': 3200, 'frequency': 1600, 'channels': 1, 'ranks': 1, 'bankgroups': 8, 'banks': 4, 'bank_rows': 65536, 'bank_columns': 1024,
             'channel_width': 8, 'wq_size': 64, 'rq_size': 64, 'tRP': 24, 'tRCD': 24, 'tCAS': 24, 'tRAS' : 52,
-            'refresh_period': 32, 'refreshes_per_period': 8192
+            'refresh_period': 32, 'refreshes_per_period': 8192, 'scheduler': 'fcfs', 'page_policy': 'open', 'row_hit_cap': 0,
+            'model': 'detailed'
         })
         pmem = util.chain(pmem,(do_deprecation(pmem, pmem_deprecation_keys,pmem_deprecation_warnings)))
         
@@ -497,3 +498,31 @@ def parse_config(*configs, module_dir=None, branch_dir=None, btb_dir=None, pref_
         ))]
 
     return executable_name(*configs), elements, modules_to_compile, module_info, config_file
+
+def parse_variants(*configs, **kwargs):
+    '''
+    Parse the variants listed in the given configurations. Each variant is an object with a name and any keys of a configuration,
+    which take priority over the configurations it is listed in. All of the variants are built into the configuration's executable,
+    which can simulate each of them from a single reading of the traces.
+
+    :param configs: The configurations, as given to :func:`parse_config`
+    :param kwargs: Passed through to :func:`parse_config`
+    :returns: A list of pairs of each variant's name and the result of parsing it
+    '''
+    variants = list(itertools.chain(*(c.get('variants', []) for c in configs)))
+
+    names = [v.get('name') for v in variants]
+    if any(n is None for n in names):
+        raise ValueError('Each variant must have a name')
+    if len(set(names)) != len(names) or 'base' in names:
+        raise ValueError('Variant names must be unique and must not be "base"')
+
+    shared_keys = ('num_cores', 'block_size', 'page_size')
+    for v in variants:
+        if any(k in v for k in shared_keys):
+            raise ValueError(f'Variant {v["name"]} may not change any of {", ".join(shared_keys)}')
+
+    def overrides(variant):
+        return {k:v for k,v in variant.items() if k not in ('name', 'executable_name')}
+
+    return [(v['name'], parse_config(overrides(v), *configs, **kwargs)) for v in variants]
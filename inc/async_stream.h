@@ -0,0 +1,195 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ASYNC_STREAM_H
+#define ASYNC_STREAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <ios>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * An input stream that reads its underlying stream on a background thread.
+ *
+ * The producer thread fills a ring of fixed-size blocks ahead of the reader, so that expensive work in the underlying stream
+ * (such as decompression) overlaps with the simulation. The ring is a single-producer, single-consumer queue and takes no locks.
+ *
+ * Only read(), gcount(), and eof() are provided, which is all that bulk_tracereader requires.
+ */
+template <typename StreamType>
+class async_istream
+{
+  struct block {
+    std::vector<char> data;
+    std::size_t size = 0;
+    bool last = false;
+  };
+
+  struct shared_state {
+    StreamType underlying;
+    std::vector<block> ring;
+
+    // Both indices increase monotonically. The producer owns tail and the consumer owns head.
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::atomic<bool> stopping{false};
+
+    shared_state(StreamType&& strm, std::size_t block_size, std::size_t depth) : underlying(std::move(strm)), ring(depth, block{std::vector<char>(block_size)}) {}
+  };
+
+  std::unique_ptr<shared_state> state;
+  std::thread producer;
+
+  std::size_t block_offset = 0;
+  std::streamsize gcount_ = 0;
+  bool eof_ = false;
+
+  template <typename Pred>
+  static void wait_until(Pred pred);
+
+  static void produce(shared_state& st);
+  void stop();
+
+public:
+  /**
+   * Begin reading the given stream in blocks of the given number of bytes, keeping up to depth blocks ahead of the reader.
+   */
+  async_istream(StreamType&& strm, std::size_t block_size, std::size_t depth);
+  async_istream(std::string s, std::size_t block_size, std::size_t depth) : async_istream(StreamType{s}, block_size, depth) {}
+  ~async_istream() { stop(); }
+
+  async_istream(async_istream&&) noexcept = default;
+  async_istream& operator=(async_istream&& other) noexcept
+  {
+    stop();
+    state = std::move(other.state);
+    producer = std::move(other.producer);
+    block_offset = other.block_offset;
+    gcount_ = other.gcount_;
+    eof_ = other.eof_;
+    return *this;
+  }
+
+  async_istream& read(char* s, std::streamsize count);
+
+  [[nodiscard]] bool eof() const { return eof_; }
+  [[nodiscard]] std::streamsize gcount() const { return gcount_; }
+};
+
+template <typename S>
+async_istream<S>::async_istream(S&& strm, std::size_t block_size, std::size_t depth)
+    : state(std::make_unique<shared_state>(std::move(strm), block_size, depth))
+{
+  assert(block_size > 0);
+  assert(depth > 0);
+  producer = std::thread{produce, std::ref(*state)};
+}
+
+template <typename S>
+template <typename Pred>
+void async_istream<S>::wait_until(Pred pred)
+{
+  // Spin briefly, since the other side is usually close behind, then back off so that a stalled thread does not compete for a core
+  constexpr int spin_limit = 64;
+  for (int spins = 0; !pred(); ++spins) {
+    if (spins < spin_limit) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds{50});
+    }
+  }
+}
+
+template <typename S>
+void async_istream<S>::produce(shared_state& st)
+{
+  const auto depth = std::size(st.ring);
+  for (bool last = false; !last;) {
+    auto tail = st.tail.load(std::memory_order_relaxed);
+    wait_until([&] { return st.stopping.load(std::memory_order_relaxed) || tail - st.head.load(std::memory_order_acquire) < depth; });
+    if (st.stopping.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    auto& blk = st.ring[tail % depth];
+    st.underlying.read(std::data(blk.data), static_cast<std::streamsize>(std::size(blk.data)));
+    blk.size = static_cast<std::size_t>(st.underlying.gcount());
+
+    // A short read marks the end of the stream, whether or not the stream set its eof bit
+    last = blk.size < std::size(blk.data);
+    blk.last = last;
+
+    st.tail.store(tail + 1, std::memory_order_release);
+  }
+}
+
+template <typename S>
+void async_istream<S>::stop()
+{
+  if (state != nullptr) {
+    state->stopping.store(true, std::memory_order_relaxed);
+  }
+  if (producer.joinable()) {
+    producer.join();
+  }
+}
+
+template <typename S>
+auto async_istream<S>::read(char* s, std::streamsize count) -> async_istream&
+{
+  assert(count >= 0);
+  const auto depth = std::size(state->ring);
+  auto remaining = static_cast<std::size_t>(count);
+  gcount_ = 0;
+
+  while (remaining > 0 && !eof_) {
+    auto head = state->head.load(std::memory_order_relaxed);
+    wait_until([&] { return state->tail.load(std::memory_order_acquire) != head; });
+
+    const auto& blk = state->ring[head % depth];
+    auto to_copy = std::min(remaining, blk.size - block_offset);
+    std::memcpy(s, std::next(std::data(blk.data), static_cast<std::ptrdiff_t>(block_offset)), to_copy);
+    s = std::next(s, static_cast<std::ptrdiff_t>(to_copy));
+    block_offset += to_copy;
+    remaining -= to_copy;
+    gcount_ += static_cast<std::streamsize>(to_copy);
+
+    if (block_offset == blk.size) {
+      // The final block is never released, so that later reads continue to see the end of the stream
+      if (blk.last) {
+        eof_ = true;
+      } else {
+        block_offset = 0;
+        state->head.store(head + 1, std::memory_order_release);
+      }
+    }
+  }
+
+  return *this;
+}
+} // namespace champsim
+
+#endif
@@ -29,6 +29,7 @@
 #include <iterator> // for size
 #include <limits>   // for numeric_limits
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -41,13 +42,23 @@
 #include "cache_stats.h"
 #include "champsim.h"
 #include "channel.h"
+#include "checkpoint.h"
 #include "chrono.h"
+#include "dependency_list.h"
 #include "modules.h"
 #include "operable.h"
+#include "prefetch_filter.h"
+#include "reuse_profiler.h"
+#include "util/block_indexed_deque.h"
 #include "util/to_underlying.h" // for to_underlying
 #include "waitable.h"
 #include "capability_memory.h"
 
+namespace champsim
+{
+class functional_warmer;
+}
+
 class CACHE : public champsim::operable
 {
   enum [[deprecated(
@@ -81,8 +92,8 @@ class CACHE : public champsim::operable
     bool is_instr = false;
     champsim::chrono::clock::time_point event_cycle = champsim::chrono::clock::time_point::max();
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::dependency_list instr_depend_on_me{};
+    std::vector<champsim::channel::response_queue*> to_return{};
 
     explicit tag_lookup_type(request_type req) : tag_lookup_type(req, false, false) {}
     tag_lookup_type(const request_type& req, bool local_pref, bool skip);
@@ -110,8 +121,8 @@ public:
     bool is_instr = false;
     champsim::chrono::clock::time_point time_enqueued;
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::dependency_list instr_depend_on_me{};
+    std::vector<champsim::channel::response_queue*> to_return{};
 
     mshr_type(const tag_lookup_type& req, champsim::chrono::clock::time_point _time_enqueued);
     static mshr_type merge(mshr_type predecessor, mshr_type successor);
@@ -124,9 +135,14 @@ private:
   bool handle_write(const tag_lookup_type& handle_pkt);
   void finish_packet(const response_type& packet);
   void finish_translation(const response_type& packet);
+  void record_reuse(const tag_lookup_type& handle_pkt);
 
+  [[nodiscard]] request_type translation_request(const tag_lookup_type& q_entry) const;
   void issue_translation(tag_lookup_type& q_entry) const;
 
+  void warm_translate(tag_lookup_type& q_entry, champsim::functional_warmer& warmer) const;
+  response_type warm_lookup(tag_lookup_type handle_pkt, champsim::functional_warmer& warmer);
+
 public:
   using BLOCK = champsim::cache_block;
 
@@ -137,6 +153,12 @@ private:
   std::pair<set_type::iterator, set_type::iterator> get_set_span(champsim::address address);
   [[nodiscard]] std::pair<set_type::const_iterator, set_type::const_iterator> get_set_span(champsim::address address) const;
   [[nodiscard]] long get_set_index(champsim::address address) const;
+
+  // Tag lookups search a dense array of block tags rather than the blocks themselves
+  constexpr static uint64_t invalid_tag = std::numeric_limits<uint64_t>::max();
+  [[nodiscard]] uint64_t get_tag(champsim::address address) const;
+  set_type::iterator find_valid_way(champsim::address address);
+  void update_tag(set_type::iterator way);
   
   template <typename T>
   bool should_activate_prefetcher(const T& pkt) const;
@@ -150,6 +172,13 @@ private:
   template <typename T>
   bool module_is_instr(const T& element) const;
 
+  // The block that the prefetch filter knows a packet by, which is virtual if the prefetcher works on virtual addresses
+  template <typename T>
+  uint64_t prefetch_filter_block(const T& element) const;
+
+  // Whether a prefetch would only repeat a block that is resident, in flight, or recently issued
+  bool drop_redundant_prefetch(champsim::address pf_addr);
+
   template <typename T>
   champsim::address module_vaddress(const T& element) const;
 
@@ -160,6 +189,9 @@ private:
   std::deque<tag_lookup_type> inflight_tag_check{};
   std::deque<tag_lookup_type> translation_stash{};
 
+  std::optional<champsim::reuse_profiler> reuse_profile{};
+  champsim::prefetch_filter pf_filter;
+
 public:
   std::vector<channel_type*> upper_levels;
   channel_type* lower_level;
@@ -173,6 +205,12 @@ public:
   champsim::chrono::clock::duration FILL_LATENCY;
   champsim::data::bits OFFSET_BITS;
   set_type block{static_cast<typename set_type::size_type>(NUM_SET * NUM_WAY)};
+
+private:
+  // The tag of each valid block, or invalid_tag, kept in step with the block array
+  std::vector<uint64_t> block_tags = std::vector<uint64_t>(std::size(block), invalid_tag);
+
+public:
   champsim::bandwidth::maximum_type MAX_TAG, MAX_FILL;
   bool prefetch_as_load;
   bool match_offset_bits;
@@ -183,18 +221,31 @@ public:
 
   stats_type sim_stats, roi_stats;
 
-  std::deque<mshr_type> MSHR;
-  std::deque<mshr_type> inflight_writes;
+  champsim::block_indexed_deque<mshr_type> MSHR{OFFSET_BITS};
+  champsim::block_indexed_deque<mshr_type> inflight_writes{OFFSET_BITS};
 
   champsim::capability auth_capability{};
   champsim::address v_addr{};
   champsim::address vaddr_evicted{};
 
   long operate() final;
+  [[nodiscard]] bool is_idle() const final;
+  void operate_idle(long cycles) final;
+  [[nodiscard]] champsim::chrono::clock::time_point next_wakeup() const final;
   void initialize() final;
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
 
+  // Handle the packet at once, along with any misses, writebacks, and prefetches it causes, and return its response
+  response_type warm_access(const request_type& pkt, champsim::functional_warmer& warmer);
+
+  // Measure the reuse distances of the accesses to this cache, sampling the given fraction of the blocks
+  void profile_reuse(double sample_rate);
+
+  // Save or restore the blocks and the module state. Packets in flight are not part of the state.
+  void save_state(champsim::checkpoint_writer& out) const;
+  void load_state(champsim::checkpoint_reader& in);
+
   [[deprecated]] std::size_t get_occupancy(uint8_t queue_type, champsim::address address) const;
   [[deprecated]] std::size_t get_size(uint8_t queue_type, champsim::address address) const;
 
@@ -250,8 +301,11 @@ public:
                                             long way, bool prefetch, champsim::address evicted_addr, champsim::capability evicted_cap, uint32_t metadata_in,
                                             uint32_t metadata_evict, uint32_t cpu_evict) = 0;
     virtual void impl_prefetcher_cycle_operate() = 0;
+    [[nodiscard]] virtual bool impl_prefetcher_has_cycle_operate() const = 0;
     virtual void impl_prefetcher_final_stats() = 0;
     virtual void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) = 0;
+    virtual void impl_prefetcher_save_state(champsim::checkpoint_writer& out) = 0;
+    virtual void impl_prefetcher_load_state(champsim::checkpoint_reader& in) = 0;
   };
 
   struct replacement_module_concept {
@@ -267,12 +321,19 @@ public:
     virtual void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                              champsim::address victim_addr, access_type type) = 0;
     virtual void impl_replacement_final_stats() = 0;
+    virtual void impl_replacement_save_state(champsim::checkpoint_writer& out) = 0;
+    virtual void impl_replacement_load_state(champsim::checkpoint_reader& in) = 0;
   };
 
   template <typename... Ps>
   struct prefetcher_module_model final : prefetcher_module_concept {
     std::tuple<Ps...> intern_;
-    explicit prefetcher_module_model(CACHE* cache) : intern_(Ps{cache}...) { (void)cache; /* silence -Wunused-but-set-parameter when sizeof...(Ps) == 0 */ }
+    std::vector<std::string> names_;
+    prefetcher_module_model(CACHE* cache, std::vector<std::string> names)
+        : intern_(Ps{cache}...), names_(champsim::modules::section_names(std::move(names), sizeof...(Ps)))
+    {
+      (void)cache; /* silence -Wunused-but-set-parameter when sizeof...(Ps) == 0 */
+    }
     void bind(CACHE* cache)
     {
       std::apply([cache = cache](auto&... p) { (..., p.bind(cache)); }, intern_);
@@ -285,8 +346,11 @@ public:
                                                       long set, long way, bool prefetch, champsim::address evicted_addr, champsim::capability evicted_cap,
                                                       uint32_t metadata_in, uint32_t metadata_evict, uint32_t cpu_evict) final;
     void impl_prefetcher_cycle_operate() final;
+    [[nodiscard]] bool impl_prefetcher_has_cycle_operate() const final;
     void impl_prefetcher_final_stats() final;
     void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) final;
+    void impl_prefetcher_save_state(champsim::checkpoint_writer& out) final;
+    void impl_prefetcher_load_state(champsim::checkpoint_reader& in) final;
   };
 
   template <typename... Rs>
@@ -295,7 +359,12 @@ public:
     // static_assert(std::disjunction<champsim::is_detected<has_update_state, Rs>...>::value, "At least one replacement policy must update its state");
 
     std::tuple<Rs...> intern_;
-    explicit replacement_module_model(CACHE* cache) : intern_(Rs{cache}...) { (void)cache; /* silence -Wunused-but-set-parameter when sizeof...(Rs) == 0 */ }
+    std::vector<std::string> names_;
+    replacement_module_model(CACHE* cache, std::vector<std::string> names)
+        : intern_(Rs{cache}...), names_(champsim::modules::section_names(std::move(names), sizeof...(Rs)))
+    {
+      (void)cache; /* silence -Wunused-but-set-parameter when sizeof...(Rs) == 0 */
+    }
     void bind(CACHE* cache)
     {
       std::apply([cache = cache](auto&... r) { (..., r.bind(cache)); }, intern_);
@@ -309,6 +378,8 @@ public:
     void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                      champsim::address victim_addr, access_type type) final;
     void impl_replacement_final_stats() final;
+    void impl_replacement_save_state(champsim::checkpoint_writer& out) final;
+    void impl_replacement_load_state(champsim::checkpoint_reader& in) final;
   };
 
   std::unique_ptr<prefetcher_module_concept> pref_module_pimpl;
@@ -322,8 +393,11 @@ public:
                                                     long set, long way, bool prefetch, champsim::address evicted_addr, champsim::capability evicted_cap,
                                                     uint32_t metadata_in, uint32_t metadata_evict, uint32_t cpu_evict) const;
   void impl_prefetcher_cycle_operate() const;
+  [[nodiscard]] bool impl_prefetcher_has_cycle_operate() const;
   void impl_prefetcher_final_stats() const;
   void impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) const;
+  void impl_prefetcher_save_state(champsim::checkpoint_writer& out) const;
+  void impl_prefetcher_load_state(champsim::checkpoint_reader& in) const;
 
   void impl_initialize_replacement() const;
   [[nodiscard]] long impl_find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const BLOCK* current_set, champsim::address ip,
@@ -333,15 +407,18 @@ public:
   void impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
                                    champsim::address victim_addr, access_type type) const;
   void impl_replacement_final_stats() const;
+  void impl_replacement_save_state(champsim::checkpoint_writer& out) const;
+  void impl_replacement_load_state(champsim::checkpoint_reader& in) const;
   // NOLINTEND(readability-make-member-function-const)
 
   template <typename... Ps, typename... Rs>
   explicit CACHE(champsim::cache_builder<champsim::cache_builder_module_type_holder<Ps...>, champsim::cache_builder_module_type_holder<Rs...>> b)
-      : champsim::operable(b.m_clock_period), upper_levels(b.m_uls), lower_level(b.m_ll), lower_translate(b.m_lt), NAME(b.m_name), NUM_SET(b.get_num_sets()),
+      : champsim::operable(b.m_clock_period), pf_filter(b.m_pf_filter_size), upper_levels(b.m_uls), lower_level(b.m_ll), lower_translate(b.m_lt), NAME(b.m_name), NUM_SET(b.get_num_sets()),
         NUM_WAY(b.get_num_ways()), MSHR_SIZE(b.get_num_mshrs()), PQ_SIZE(b.m_pq_size), HIT_LATENCY(b.get_hit_latency() * b.m_clock_period),
         FILL_LATENCY(b.get_fill_latency() * b.m_clock_period), OFFSET_BITS(b.m_offset_bits), MAX_TAG(b.get_tag_bandwidth()), MAX_FILL(b.get_fill_bandwidth()),
         prefetch_as_load(b.m_pref_load), match_offset_bits(b.m_wq_full_addr), virtual_prefetch(b.m_va_pref), pref_activate_mask(b.m_pref_act_mask),
-        pref_module_pimpl(std::make_unique<prefetcher_module_model<Ps...>>(this)), repl_module_pimpl(std::make_unique<replacement_module_model<Rs...>>(this))
+        pref_module_pimpl(std::make_unique<prefetcher_module_model<Ps...>>(this, b.m_prefetcher_names)),
+        repl_module_pimpl(std::make_unique<replacement_module_model<Rs...>>(this, b.m_replacement_names))
   {
   }
 
@@ -432,6 +509,13 @@ void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_cycle_operate()
   std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
 }
 
+template <typename... Ps>
+bool CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_has_cycle_operate() const
+{
+  using namespace champsim::modules;
+  return (false || ... || prefetcher::has_cycle_operate<Ps>);
+}
+
 template <typename... Ps>
 void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_final_stats()
 {
@@ -458,6 +542,40 @@ void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_branch_operate(champ
   std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
 }
 
+// Each module's state is kept in a section under its configured name, so that a module configured in its place does not read it
+template <typename... Ps>
+void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_save_state(champsim::checkpoint_writer& out)
+{
+  [[maybe_unused]] auto name = std::cbegin(names_);
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    using namespace champsim::modules;
+    if constexpr (prefetcher::has_save_state<decltype(p), champsim::checkpoint_writer&>)
+      out.write_section(*name, [&](auto& section) { p.prefetcher_save_state(section); });
+    ++name;
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
+template <typename... Ps>
+void CACHE::prefetcher_module_model<Ps...>::impl_prefetcher_load_state(champsim::checkpoint_reader& in)
+{
+  [[maybe_unused]] auto sections = in.read_sections();
+  [[maybe_unused]] auto name = std::cbegin(names_);
+  [[maybe_unused]] auto process_one = [&](auto& p) {
+    using namespace champsim::modules;
+    if constexpr (prefetcher::has_load_state<decltype(p), champsim::checkpoint_reader&>) {
+      if (auto found = sections.find(*name); found != std::end(sections))
+        p.prefetcher_load_state(found->second);
+    } else {
+      warn_no_load_state("prefetcher", *name);
+    }
+    ++name;
+  };
+
+  std::apply([&](auto&... p) { (..., process_one(p)); }, intern_);
+}
+
 template <typename... Rs>
 void CACHE::replacement_module_model<Rs...>::impl_initialize_replacement()
 {
@@ -565,6 +683,39 @@ void CACHE::replacement_module_model<Rs...>::impl_replacement_final_stats()
   std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
 }
 
+template <typename... Rs>
+void CACHE::replacement_module_model<Rs...>::impl_replacement_save_state(champsim::checkpoint_writer& out)
+{
+  [[maybe_unused]] auto name = std::cbegin(names_);
+  [[maybe_unused]] auto process_one = [&](auto& r) {
+    using namespace champsim::modules;
+    if constexpr (replacement::has_save_state<decltype(r), champsim::checkpoint_writer&>)
+      out.write_section(*name, [&](auto& section) { r.replacement_save_state(section); });
+    ++name;
+  };
+
+  std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
+}
+
+template <typename... Rs>
+void CACHE::replacement_module_model<Rs...>::impl_replacement_load_state(champsim::checkpoint_reader& in)
+{
+  [[maybe_unused]] auto sections = in.read_sections();
+  [[maybe_unused]] auto name = std::cbegin(names_);
+  [[maybe_unused]] auto process_one = [&](auto& r) {
+    using namespace champsim::modules;
+    if constexpr (replacement::has_load_state<decltype(r), champsim::checkpoint_reader&>) {
+      if (auto found = sections.find(*name); found != std::end(sections))
+        r.replacement_load_state(found->second);
+    } else {
+      warn_no_load_state("replacement policy", *name);
+    }
+    ++name;
+  };
+
+  std::apply([&](auto&... r) { (..., process_one(r)); }, intern_);
+}
+
 #ifdef SET_ASIDE_CHAMPSIM_MODULE
 #undef SET_ASIDE_CHAMPSIM_MODULE
 #define CHAMPSIM_MODULE
@@ -22,6 +22,8 @@
 #include <cstdint>
 #include <limits>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "champsim.h"
 #include "channel.h"
@@ -47,6 +49,7 @@ struct cache_builder_base {
   double m_sets_factor{64};
   std::optional<uint32_t> m_ways{};
   std::size_t m_pq_size{std::numeric_limits<std::size_t>::max()};
+  std::size_t m_pf_filter_size{};
   std::optional<uint32_t> m_mshr_size{};
   std::optional<uint64_t> m_hit_lat{};
   std::optional<uint64_t> m_fill_lat{};
@@ -62,6 +65,9 @@ struct cache_builder_base {
   std::vector<champsim::channel*> m_uls{};
   champsim::channel* m_ll{};
   champsim::channel* m_lt{nullptr};
+
+  std::vector<std::string> m_prefetcher_names{};
+  std::vector<std::string> m_replacement_names{};
 };
 } // namespace detail
 
@@ -140,6 +146,12 @@ public:
    */
   self_type& pq_size(uint32_t pq_size_);
 
+  /**
+   * Specify the number of entries in the filter of recently issued prefetches.
+   * If this is nonzero, prefetches for blocks that are already resident, in flight, or recently issued are dropped before the tag check.
+   */
+  self_type& prefetch_filter_size(uint32_t pf_filter_size_);
+
   /**
    * Specify the number of MSHRs.
    * If this is not specified, it will be derived from the number of sets, fill latency, and fill bandwidth.
@@ -234,16 +246,16 @@ public:
   self_type& lower_translate(champsim::channel* lt_);
 
   /**
-   * Specify the cache prefetcher.
+   * Specify the cache prefetcher, and the names under which its modules keep their checkpointed state.
    */
   template <typename... Ps>
-  cache_builder<cache_builder_module_type_holder<Ps...>, R> prefetcher();
+  cache_builder<cache_builder_module_type_holder<Ps...>, R> prefetcher(std::vector<std::string> names = {});
 
   /**
-   * Specify the cache replacement policy.
+   * Specify the cache replacement policy, and the names under which its modules keep their checkpointed state.
    */
   template <typename... Rs>
-  cache_builder<P, cache_builder_module_type_holder<Rs...>> replacement();
+  cache_builder<P, cache_builder_module_type_holder<Rs...>> replacement(std::vector<std::string> names = {});
 };
 } // namespace champsim
 
@@ -388,6 +400,13 @@ auto champsim::cache_builder<P, R>::pq_size(uint32_t pq_size_) -> self_type&
   return *this;
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::prefetch_filter_size(uint32_t pf_filter_size_) -> self_type&
+{
+  m_pf_filter_size = pf_filter_size_;
+  return *this;
+}
+
 template <typename P, typename R>
 auto champsim::cache_builder<P, R>::mshr_size(uint32_t mshr_size_) -> self_type&
 {
@@ -516,16 +535,20 @@ auto champsim::cache_builder<P, R>::lower_translate(champsim::channel* lt_) -> s
 
 template <typename P, typename R>
 template <typename... Ps>
-auto champsim::cache_builder<P, R>::prefetcher() -> champsim::cache_builder<champsim::cache_builder_module_type_holder<Ps...>, R>
+auto champsim::cache_builder<P, R>::prefetcher(std::vector<std::string> names) -> champsim::cache_builder<champsim::cache_builder_module_type_holder<Ps...>, R>
 {
-  return champsim::cache_builder<champsim::cache_builder_module_type_holder<Ps...>, R>{*this};
+  champsim::cache_builder<champsim::cache_builder_module_type_holder<Ps...>, R> retval{*this};
+  retval.m_prefetcher_names = std::move(names);
+  return retval;
 }
 
 template <typename P, typename R>
 template <typename... Rs>
-auto champsim::cache_builder<P, R>::replacement() -> champsim::cache_builder<P, champsim::cache_builder_module_type_holder<Rs...>>
+auto champsim::cache_builder<P, R>::replacement(std::vector<std::string> names) -> champsim::cache_builder<P, champsim::cache_builder_module_type_holder<Rs...>>
 {
-  return champsim::cache_builder<P, champsim::cache_builder_module_type_holder<Rs...>>{*this};
+  champsim::cache_builder<P, champsim::cache_builder_module_type_holder<Rs...>> retval{*this};
+  retval.m_replacement_names = std::move(names);
+  return retval;
 }
 
 #endif
@@ -2,13 +2,17 @@
 #define CACHE_STATS_H
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "capability_memory.h"
 #include "channel.h"
 #include "event_counter.h"
+#include "reuse_profiler.h"
 
 enum class cap_size_coverage_events : uint8_t {
   B_0_128B = 0, // 0–128B
@@ -70,32 +74,58 @@ inline cap_size_coverage_events classify_capability(const champsim::capability&
 
 using cap_dist_key = std::tuple<cap_size_coverage_events, access_type, std::remove_cv_t<decltype(NUM_CPUS)>>;
 using cl_cap_key = std::tuple<unsigned, access_type, std::remove_cv_t<decltype(NUM_CPUS)>>;
+using reuse_key = std::tuple<unsigned, cap_size_coverage_events, access_type, std::remove_cv_t<decltype(NUM_CPUS)>>;
+
+// The number of values each leading key element can take, so that the counters can be indexed densely
+inline constexpr std::size_t NUM_ACCESS_TYPES = static_cast<std::size_t>(access_type::NUM_TYPES);
+inline constexpr std::size_t NUM_CAP_DIST_EVENTS = static_cast<std::size_t>(cap_size_coverage_events::NUM_coverage_events);
+inline constexpr std::size_t NUM_CL_CAP_COUNTS = champsim::capability_memory::GRANULES_PER_LINE + 1;
+inline constexpr std::size_t NUM_REUSE_BUCKETS = champsim::reuse_profiler::num_buckets;
 
 struct cache_stats {
   std::string name;
   // prefetch stats
   uint64_t pf_requested = 0;
   uint64_t pf_issued = 0;
+  uint64_t pf_dropped_resident = 0;
+  uint64_t pf_dropped_inflight = 0;
+  uint64_t pf_dropped_recent = 0;
   uint64_t pf_useful = 0;
   uint64_t pf_useless = 0;
   uint64_t pf_fill = 0;
 
-  champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> hits = {};
-  champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> misses = {};
-  champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_merge = {};
-  champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_return = {};
+  using access_counter = champsim::stats::dense_event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>, NUM_ACCESS_TYPES>;
+  using cap_dist_counter = champsim::stats::dense_event_counter<cap_dist_key, NUM_CAP_DIST_EVENTS, NUM_ACCESS_TYPES>;
+  using cl_cap_counter = champsim::stats::dense_event_counter<cl_cap_key, NUM_CL_CAP_COUNTS, NUM_ACCESS_TYPES>;
+  using reuse_counter = champsim::stats::dense_event_counter<reuse_key, NUM_REUSE_BUCKETS, NUM_CAP_DIST_EVENTS, NUM_ACCESS_TYPES>;
+
+  access_counter hits = {};
+  access_counter misses = {};
+  access_counter mshr_merge = {};
+  access_counter mshr_return = {};
 
   long total_miss_latency_cycles{};
 
-  champsim::stats::event_counter<cap_dist_key> cap_auth_hits = {};
-  champsim::stats::event_counter<cap_dist_key> cap_auth_misses = {};
-  champsim::stats::event_counter<cap_dist_key> cap_data_hits = {};
-  champsim::stats::event_counter<cap_dist_key> cap_data_misses = {};
+  cap_dist_counter cap_auth_hits = {};
+  cap_dist_counter cap_auth_misses = {};
+  cap_dist_counter cap_data_hits = {};
+  cap_dist_counter cap_data_misses = {};
+
+  cl_cap_counter capabilities_per_cl_hit = {};
+  cl_cap_counter capabilities_per_cl_miss = {};
 
-  champsim::stats::event_counter<cl_cap_key> capabilities_per_cl_hit = {};
-  champsim::stats::event_counter<cl_cap_key> capabilities_per_cl_miss = {};
+  // The sampled reuse distances of the accesses, in the buckets of champsim::reuse_profiler, by the size of the authorizing capability
+  reuse_counter reuse_distances = {};
 };
 
 cache_stats operator-(cache_stats lhs, cache_stats rhs);
+cache_stats operator+(cache_stats lhs, cache_stats rhs);
+
+/**
+ * Estimate the miss ratio of a fully-associative LRU cache of 2^k blocks, for each k below the cold bucket, from the reuse distances of
+ * one CPU's accesses that are of the selected types and capability sizes. The curve is empty if no such access was sampled.
+ */
+std::vector<double> miss_ratio_curve(const cache_stats::reuse_counter& distances, std::remove_cv_t<decltype(NUM_CPUS)> cpu,
+                                     const std::function<bool(cap_size_coverage_events, access_type)>& select);
 
 #endif
\ No newline at end of file
@@ -18,21 +18,59 @@
 #define CAPABILITY_MEMORY_H
 
 #include <algorithm>
+#include <array>
+#include <bitset>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
+#include "checkpoint.h"
 #include "cheri.h"
 
 namespace champsim {
 
+/**
+ * The trace that a capability snapshot was built from, identified by its size and a hash of its first and last blocks.
+ * Only the ends are hashed, so that identifying a trace of many gigabytes does not read all of it.
+ */
+struct trace_identity {
+  uint64_t size = 0;
+  uint64_t hash = 0;
+
+  static trace_identity of(const std::string& fname);
+  bool operator==(const trace_identity& other) const { return size == other.size && hash == other.hash; }
+  bool operator!=(const trace_identity& other) const { return !(*this == other); }
+};
+
 class capability_memory {
-private:
+public:
   static constexpr uint64_t CAP_ALIGNMENT_BITS = 4;
+  static constexpr std::size_t GRANULES_PER_LINE = 4;
+  static constexpr uint64_t LINE_BITS = CAP_ALIGNMENT_BITS + 2;
+
+  /**
+   * The capabilities held in one 64-byte line.
+   * Bit i of tag_mask is set if the i-th 16-byte granule holds a tagged capability, which is then described by caps[i].
+   */
+  struct line_capabilities {
+    uint8_t tag_mask = 0;
+    std::array<capability, GRANULES_PER_LINE> caps{};
+
+    [[nodiscard]] unsigned count() const { return static_cast<unsigned>(std::bitset<GRANULES_PER_LINE>{tag_mask}.count()); }
+    [[nodiscard]] std::optional<capability> at(champsim::address addr) const
+    {
+      auto granule = granule_in_line(addr_to_key(addr));
+      if ((tag_mask >> granule) & 1u)
+        return caps[granule];
+      return std::nullopt;
+    }
+  };
 
+private:
   struct cap_descriptor {
     uint64_t base;
     uint64_t length;
@@ -55,42 +93,121 @@ private:
     }
   };
 
-  struct presimpoint_entry {
-    uint64_t va_key;
-    uint64_t offset;
-    uint32_t cap_id;
+  static constexpr uint64_t empty_key = std::numeric_limits<uint64_t>::max();
+  static constexpr double max_load_factor = 0.5;
 
-    bool operator<(const presimpoint_entry& o) const { return va_key < o.va_key; }
+  // The capabilities of one 64-byte line, with each descriptor stored as an index into cap_table_.
+  // A line's granules share a slot, so a whole-line query is a single probe that touches a single host cache line.
+  struct alignas(64) line_slot {
+    uint64_t line_key = empty_key;
+    std::array<uint64_t, GRANULES_PER_LINE> offsets{};
+    std::array<uint32_t, GRANULES_PER_LINE> cap_ids{};
+    uint8_t tag_mask = 0;
   };
 
   std::unordered_map<uint64_t, capability> presimpoint_map_;
 
-  std::vector<presimpoint_entry> presimpoint_entries_;
+  // After finalization, every line with a tagged granule lives in a single open-addressed (linear probing) table.
+  // The table is either owned, or is a private mapping of a snapshot file whose pages are copied only when written.
+  line_slot* slots_ = nullptr;
+  std::size_t num_slots_ = 0;
+  std::vector<line_slot> owned_slots_;
+  std::shared_ptr<void> snapshot_mapping_;
+  std::string snapshot_output_;
+  trace_identity snapshot_source_;
+  std::size_t occupied_ = 0;
+  std::size_t tagged_granules_ = 0;
+  unsigned slot_shift_ = 64;
   std::vector<cap_descriptor> cap_table_;
+  std::unordered_map<cap_descriptor, uint32_t, cap_descriptor_hash> region_cap_ids_; // Rebuilt on demand after a snapshot or checkpoint is loaded
   bool finalized_ = false;
 
-  std::unordered_map<uint64_t, capability> simpoint_region_map_;
-  std::unordered_set<uint64_t> invalidated_keys_;
-
   static uint64_t addr_to_key(champsim::address addr)
   {
     return addr.to<uint64_t>() >> CAP_ALIGNMENT_BITS;
   }
 
-  capability rebuild(const presimpoint_entry& e) const;
-  const presimpoint_entry* find_in_presimpoint(uint64_t key) const;
+  static uint64_t line_of(uint64_t key) { return key >> (LINE_BITS - CAP_ALIGNMENT_BITS); }
+  static std::size_t granule_in_line(uint64_t key) { return static_cast<std::size_t>(key & (GRANULES_PER_LINE - 1)); }
+
+  std::size_t home_slot(uint64_t line_key) const
+  {
+    // Fibonacci hashing spreads the consecutive lines of an object across the table
+    return static_cast<std::size_t>((line_key * 0x9e3779b97f4a7c15ULL) >> slot_shift_);
+  }
+
+  capability rebuild(const line_slot& slot, std::size_t granule) const;
+  const line_slot* find_slot(uint64_t line_key) const;
+  line_slot& emplace_slot(uint64_t line_key);
+  uint32_t intern(const capability& cap);
+  void reserve_slots(std::size_t count);
+  void erase_slot(const line_slot* slot);
+  void erase_granule(uint64_t key);
 
 public:
   capability_memory() = default;
-
+  capability_memory(const capability_memory&) = delete;
+  capability_memory& operator=(const capability_memory&) = delete;
+  capability_memory(capability_memory&&) = default;
+  capability_memory& operator=(capability_memory&&) = default;
+  ~capability_memory() = default;
+
+  /**
+   * Build the lookup table from the presimpoint contents. Later stores and invalidations apply directly to the table.
+   * If a snapshot output has been set, the finalized contents are written to it.
+   */
   void finalize();
 
+  /**
+   * Write the finalized contents to a versioned binary snapshot, which load_snapshot() can map in place of replaying the presimpoint records.
+   * The snapshot records the trace whose presimpoint records it was built from.
+   */
+  void save_snapshot(const std::string& fname, const trace_identity& source) const;
+
+  /**
+   * Replace the contents with a snapshot written by save_snapshot(). The memory is finalized afterward.
+   * The table is mapped privately, so concurrent runs share its pages until they modify them.
+   * A snapshot that was built from a trace other than the given one is rejected.
+   */
+  void load_snapshot(const std::string& fname, const trace_identity& source);
+
+  /**
+   * Save or restore the contents, finalized or not, as part of a checkpoint of the whole simulation.
+   */
+  void save_state(champsim::checkpoint_writer& out) const;
+  void load_state(champsim::checkpoint_reader& in);
+
+  /**
+   * Write a snapshot of the given trace's capabilities to the given file when this memory is finalized.
+   */
+  void set_snapshot_output(std::string fname, const trace_identity& source)
+  {
+    snapshot_output_ = std::move(fname);
+    snapshot_source_ = source;
+  }
+
   void store_capability(champsim::address addr, const capability& cap);
   std::optional<capability> load_capability(champsim::address addr) const;
   bool has_capability(champsim::address addr) const;
   void invalidate_tag(champsim::address addr);
 
+  /**
+   * Look up every granule of the 64-byte line that contains the given address.
+   */
+  line_capabilities load_line(champsim::address addr) const;
+
+  /**
+   * Return the tag bits of the 64-byte line that contains the given address, without rebuilding its capabilities.
+   */
+  uint8_t line_tag_mask(champsim::address addr) const;
+
   size_t size() const;
+
+  /**
+   * The number of distinct (base, length, permissions) descriptors that the finalized contents refer to.
+   */
+  size_t unique_capabilities() const { return std::size(cap_table_); }
+
   void clear();
   bool is_finalized() const { return finalized_; }
 };
@@ -22,12 +22,16 @@
 #include <deque>
 #include <limits>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "access_type.h"
 #include "address.h"
 #include "champsim.h"
 #include "cheri.h"
+#include "dependency_list.h"
+#include "operable.h"
+#include "util/block_indexed_deque.h"
 
 namespace champsim
 {
@@ -69,7 +73,7 @@ class channel
     uint64_t instr_id = 0;
     champsim::address ip{};
 
-    std::vector<uint64_t> instr_depend_on_me{};
+    champsim::dependency_list instr_depend_on_me{};
   };
 
   struct response {
@@ -79,7 +83,7 @@ class channel
 
     uint32_t pf_metadata = 0;
     champsim::capability cap{};
-    std::vector<uint64_t> instr_depend_on_me{};
+    champsim::dependency_list instr_depend_on_me{};
 
 
     // response(champsim::address addr, champsim::address v_addr, champsim::address data_, uint32_t pf_meta, std::vector<uint64_t> deps)
@@ -89,8 +93,8 @@ class channel
 
     // explicit response(request req) : response(req.address, req.v_address, req.data, req.pf_metadata, req.instr_depend_on_me) {cap = req.cap;}
 
-    response(champsim::address addr, champsim::address v_addr, champsim::address data_, uint32_t pf_meta, champsim::capability cap_, std::vector<uint64_t> deps)
-        : address(addr), v_address(v_addr), data(data_), pf_metadata(pf_meta), cap(cap_), instr_depend_on_me(deps)
+    response(champsim::address addr, champsim::address v_addr, champsim::address data_, uint32_t pf_meta, champsim::capability cap_, champsim::dependency_list deps)
+        : address(addr), v_address(v_addr), data(data_), pf_metadata(pf_meta), cap(cap_), instr_depend_on_me(std::move(deps))
     {
     }
 
@@ -114,8 +118,75 @@ public:
   using request_type = request;
   using stats_type = cache_queue_stats;
 
-  std::deque<request_type> RQ{}, PQ{}, WQ{};
-  std::deque<response_type> returned{};
+  /**
+   * The responses returned to the operable above a channel. Adding a response wakes that operable.
+   * The storage is not exposed, so every way of adding a response goes through the wake.
+   */
+  class response_queue
+  {
+    using container_type = std::deque<response_type>;
+    container_type elements{};
+
+    void wake_consumer() const
+    {
+      if (consumer != nullptr) {
+        consumer->wake();
+      }
+    }
+
+  public:
+    using value_type = typename container_type::value_type;
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference = typename container_type::reference;
+    using const_reference = typename container_type::const_reference;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    champsim::operable* consumer = nullptr;
+
+    [[nodiscard]] iterator begin() noexcept { return std::begin(elements); }
+    [[nodiscard]] iterator end() noexcept { return std::end(elements); }
+    [[nodiscard]] const_iterator begin() const noexcept { return std::cbegin(elements); }
+    [[nodiscard]] const_iterator end() const noexcept { return std::cend(elements); }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return std::cbegin(elements); }
+    [[nodiscard]] const_iterator cend() const noexcept { return std::cend(elements); }
+
+    [[nodiscard]] size_type size() const noexcept { return std::size(elements); }
+    [[nodiscard]] bool empty() const noexcept { return std::empty(elements); }
+
+    [[nodiscard]] reference front() { return elements.front(); }
+    [[nodiscard]] const_reference front() const { return elements.front(); }
+
+    void push_back(const value_type& elem)
+    {
+      wake_consumer();
+      elements.push_back(elem);
+    }
+
+    void push_back(value_type&& elem)
+    {
+      wake_consumer();
+      elements.push_back(std::move(elem));
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+      wake_consumer();
+      return elements.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void pop_front() { elements.pop_front(); }
+    iterator erase(const_iterator first, const_iterator last) { return elements.erase(first, last); }
+    void clear() noexcept { elements.clear(); }
+  };
+
+  champsim::block_indexed_deque<request_type> RQ{}, PQ{}, WQ{};
+  response_queue returned{};
+
+  // The operable that consumes the RQ, PQ, and WQ. It is woken when a packet is added.
+  champsim::operable* queue_consumer = nullptr;
 
   stats_type sim_stats{}, roi_stats{};
 
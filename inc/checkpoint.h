@@ -0,0 +1,167 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace champsim
+{
+struct environment;
+struct phase_info;
+class tracereader;
+
+/**
+ * Accumulates the binary contents of a checkpoint.
+ *
+ * Values are written in the host's representation, so a checkpoint can be read only by a build for the same platform.
+ * A component writes its state into a named section, which a reader can find by name and which it can skip if no component claims it.
+ */
+class checkpoint_writer
+{
+  std::string buffer_;
+
+public:
+  template <typename T>
+  void write(const T& value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  template <typename T>
+  void write(const T* values, std::size_t count)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    write(count);
+    buffer_.append(reinterpret_cast<const char*>(values), count * sizeof(T)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  template <typename T>
+  void write(const std::vector<T>& values)
+  {
+    write(std::data(values), std::size(values));
+  }
+
+  void write_string(std::string_view str)
+  {
+    write(std::size(str));
+    buffer_.append(str);
+  }
+
+  /**
+   * Write a named section, whose contents are given by calling the function with a writer.
+   */
+  template <typename F>
+  void write_section(std::string_view name, F&& func)
+  {
+    checkpoint_writer contents;
+    func(contents);
+    write_string(name);
+    write_string(contents.buffer_);
+  }
+
+  [[nodiscard]] const std::string& data() const { return buffer_; }
+};
+
+/**
+ * Reads the contents of a checkpoint, in the order in which they were written.
+ * Reading past the end of the contents throws std::runtime_error.
+ */
+class checkpoint_reader
+{
+  std::string_view data_;
+
+  std::string_view take(std::size_t count)
+  {
+    if (count > std::size(data_))
+      throw std::runtime_error{"Checkpoint is truncated"};
+    auto retval = data_.substr(0, count);
+    data_.remove_prefix(count);
+    return retval;
+  }
+
+public:
+  explicit checkpoint_reader(std::string_view data) : data_(data) {}
+
+  template <typename T>
+  void read(T& value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::memcpy(&value, std::data(take(sizeof(T))), sizeof(T));
+  }
+
+  template <typename T>
+  void read(std::vector<T>& values)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::size_t count{};
+    read(count);
+    if (count > std::size(data_) / std::max<std::size_t>(sizeof(T), 1))
+      throw std::runtime_error{"Checkpoint is truncated"};
+    values.resize(count);
+    std::memcpy(std::data(values), std::data(take(count * sizeof(T))), count * sizeof(T));
+  }
+
+  std::string_view read_string()
+  {
+    std::size_t count{};
+    read(count);
+    return take(count);
+  }
+
+  /**
+   * Read every remaining section, so that they can be found by name in any order.
+   */
+  std::map<std::string, checkpoint_reader, std::less<>> read_sections()
+  {
+    std::map<std::string, checkpoint_reader, std::less<>> retval;
+    while (!empty()) {
+      auto name = read_string();
+      retval.insert_or_assign(std::string{name}, checkpoint_reader{read_string()});
+    }
+    return retval;
+  }
+
+  [[nodiscard]] bool empty() const { return std::empty(data_); }
+};
+
+/**
+ * Write the warmed state of the environment to a file: the contents of the caches and TLBs, the PSCLs, the DIBs, the state of any module
+ * that implements the checkpoint hooks, the virtual memory mappings, the capability memory, and each CPU's position in its trace.
+ * Packets in flight are not saved, so a checkpoint restores the hierarchy as if its MSHRs and queues had drained.
+ */
+void save_checkpoint(const std::string& fname, environment& env, const phase_info& phase);
+
+/**
+ * Restore the state written by save_checkpoint() into an environment with the same structure, and advance each trace past the instructions
+ * that were retired before the checkpoint was taken.
+ * Modules are matched by their configured names, so a module that was not saved starts cold. A module without load hooks also starts cold,
+ * and a warning is printed.
+ */
+void load_checkpoint(const std::string& fname, environment& env, std::vector<tracereader>& traces, const phase_info& phase);
+} // namespace champsim
+
+#endif
@@ -19,6 +19,8 @@
 
 #include <cstdint>
 #include <limits>
+#include <string>
+#include <vector>
 
 #include "chrono.h"
 
@@ -73,6 +75,9 @@ struct core_builder_base {
   champsim::bandwidth::maximum_type m_l1d_bw{1};
   champsim::channel* m_fetch_queues{};
   champsim::channel* m_data_queues{};
+
+  std::vector<std::string> m_branch_predictor_names{};
+  std::vector<std::string> m_btb_names{};
 };
 } // namespace detail
 
@@ -256,16 +261,16 @@ public:
   self_type& data_queues(champsim::channel* data_queues_);
 
   /**
-   * Specify the branch direction predictor.
+   * Specify the branch direction predictor, and the names under which its modules keep their checkpointed state.
    */
   template <typename... Bs>
-  core_builder<core_builder_module_type_holder<Bs...>, T> branch_predictor();
+  core_builder<core_builder_module_type_holder<Bs...>, T> branch_predictor(std::vector<std::string> names = {});
 
   /**
-   * Specify the branch target predictor.
+   * Specify the branch target predictor, and the names under which its modules keep their checkpointed state.
    */
   template <typename... Ts>
-  core_builder<B, core_builder_module_type_holder<Ts...>> btb();
+  core_builder<B, core_builder_module_type_holder<Ts...>> btb(std::vector<std::string> names = {});
 };
 } // namespace champsim
 
@@ -502,16 +507,20 @@ auto champsim::core_builder<B, T>::data_queues(champsim::channel* data_queues_)
 
 template <typename B, typename T>
 template <typename... Bs>
-auto champsim::core_builder<B, T>::branch_predictor() -> champsim::core_builder<core_builder_module_type_holder<Bs...>, T>
+auto champsim::core_builder<B, T>::branch_predictor(std::vector<std::string> names) -> champsim::core_builder<core_builder_module_type_holder<Bs...>, T>
 {
-  return champsim::core_builder<core_builder_module_type_holder<Bs...>, T>{*this};
+  champsim::core_builder<core_builder_module_type_holder<Bs...>, T> retval{*this};
+  retval.m_branch_predictor_names = std::move(names);
+  return retval;
 }
 
 template <typename B, typename T>
 template <typename... Ts>
-auto champsim::core_builder<B, T>::btb() -> champsim::core_builder<B, core_builder_module_type_holder<Ts...>>
+auto champsim::core_builder<B, T>::btb(std::vector<std::string> names) -> champsim::core_builder<B, core_builder_module_type_holder<Ts...>>
 {
-  return champsim::core_builder<B, core_builder_module_type_holder<Ts...>>{*this};
+  champsim::core_builder<B, core_builder_module_type_holder<Ts...>> retval{*this};
+  retval.m_btb_names = std::move(names);
+  return retval;
 }
 
 #endif
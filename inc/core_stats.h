@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "event_counter.h"
 #include "instruction.h"
@@ -23,5 +24,20 @@ struct cpu_stats {
 };
 
 cpu_stats operator-(cpu_stats lhs, cpu_stats rhs);
+cpu_stats operator+(cpu_stats lhs, cpu_stats rhs);
+
+struct ipc_estimate {
+  double ipc = 0;
+  double lower = 0; // The bounds of the 95% confidence interval, which are both the IPC if there are fewer than two windows
+  double upper = 0;
+  std::size_t windows = 0;
+};
+
+/**
+ * Estimate a core's IPC from the statistics of each of a number of detailed windows.
+ * Each window holds the same number of instructions, so the windows' CPIs are averaged, rather than their IPCs. The IPC and the bounds of
+ * its confidence interval are the reciprocals of the mean CPI and of the bounds of its interval.
+ */
+ipc_estimate estimate_ipc(const std::vector<cpu_stats>& windows);
 
 #endif
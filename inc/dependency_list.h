@@ -0,0 +1,124 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEPENDENCY_LIST_H
+#define DEPENDENCY_LIST_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * The instruction ids that wait on a memory request, held in ascending order.
+ *
+ * Copies share one reference-counted list, so a request can be forwarded through the hierarchy and returned without copying its
+ * dependents. A list is copied only when a shared list is modified, and merging with an empty or identical list reuses the other one.
+ */
+class dependency_list
+{
+  std::shared_ptr<std::vector<uint64_t>> ids{};
+
+  std::vector<uint64_t>& writable_ids()
+  {
+    if (!ids) {
+      ids = std::make_shared<std::vector<uint64_t>>();
+    } else if (ids.use_count() > 1) {
+      ids = std::make_shared<std::vector<uint64_t>>(*ids);
+    }
+    return *ids;
+  }
+
+public:
+  using value_type = uint64_t;
+  using size_type = std::size_t;
+  using const_reference = const uint64_t&;
+  using const_iterator = const uint64_t*;
+  using iterator = const_iterator;
+
+  dependency_list() = default;
+  dependency_list(std::initializer_list<uint64_t> init) : dependency_list(std::vector<uint64_t>{init}) {}
+  dependency_list(std::vector<uint64_t> init) // NOLINT(google-explicit-constructor): a vector of ids is a dependency list
+  {
+    if (!std::empty(init)) {
+      ids = std::make_shared<std::vector<uint64_t>>(std::move(init));
+    }
+  }
+
+  [[nodiscard]] const_iterator begin() const noexcept { return ids ? std::data(*ids) : nullptr; }
+  [[nodiscard]] const_iterator end() const noexcept { return ids ? std::data(*ids) + std::size(*ids) : nullptr; }
+  [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+  [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+  [[nodiscard]] size_type size() const noexcept { return ids ? std::size(*ids) : 0; }
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+  [[nodiscard]] const_reference front() const { return ids->front(); }
+
+  void push_back(uint64_t id) { writable_ids().push_back(id); }
+
+  const_iterator erase(const_iterator pos)
+  {
+    auto idx = std::distance(begin(), pos);
+    auto& writable = writable_ids();
+    writable.erase(std::next(std::begin(writable), idx));
+    return std::next(begin(), idx);
+  }
+
+  const_iterator erase(const_iterator first, const_iterator last)
+  {
+    auto first_idx = std::distance(begin(), first);
+    auto last_idx = std::distance(begin(), last);
+    if (first_idx == last_idx) {
+      return first;
+    }
+    auto& writable = writable_ids();
+    writable.erase(std::next(std::begin(writable), first_idx), std::next(std::begin(writable), last_idx));
+    return std::next(begin(), first_idx);
+  }
+
+  /**
+   * The sorted union of two lists. If either list is empty, or both share storage, the result shares the other's storage.
+   */
+  [[nodiscard]] static dependency_list merge(const dependency_list& lhs, const dependency_list& rhs)
+  {
+    if (rhs.empty() || lhs.ids == rhs.ids) {
+      return lhs;
+    }
+    if (lhs.empty()) {
+      return rhs;
+    }
+
+    std::vector<uint64_t> merged{};
+    merged.reserve(lhs.size() + rhs.size());
+    std::set_union(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs), std::back_inserter(merged));
+    return dependency_list{std::move(merged)};
+  }
+
+  friend bool operator==(const dependency_list& lhs, const dependency_list& rhs)
+  {
+    return lhs.ids == rhs.ids || std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+  }
+  friend bool operator!=(const dependency_list& lhs, const dependency_list& rhs) { return !(lhs == rhs); }
+};
+} // namespace champsim
+
+#endif
@@ -26,14 +26,42 @@
 #include <limits>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "address.h"
 #include "channel.h"
 #include "chrono.h"
+#include "dependency_list.h"
 #include "dram_stats.h"
 #include "extent_set.h"
 #include "operable.h"
 
+namespace champsim
+{
+enum class dram_scheduler {
+  fcfs,  // the oldest request to a free bank
+  frfcfs // a request that hits in an open row, then the oldest request to a free bank
+};
+
+enum class dram_page_policy {
+  open,  // the row stays open after an access, for later hits
+  closed // the row is precharged after every access
+};
+
+enum class dram_model {
+  detailed,  // cycle-level timing of the banks, refreshes, and data bus
+  analytical // each request reserves its bank and the data bus when it arrives
+};
+
+struct dram_scheduling_policy {
+  dram_scheduler scheduler = dram_scheduler::fcfs;
+  dram_page_policy page_policy = dram_page_policy::open;
+
+  // The number of consecutive row hits a bank may serve ahead of older requests, or 0 for no limit
+  std::size_t row_hit_cap = 0;
+};
+} // namespace champsim
+
 struct DRAM_ADDRESS_MAPPING {
   constexpr static std::size_t SLICER_OFFSET_IDX = 0;
   constexpr static std::size_t SLICER_CHANNEL_IDX = 1;
@@ -110,8 +138,13 @@ struct DRAM_CHANNEL final : public champsim::operable {
     champsim::address data{};
     champsim::chrono::clock::time_point ready_time = champsim::chrono::clock::time_point::max();
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::dependency_list instr_depend_on_me{};
+    std::vector<champsim::channel::response_queue*> to_return{};
+
+    // The location of the request, decoded once when it is first checked for collisions
+    std::size_t bank_index = 0;
+    std::size_t bankgroup_index = 0;
+    unsigned long row = 0;
 
     explicit request_type(const typename champsim::channel::request_type& req);
   };
@@ -133,6 +166,12 @@ struct DRAM_CHANNEL final : public champsim::operable {
     champsim::chrono::clock::time_point ready_time{};
 
     queue_type::iterator pkt;
+
+    // The row hits this bank has served since it last opened a row
+    std::size_t row_hits = 0;
+
+    // Under a closed page policy, the time at which the automatic precharge after the last access completes
+    champsim::chrono::clock::time_point precharge_done{};
   };
 
   const champsim::data::bytes channel_width;
@@ -141,6 +180,14 @@ struct DRAM_CHANNEL final : public champsim::operable {
   request_array_type bank_request;
   request_array_type::iterator active_request;
 
+  const champsim::dram_scheduling_policy scheduling;
+  const champsim::dram_model model;
+
+  // The queued requests to each bank, in the order they were checked for collisions
+  using bank_queue_type = std::vector<std::vector<queue_type::iterator>>;
+  bank_queue_type bank_reads;
+  bank_queue_type bank_writes;
+
   // track bankgroup accesses
   std::vector<champsim::chrono::clock::time_point> bankgroup_readytime{address_mapping.ranks() * address_mapping.bankgroups(),
                                                                        champsim::chrono::clock::time_point{}};
@@ -166,8 +213,11 @@ struct DRAM_CHANNEL final : public champsim::operable {
 
   DRAM_CHANNEL(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd, std::size_t t_cas,
                std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::size_t refreshes_per_period, champsim::data::bytes width,
-               std::size_t rq_size, std::size_t wq_size, DRAM_ADDRESS_MAPPING addr_mapping);
+               std::size_t rq_size, std::size_t wq_size, DRAM_ADDRESS_MAPPING addr_mapping, champsim::dram_scheduling_policy sched = {},
+               champsim::dram_model timing = champsim::dram_model::detailed);
 
+  void decode_to_bank(queue_type::iterator pkt, bank_queue_type& bank_queues);
+  void remove_from_bank(queue_type::iterator pkt);
   void check_write_collision();
   void check_read_collision();
   long finish_dbus_request();
@@ -175,10 +225,16 @@ struct DRAM_CHANNEL final : public champsim::operable {
   void swap_write_mode();
   long populate_dbus();
   DRAM_CHANNEL::queue_type::iterator schedule_packet();
+  DRAM_CHANNEL::queue_type::iterator schedule_row_hits_first();
   long service_packet(DRAM_CHANNEL::queue_type::iterator pkt);
+  long operate_analytical();
+  void reserve_analytical(DRAM_CHANNEL::queue_type::iterator pkt, bool is_write);
 
   void initialize() final;
   long operate() final;
+  [[nodiscard]] bool is_idle() const final;
+  [[nodiscard]] bool is_idle_at(champsim::chrono::clock::time_point time) const;
+  [[nodiscard]] champsim::chrono::clock::time_point next_wakeup() const final;
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
   void print_deadlock() final;
@@ -211,10 +267,14 @@ public:
   MEMORY_CONTROLLER(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd, std::size_t t_cas,
                     std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::vector<channel_type*>&& ul, std::size_t rq_size, std::size_t wq_size,
                     std::size_t chans, champsim::data::bytes chan_width, std::size_t rows, std::size_t columns, std::size_t ranks, std::size_t bankgroups,
-                    std::size_t banks, std::size_t refreshes_per_period);
+                    std::size_t banks, std::size_t refreshes_per_period, champsim::dram_scheduling_policy sched = {},
+                    champsim::dram_model timing = champsim::dram_model::detailed);
 
   void initialize() final;
   long operate() final;
+  [[nodiscard]] bool is_idle() const final;
+  void operate_idle(long cycles) final;
+  [[nodiscard]] champsim::chrono::clock::time_point next_wakeup() const final;
   void begin_phase() final;
   void end_phase(unsigned cpu) final;
   void print_deadlock() final;
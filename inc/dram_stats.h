@@ -13,5 +13,6 @@ struct dram_stats {
 };
 
 dram_stats operator-(dram_stats lhs, dram_stats rhs);
+dram_stats operator+(dram_stats lhs, dram_stats rhs);
 
 #endif
@@ -17,7 +17,10 @@
 #ifndef ENVIRONMENT_H
 #define ENVIRONMENT_H
 
+#include <array>
 #include <functional>
+#include <memory>
+#include <string_view>
 #include <vector>
 
 #include "cache.h"
@@ -25,22 +28,38 @@
 #include "ooo_cpu.h"
 #include "operable.h"
 #include "ptw.h"
+#include "scheduler.h"
 
 namespace champsim
 {
 struct environment {
+  virtual ~environment() = default;
+
   virtual std::vector<std::reference_wrapper<O3_CPU>> cpu_view() = 0;
   virtual std::vector<std::reference_wrapper<CACHE>> cache_view() = 0;
   virtual std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() = 0;
   virtual MEMORY_CONTROLLER& dram_view() = 0;
   virtual std::vector<std::reference_wrapper<operable>> operable_view() = 0;
+  virtual scheduler& scheduler_view() = 0;
 };
 
 namespace configured
 {
 template <unsigned long long ID>
 struct generated_environment;
-}
+
+/**
+ * The variants built into the executable alongside a configuration. Each variant is another environment, which may differ in any of its
+ * modules and parameters, but has the same number of cores, block size, and page size.
+ *
+ * Configurations without variants use this definition.
+ */
+template <unsigned long long ID>
+struct variants {
+  constexpr static std::array<std::string_view, 0> names{};
+  static std::unique_ptr<environment> make(std::size_t /*index*/) { return nullptr; }
+};
+} // namespace configured
 } // namespace champsim
 
 #endif
@@ -2,11 +2,19 @@
 #define EVENT_COUNTER_H
 
 #include <algorithm>
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <numeric>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "util/to_underlying.h"
+
 namespace champsim::stats
 {
 template <typename Key>
@@ -97,6 +105,20 @@ public:
     return lhs;
   }
 
+  /**
+   * Add the counts of another counter, allocating the keys that only it has seen.
+   * Unlike operator+=, which adds only into keys that this counter has already seen.
+   */
+  event_counter<key_type>& merge(const event_counter<key_type>& rhs)
+  {
+    for (std::size_t i = 0; i < std::size(rhs.keys); ++i) {
+      allocate(rhs.keys[i]);
+      auto [key_iter, value_iter] = get_iter(rhs.keys[i]);
+      *value_iter += rhs.values[i];
+    }
+    return *this;
+  }
+
   event_counter<key_type>& operator-=(const event_counter<key_type>& rhs)
   {
     std::transform(std::begin(values), std::end(values), std::cbegin(keys), std::begin(values),
@@ -110,6 +132,198 @@ public:
     return lhs;
   }
 };
+
+/**
+ * An event counter for tuple keys whose leading elements have ranges known at compile time.
+ *
+ * Each of the leading elements of the key is an enumeration or an integer, and Extents gives the number of values it can take. The
+ * last element, usually the cpu, is not bounded. The counter keeps one dense row for each value of the last element that it has seen,
+ * so an increment is a short search over the rows and a single add. The interface matches event_counter.
+ */
+template <typename Key, std::size_t... Extents>
+class dense_event_counter
+{
+public:
+  using key_type = std::remove_cv_t<Key>;
+  using value_type = long;
+
+private:
+  static constexpr std::size_t row_dims = sizeof...(Extents);
+  static_assert(std::tuple_size_v<key_type> == row_dims + 1, "Every key element but the last must have an extent");
+
+  using row_id_type = std::remove_cv_t<std::tuple_element_t<row_dims, key_type>>;
+  static constexpr std::array<std::size_t, row_dims> extents{Extents...};
+  static constexpr std::size_t row_size = (std::size_t{1} * ... * Extents);
+
+  struct row {
+    row_id_type id;
+    std::array<value_type, row_size> values{};
+    std::bitset<row_size> allocated{};
+  };
+
+  std::vector<row> rows{};
+
+  template <typename T>
+  static constexpr std::size_t element_index(T elem)
+  {
+    if constexpr (std::is_enum_v<T>) {
+      return static_cast<std::size_t>(champsim::to_underlying(elem));
+    } else {
+      return static_cast<std::size_t>(elem);
+    }
+  }
+
+  template <std::size_t... Is>
+  static constexpr std::size_t flat_index(const key_type& key, std::index_sequence<Is...>)
+  {
+    std::size_t idx = 0;
+    ((assert(element_index(std::get<Is>(key)) < extents[Is]), idx = idx * extents[Is] + element_index(std::get<Is>(key))), ...);
+    return idx;
+  }
+
+  static constexpr std::size_t flat_index(const key_type& key) { return flat_index(key, std::make_index_sequence<row_dims>{}); }
+
+  template <std::size_t... Is>
+  static key_type key_at(row_id_type id, std::size_t idx, std::index_sequence<Is...>)
+  {
+    std::array<std::size_t, row_dims> elems{};
+    for (std::size_t i = row_dims; i > 0; --i) {
+      elems[i - 1] = idx % extents[i - 1];
+      idx /= extents[i - 1];
+    }
+    return key_type{static_cast<std::tuple_element_t<Is, key_type>>(elems[Is])..., id};
+  }
+
+  [[nodiscard]] const row* find_row(row_id_type id) const
+  {
+    auto found = std::find_if(std::begin(rows), std::end(rows), [id](const auto& r) { return r.id == id; });
+    return found == std::end(rows) ? nullptr : &*found;
+  }
+
+  row& get_row(row_id_type id)
+  {
+    if (auto found = std::find_if(std::begin(rows), std::end(rows), [id](const auto& r) { return r.id == id; }); found != std::end(rows)) {
+      return *found;
+    }
+    auto pos = std::find_if(std::begin(rows), std::end(rows), [id](const auto& r) { return id < r.id; });
+    return *rows.insert(pos, row{id});
+  }
+
+public:
+  void allocate(key_type key) { get_row(std::get<row_dims>(key)).allocated.set(flat_index(key)); }
+
+  void deallocate(key_type key)
+  {
+    auto& r = get_row(std::get<row_dims>(key));
+    auto idx = flat_index(key);
+    r.values[idx] = value_type{};
+    r.allocated.reset(idx);
+  }
+
+  void increment(key_type key)
+  {
+    auto& r = get_row(std::get<row_dims>(key));
+    auto idx = flat_index(key);
+    ++r.values[idx];
+    r.allocated.set(idx);
+  }
+
+  void set(key_type key, value_type val)
+  {
+    auto& r = get_row(std::get<row_dims>(key));
+    auto idx = flat_index(key);
+    r.values[idx] = val;
+    r.allocated.set(idx);
+  }
+
+  auto at(key_type key) const
+  {
+    const auto* r = find_row(std::get<row_dims>(key));
+    assert(r != nullptr);
+    return r->values[flat_index(key)];
+  }
+
+  auto value_or(key_type key, value_type val) const
+  {
+    const auto* r = find_row(std::get<row_dims>(key));
+    if (r == nullptr || !r->allocated.test(flat_index(key))) {
+      return val;
+    }
+    return r->values[flat_index(key)];
+  }
+
+  auto total() const
+  {
+    return std::accumulate(std::begin(rows), std::end(rows), value_type{},
+                           [](auto acc, const auto& r) { return std::accumulate(std::begin(r.values), std::end(r.values), acc); });
+  }
+
+  std::vector<key_type> get_keys() const
+  {
+    std::vector<key_type> keys{};
+    for (const auto& r : rows) {
+      for (std::size_t idx = 0; idx < row_size; ++idx) {
+        if (r.allocated.test(idx)) {
+          keys.push_back(key_at(r.id, idx, std::make_index_sequence<row_dims>{}));
+        }
+      }
+    }
+    std::sort(std::begin(keys), std::end(keys));
+    return keys;
+  }
+
+  dense_event_counter& operator+=(const dense_event_counter& rhs)
+  {
+    for (auto& r : rows) {
+      if (const auto* other = rhs.find_row(r.id); other != nullptr) {
+        for (std::size_t idx = 0; idx < row_size; ++idx) {
+          r.values[idx] += r.allocated.test(idx) ? other->values[idx] : value_type{};
+        }
+      }
+    }
+    return *this;
+  }
+
+  friend auto operator+(dense_event_counter lhs, const dense_event_counter& rhs)
+  {
+    lhs += rhs;
+    return lhs;
+  }
+
+  /**
+   * Add the counts of another counter, allocating the keys and rows that only it has seen.
+   * Unlike operator+=, which adds only into keys that this counter has already seen.
+   */
+  dense_event_counter& merge(const dense_event_counter& rhs)
+  {
+    for (const auto& other : rhs.rows) {
+      auto& r = get_row(other.id);
+      for (std::size_t idx = 0; idx < row_size; ++idx) {
+        r.values[idx] += other.values[idx];
+      }
+      r.allocated |= other.allocated;
+    }
+    return *this;
+  }
+
+  dense_event_counter& operator-=(const dense_event_counter& rhs)
+  {
+    for (auto& r : rows) {
+      if (const auto* other = rhs.find_row(r.id); other != nullptr) {
+        for (std::size_t idx = 0; idx < row_size; ++idx) {
+          r.values[idx] -= r.allocated.test(idx) ? other->values[idx] : value_type{};
+        }
+      }
+    }
+    return *this;
+  }
+
+  friend auto operator-(dense_event_counter lhs, const dense_event_counter& rhs)
+  {
+    lhs -= rhs;
+    return lhs;
+  }
+};
 } // namespace champsim::stats
 
 #endif
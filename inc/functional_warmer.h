@@ -0,0 +1,53 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FUNCTIONAL_WARMER_H
+#define FUNCTIONAL_WARMER_H
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "channel.h"
+
+class CACHE;
+class PageTableWalker;
+
+namespace champsim
+{
+struct environment;
+
+/**
+ * Routes memory requests through the hierarchy without a timing model.
+ *
+ * Each request is handled to completion by the element that consumes its channel, which may in turn send requests to the elements below
+ * it. Caches and page table walkers update their tags, replacement state, and prefetchers as they would for a timed request, but no
+ * packet waits in a queue. Requests to a channel that no cache or page table walker consumes, such as those to DRAM, complete immediately.
+ */
+class functional_warmer
+{
+  std::unordered_map<const channel*, std::reference_wrapper<CACHE>> caches{};
+  std::unordered_map<const channel*, std::reference_wrapper<PageTableWalker>> walkers{};
+
+public:
+  explicit functional_warmer(environment& env);
+  functional_warmer(const std::vector<std::reference_wrapper<CACHE>>& cache_view, const std::vector<std::reference_wrapper<PageTableWalker>>& ptw_view);
+
+  channel::response_type access(const channel* ch, const channel::request_type& packet);
+};
+} // namespace champsim
+
+#endif
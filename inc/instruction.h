@@ -21,6 +21,7 @@
 #include <array>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <string_view>
 #include <vector>
@@ -31,6 +32,7 @@
 #include "chrono.h"
 #include "trace_instruction.h"
 #include "cheri.h"
+#include "util/inline_vector.h"
 
 // branch types
 enum branch_type {
@@ -93,6 +95,29 @@ struct program_ordered {
    * Return a functor that tests whether an instruction precededes the given instruction.
    */
   static auto precedes(const T& instr) { return precedes(instr.instr_id); }
+
+  /**
+   * Find the element with the given ID in a range that is in program order, or return the end of the range if there is none.
+   * The IDs of a core's instructions are consecutive, so the element is usually at its ID's offset from the first ID. If the range has
+   * gaps, it is bisected instead.
+   */
+  template <typename It>
+  static It find_id(It begin, It end, id_type id)
+  {
+    if (begin == end) {
+      return end;
+    }
+
+    if (const auto offset = id - begin->instr_id; id >= begin->instr_id && offset < static_cast<id_type>(std::distance(begin, end))) {
+      auto guess = std::next(begin, static_cast<typename std::iterator_traits<It>::difference_type>(offset));
+      if (guess->instr_id == id) {
+        return guess;
+      }
+    }
+
+    auto found = std::partition_point(begin, end, precedes(id));
+    return (found != end && found->instr_id == id) ? found : end;
+  }
 };
 } // namespace champsim
 
@@ -127,11 +152,18 @@ struct ooo_model_instr : champsim::program_ordered<ooo_model_instr> {
   unsigned completed_mem_ops = 0;
   int num_reg_dependent = 0;
 
-  std::vector<PHYSICAL_REGISTER_ID> destination_registers = {}; // output registers
-  std::vector<PHYSICAL_REGISTER_ID> source_registers = {};      // input registers
+  // Every trace format bounds its operands, so these are stored inline rather than allocated
+  constexpr static std::size_t max_destinations = std::max(NUM_INSTR_DESTINATIONS, NUM_INSTR_DESTINATIONS_SPARC);
+  constexpr static std::size_t max_sources = NUM_INSTR_SOURCES;
+
+  champsim::inline_vector<PHYSICAL_REGISTER_ID, max_destinations> destination_registers = {}; // output registers
+  champsim::inline_vector<PHYSICAL_REGISTER_ID, max_sources> source_registers = {};           // input registers
+
+  champsim::inline_vector<champsim::address, max_destinations> destination_memory = {};
+  champsim::inline_vector<champsim::address, max_sources> source_memory = {};
 
-  std::vector<champsim::address> destination_memory = {};
-  std::vector<champsim::address> source_memory = {};
+  // the load queue slots allocated to this instruction's source memory operands
+  champsim::inline_vector<std::size_t, max_sources> lq_slots = {};
 
   // these are indices of instructions in the ROB that depend on me
   std::vector<std::reference_wrapper<ooo_model_instr>> registers_instrs_depend_on_me;
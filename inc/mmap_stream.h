@@ -0,0 +1,66 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MMAP_STREAM_H
+#define MMAP_STREAM_H
+
+#include <cstddef>
+#include <ios>
+#include <string>
+#include <utility>
+
+namespace champsim
+{
+/**
+ * An input stream over a memory-mapped file.
+ *
+ * In addition to the read() interface of the other trace streams, read_in_place() returns a range of the mapping itself,
+ * so that a reader can decode records without copying them into an intermediate buffer.
+ * The mapping is advised for sequential access, and for transparent huge pages where the kernel supports them for files.
+ */
+class mmap_istream
+{
+  const char* begin_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t offset_ = 0;
+  std::streamsize gcount_ = 0;
+  bool eof_ = false;
+
+  void unmap();
+
+public:
+  explicit mmap_istream(const std::string& fname);
+  ~mmap_istream() { unmap(); }
+
+  mmap_istream(const mmap_istream&) = delete;
+  mmap_istream& operator=(const mmap_istream&) = delete;
+  mmap_istream(mmap_istream&& other) noexcept;
+  mmap_istream& operator=(mmap_istream&& other) noexcept;
+
+  /**
+   * Advance by up to count bytes, returning the range of the mapping that was passed over.
+   * The range is valid for the lifetime of this stream.
+   */
+  std::pair<const char*, const char*> read_in_place(std::size_t count);
+
+  mmap_istream& read(char* s, std::streamsize count);
+
+  [[nodiscard]] bool eof() const { return eof_; }
+  [[nodiscard]] std::streamsize gcount() const { return gcount_; }
+};
+} // namespace champsim
+
+#endif
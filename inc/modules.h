@@ -18,8 +18,11 @@
 #define MODULES_H
 
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "access_type.h"
 #include "address.h"
@@ -31,6 +34,17 @@ class O3_CPU;
 namespace champsim::modules
 {
 inline constexpr bool warn_if_any_missing = true;
+
+/**
+ * The names of the checkpoint sections of a module model's modules, in order.
+ * Each module uses the name it was configured with, or its position if the builder was not given a name for it.
+ */
+std::vector<std::string> section_names(std::vector<std::string> configured, std::size_t count);
+
+/**
+ * Report that a module cannot restore its state from a checkpoint, and so starts cold.
+ */
+void warn_no_load_state(std::string_view kind, std::string_view name);
 template <typename T>
 [[deprecated]] void does_not_have()
 {
@@ -61,6 +75,16 @@ struct branch_predictor : public bound_to<O3_CPU> {
   template <typename, typename...>
   static auto predict_branch_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto save_state_member_impl(int) -> decltype(std::declval<T>().branch_predictor_save_state(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto save_state_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto load_state_member_impl(int) -> decltype(std::declval<T>().branch_predictor_load_state(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto load_state_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_initialize = decltype(initialize_member_impl<T, Args...>(0))::value;
 
@@ -69,6 +93,12 @@ struct branch_predictor : public bound_to<O3_CPU> {
 
   template <typename T, typename... Args>
   constexpr static bool has_predict_branch = decltype(predict_branch_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_save_state = decltype(save_state_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_load_state = decltype(load_state_member_impl<T, Args...>(0))::value;
 };
 
 struct btb : public bound_to<O3_CPU> {
@@ -89,6 +119,16 @@ struct btb : public bound_to<O3_CPU> {
   template <typename, typename...>
   static auto predict_branch_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto save_state_member_impl(int) -> decltype(std::declval<T>().btb_save_state(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto save_state_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto load_state_member_impl(int) -> decltype(std::declval<T>().btb_load_state(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto load_state_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_initialize = decltype(initialize_member_impl<T, Args...>(0))::value;
 
@@ -97,6 +137,12 @@ struct btb : public bound_to<O3_CPU> {
 
   template <typename T, typename... Args>
   constexpr static bool has_btb_prediction = decltype(predict_branch_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_save_state = decltype(save_state_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_load_state = decltype(load_state_member_impl<T, Args...>(0))::value;
 };
 
 struct prefetcher : public bound_to<CACHE> {
@@ -138,6 +184,16 @@ struct prefetcher : public bound_to<CACHE> {
   template <typename, typename...>
   static auto branch_operate_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto save_state_member_impl(int) -> decltype(std::declval<T>().prefetcher_save_state(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto save_state_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto load_state_member_impl(int) -> decltype(std::declval<T>().prefetcher_load_state(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto load_state_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_initialize = decltype(initiailize_memory_impl<T, Args...>(0))::value;
 
@@ -155,6 +211,12 @@ struct prefetcher : public bound_to<CACHE> {
 
   template <typename T, typename... Args>
   constexpr static bool has_branch_operate = decltype(branch_operate_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_save_state = decltype(save_state_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_load_state = decltype(load_state_member_impl<T, Args...>(0))::value;
 };
 
 struct replacement : public bound_to<CACHE> {
@@ -185,6 +247,16 @@ struct replacement : public bound_to<CACHE> {
   template <typename, typename...>
   static auto final_stats_member_impl(long) -> std::false_type;
 
+  template <typename T, typename... Args>
+  static auto save_state_member_impl(int) -> decltype(std::declval<T>().replacement_save_state(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto save_state_member_impl(long) -> std::false_type;
+
+  template <typename T, typename... Args>
+  static auto load_state_member_impl(int) -> decltype(std::declval<T>().replacement_load_state(std::declval<Args>()...), std::true_type{});
+  template <typename, typename...>
+  static auto load_state_member_impl(long) -> std::false_type;
+
   template <typename T, typename... Args>
   constexpr static bool has_initialize = decltype(initialize_member_impl<T, Args...>(0))::value;
 
@@ -199,6 +271,12 @@ struct replacement : public bound_to<CACHE> {
 
   template <typename T, typename... Args>
   constexpr static bool has_final_stats = decltype(final_stats_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_save_state = decltype(save_state_member_impl<T, Args...>(0))::value;
+
+  template <typename T, typename... Args>
+  constexpr static bool has_load_state = decltype(load_state_member_impl<T, Args...>(0))::value;
 };
 } // namespace champsim::modules
 
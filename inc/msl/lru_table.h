@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -52,6 +53,22 @@ struct table_tagger {
   auto operator()(const T& t) const { return t.tag(); }
 };
 
+struct write_whole {
+  template <typename Writer, typename T>
+  void operator()(Writer& out, const T& value) const
+  {
+    out.write(value);
+  }
+};
+
+struct read_whole {
+  template <typename Reader, typename T>
+  void operator()(Reader& in, T& value) const
+  {
+    in.read(value);
+  }
+};
+
 template <class T, class U>
 constexpr bool cmp_equal(T t, U u) noexcept
 {
@@ -190,6 +207,46 @@ public:
     return(block);
   }
 
+  /**
+   * Write the contents and the recency order of the table, with a writer that accepts trivially copyable values.
+   * Each entry is written by write_value(out, entry). By default the entry is written whole, so an entry with padding should instead be
+   * given a function that writes its fields.
+   */
+  template <typename Writer, typename F = detail::write_whole>
+  void save_state(Writer& out, F write_value = {}) const
+  {
+    out.write(access_count);
+    out.write(std::size(block));
+    for (const auto& b : block) {
+      out.write(b.last_used);
+      write_value(out, b.data);
+    }
+  }
+
+  /**
+   * Read the contents written by save_state(), with the counterpart of the function that wrote each entry.
+   * The saved table must have the same number of entries as this one.
+   */
+  template <typename Reader, typename F = detail::read_whole>
+  void load_state(Reader& in, F read_value = {})
+  {
+    uint64_t saved_access_count{};
+    std::size_t saved_size{};
+    in.read(saved_access_count);
+    in.read(saved_size);
+    if (saved_size != std::size(block))
+      throw std::range_error{"Saved table has " + std::to_string(saved_size) + " entries, not " + std::to_string(std::size(block))};
+
+    block_vec_type saved_block(std::size(block));
+    for (auto& b : saved_block) {
+      in.read(b.last_used);
+      read_value(in, b.data);
+    }
+
+    access_count = saved_access_count;
+    block = std::move(saved_block);
+  }
+
   lru_table(std::size_t sets, std::size_t ways, SetProj set_proj, TagProj tag_proj)
       : set_projection(set_proj), tag_projection(tag_proj), NUM_SET(static_cast<diff_type>(sets)), NUM_WAY(static_cast<diff_type>(ways)), block(sets * ways)
   {
@@ -25,27 +25,36 @@
 #include <array>
 #include <bitset>
 #include <deque>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <queue>
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "bandwidth.h"
 #include "champsim.h"
 #include "channel.h"
+#include "checkpoint.h"
 #include "core_builder.h"
 #include "core_stats.h"
 #include "instruction.h"
 #include "modules.h"
 #include "operable.h"
 #include "register_allocator.h"
+#include "util/circular_buffer.h"
 #include "util/lru_table.h"
 #include "util/to_underlying.h"
 
 class CACHE;
+
+namespace champsim
+{
+class functional_warmer;
+}
 class CacheBus
 {
   using channel_type = champsim::channel;
@@ -57,10 +66,16 @@ class CacheBus
 
   friend class O3_CPU;
 
+  [[nodiscard]] request_type read_packet(request_type packet) const;
+  [[nodiscard]] request_type write_packet(request_type packet) const;
+
 public:
   CacheBus(uint32_t cpu_idx, champsim::channel* ll) : lower_level(ll), cpu(cpu_idx) {}
   bool issue_read(request_type packet);
   bool issue_write(request_type packet);
+
+  response_type warm_read(request_type packet, champsim::functional_warmer& warmer) const;
+  void warm_write(request_type packet, champsim::functional_warmer& warmer) const;
 };
 
 struct LSQ_ENTRY : champsim::program_ordered<LSQ_ENTRY> {
@@ -83,7 +98,7 @@ struct LSQ_ENTRY : champsim::program_ordered<LSQ_ENTRY> {
             champsim::capability auth, champsim::capability transferred);
             
   void finish(ooo_model_instr& rob_entry) const;
-  void finish(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end) const;
+  void finish(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end) const;
 };
 
 // cpu
@@ -118,14 +133,25 @@ public:
   dib_type DIB;
 
   // reorder buffer, load/store queue, register file
-  std::deque<ooo_model_instr> IFETCH_BUFFER;
-  std::deque<ooo_model_instr> DISPATCH_BUFFER;
-  std::deque<ooo_model_instr> DECODE_BUFFER;
-  std::deque<ooo_model_instr> ROB;
-  std::deque<ooo_model_instr> DIB_HIT_BUFFER;
+  // The pipeline buffers are allocated once at their configured sizes, so that entries never move while they are in flight
+  using instr_buffer_type = champsim::circular_buffer<ooo_model_instr>;
+  instr_buffer_type IFETCH_BUFFER;
+  instr_buffer_type DISPATCH_BUFFER;
+  instr_buffer_type DECODE_BUFFER;
+  instr_buffer_type ROB;
+  instr_buffer_type DIB_HIT_BUFFER;
 
   std::vector<std::optional<LSQ_ENTRY>> LQ;
+  std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> LQ_free_slots; // lowest index first
+  std::unordered_multimap<uint64_t, std::size_t> LQ_issued_slots;                          // by the block number of the load
   std::deque<LSQ_ENTRY> SQ;
+  std::unordered_map<uint64_t, LSQ_ENTRY*> SQ_youngest; // the youngest store to each address, which loads forward from
+
+  // Scheduled instructions whose source registers are all valid, as a heap with the oldest on top
+  std::vector<std::reference_wrapper<ooo_model_instr>> ready_to_execute;
+  std::vector<std::reference_wrapper<ooo_model_instr>> not_yet_ready; // scratch space for execute_instruction()
+  std::vector<std::reference_wrapper<ooo_model_instr>> woken_instrs;  // scratch space for do_complete_execution()
+  long num_scheduled_unexecuted = 0;
 
   // Constants
   const std::size_t IFETCH_BUFFER_SIZE, DISPATCH_BUFFER_SIZE, DECODE_BUFFER_SIZE, REGISTER_FILE_SIZE, ROB_SIZE, SQ_SIZE, DIB_HIT_BUFFER_SIZE;
@@ -170,16 +196,25 @@ public:
   long handle_memory_return();
   long retire_rob();
 
+  // Pass the instruction through the branch predictor, the DIB, and the caches at once, without the timing model
+  void warm_instruction(ooo_model_instr instr, champsim::functional_warmer& warmer);
+
+  // Save or restore the DIB and the module state. Instructions in the pipeline are not part of the state.
+  void save_state(champsim::checkpoint_writer& out) const;
+  void load_state(champsim::checkpoint_reader& in);
+
   bool do_init_instruction(ooo_model_instr& instr);
   bool do_predict_branch(ooo_model_instr& instr);
   void do_check_dib(ooo_model_instr& instr);
-  bool do_fetch_instruction(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end);
+  bool do_fetch_instruction(instr_buffer_type::iterator begin, instr_buffer_type::iterator end);
   void do_dib_update(const ooo_model_instr& instr);
   void do_scheduling(ooo_model_instr& instr);
   void do_execution(ooo_model_instr& instr);
   void do_memory_scheduling(ooo_model_instr& instr);
   void do_complete_execution(ooo_model_instr& instr);
   void do_sq_forward_to_lq(LSQ_ENTRY& sq_entry, LSQ_ENTRY& lq_entry);
+  void do_wakeup(ooo_model_instr& instr);
+  void release_lq_entry(std::optional<LSQ_ENTRY>& lq_entry);
 
   void do_finish_store(const LSQ_ENTRY& sq_entry);
   bool do_complete_store(const LSQ_ENTRY& sq_entry);
@@ -200,6 +235,8 @@ public:
     virtual void impl_initialize_branch_predictor() = 0;
     virtual void impl_last_branch_result(champsim::address ip, champsim::address target, bool taken, uint8_t branch_type) = 0;
     virtual bool impl_predict_branch(champsim::address ip, champsim::address predicted_target, bool always_taken, uint8_t branch_type) = 0;
+    virtual void impl_branch_predictor_save_state(champsim::checkpoint_writer& out) = 0;
+    virtual void impl_branch_predictor_load_state(champsim::checkpoint_reader& in) = 0;
   };
 
   struct btb_module_concept {
@@ -208,26 +245,42 @@ public:
     virtual void impl_initialize_btb() = 0;
     virtual void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) = 0;
     virtual std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) = 0;
+    virtual void impl_btb_save_state(champsim::checkpoint_writer& out) = 0;
+    virtual void impl_btb_load_state(champsim::checkpoint_reader& in) = 0;
   };
 
   template <typename... Bs>
   struct branch_module_model final : branch_module_concept {
     std::tuple<Bs...> intern_;
-    explicit branch_module_model(O3_CPU* cpu) : intern_(Bs{cpu}...) { (void)cpu; /* silence -Wunused-but-set-parameter when sizeof...(Bs) == 0 */ }
+    std::vector<std::string> names_;
+    branch_module_model(O3_CPU* cpu, std::vector<std::string> names)
+        : intern_(Bs{cpu}...), names_(champsim::modules::section_names(std::move(names), sizeof...(Bs)))
+    {
+      (void)cpu; /* silence -Wunused-but-set-parameter when sizeof...(Bs) == 0 */
+    }
 
     void impl_initialize_branch_predictor() final;
     void impl_last_branch_result(champsim::address ip, champsim::address target, bool taken, uint8_t branch_type) final;
     [[nodiscard]] bool impl_predict_branch(champsim::address ip, champsim::address predicted_target, bool always_taken, uint8_t branch_type) final;
+    void impl_branch_predictor_save_state(champsim::checkpoint_writer& out) final;
+    void impl_branch_predictor_load_state(champsim::checkpoint_reader& in) final;
   };
 
   template <typename... Ts>
   struct btb_module_model final : btb_module_concept {
     std::tuple<Ts...> intern_;
-    explicit btb_module_model(O3_CPU* cpu) : intern_(Ts{cpu}...) { (void)cpu; /* silence -Wunused-but-set-parameter when sizeof...(Ts) == 0 */ }
+    std::vector<std::string> names_;
+    btb_module_model(O3_CPU* cpu, std::vector<std::string> names)
+        : intern_(Ts{cpu}...), names_(champsim::modules::section_names(std::move(names), sizeof...(Ts)))
+    {
+      (void)cpu; /* silence -Wunused-but-set-parameter when sizeof...(Ts) == 0 */
+    }
 
     void impl_initialize_btb() final;
     void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) final;
     [[nodiscard]] std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) final;
+    void impl_btb_save_state(champsim::checkpoint_writer& out) final;
+    void impl_btb_load_state(champsim::checkpoint_reader& in) final;
   };
 
   std::unique_ptr<branch_module_concept> branch_module_pimpl;
@@ -237,17 +290,22 @@ public:
   void impl_initialize_branch_predictor() const;
   void impl_last_branch_result(champsim::address ip, champsim::address target, bool taken, uint8_t branch_type) const;
   [[nodiscard]] bool impl_predict_branch(champsim::address ip, champsim::address predicted_target, bool always_taken, uint8_t branch_type) const;
+  void impl_branch_predictor_save_state(champsim::checkpoint_writer& out) const;
+  void impl_branch_predictor_load_state(champsim::checkpoint_reader& in) const;
 
   void impl_initialize_btb() const;
   void impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) const;
   [[nodiscard]] std::pair<champsim::address, bool> impl_btb_prediction(champsim::address ip, uint8_t branch_type) const;
+  void impl_btb_save_state(champsim::checkpoint_writer& out) const;
+  void impl_btb_load_state(champsim::checkpoint_reader& in) const;
   // NOLINTEND(readability-make-member-function-const)
 
   template <typename... Bs, typename... Ts>
   explicit O3_CPU(champsim::core_builder<champsim::core_builder_module_type_holder<Bs...>, champsim::core_builder_module_type_holder<Ts...>> b)
       : champsim::operable(b.m_clock_period), cpu(b.m_cpu),
         DIB(b.m_dib_set, b.m_dib_way, {champsim::data::bits{champsim::lg2(b.m_dib_window)}}, {champsim::data::bits{champsim::lg2(b.m_dib_window)}}),
-        LQ(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size), DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
+        IFETCH_BUFFER(b.m_ifetch_buffer_size), DISPATCH_BUFFER(b.m_dispatch_buffer_size), DECODE_BUFFER(b.m_decode_buffer_size), ROB(b.m_rob_size),
+        DIB_HIT_BUFFER(b.m_dib_hit_buffer_size), LQ(b.m_lq_size), IFETCH_BUFFER_SIZE(b.m_ifetch_buffer_size), DISPATCH_BUFFER_SIZE(b.m_dispatch_buffer_size), DECODE_BUFFER_SIZE(b.m_decode_buffer_size),
         REGISTER_FILE_SIZE(b.m_register_file_size), ROB_SIZE(b.m_rob_size), SQ_SIZE(b.m_sq_size), DIB_HIT_BUFFER_SIZE(b.m_dib_hit_buffer_size),
         FETCH_WIDTH(b.m_fetch_width), DECODE_WIDTH(b.m_decode_width), DISPATCH_WIDTH(b.m_dispatch_width), SCHEDULER_SIZE(b.m_schedule_width),
         EXEC_WIDTH(b.m_execute_width), DIB_INORDER_WIDTH(b.m_dib_inorder_width), LQ_WIDTH(b.m_lq_width), SQ_WIDTH(b.m_sq_width), RETIRE_WIDTH(b.m_retire_width),
@@ -255,9 +313,12 @@ public:
         DECODE_LATENCY(b.m_decode_latency * b.m_clock_period), SCHEDULING_LATENCY(b.m_schedule_latency * b.m_clock_period),
         EXEC_LATENCY(b.m_execute_latency * b.m_clock_period), DIB_HIT_LATENCY(b.m_dib_hit_latency * b.m_clock_period), L1I_BANDWIDTH(b.m_l1i_bw),
         L1D_BANDWIDTH(b.m_l1d_bw), IN_QUEUE_SIZE(2 * champsim::to_underlying(b.m_fetch_width)), L1I_bus(b.m_cpu, b.m_fetch_queues),
-        L1D_bus(b.m_cpu, b.m_data_queues), l1i(b.m_l1i), branch_module_pimpl(std::make_unique<branch_module_model<Bs...>>(this)),
-        btb_module_pimpl(std::make_unique<btb_module_model<Ts...>>(this))
+        L1D_bus(b.m_cpu, b.m_data_queues), l1i(b.m_l1i), branch_module_pimpl(std::make_unique<branch_module_model<Bs...>>(this, b.m_branch_predictor_names)),
+        btb_module_pimpl(std::make_unique<btb_module_model<Ts...>>(this, b.m_btb_names))
   {
+    for (std::size_t i = 0; i < std::size(LQ); ++i) {
+      LQ_free_slots.push(i);
+    }
   }
 };
 
@@ -318,6 +379,40 @@ bool O3_CPU::branch_module_model<Bs...>::impl_predict_branch(champsim::address i
   return return_type{};
 }
 
+// Each module's state is kept in a section under its configured name, so that a module configured in its place does not read it
+template <typename... Bs>
+void O3_CPU::branch_module_model<Bs...>::impl_branch_predictor_save_state(champsim::checkpoint_writer& out)
+{
+  [[maybe_unused]] auto name = std::cbegin(names_);
+  [[maybe_unused]] auto process_one = [&](auto& b) {
+    using namespace champsim::modules;
+    if constexpr (branch_predictor::has_save_state<decltype(b), champsim::checkpoint_writer&>)
+      out.write_section(*name, [&](auto& section) { b.branch_predictor_save_state(section); });
+    ++name;
+  };
+
+  std::apply([&](auto&... b) { (..., process_one(b)); }, intern_);
+}
+
+template <typename... Bs>
+void O3_CPU::branch_module_model<Bs...>::impl_branch_predictor_load_state(champsim::checkpoint_reader& in)
+{
+  [[maybe_unused]] auto sections = in.read_sections();
+  [[maybe_unused]] auto name = std::cbegin(names_);
+  [[maybe_unused]] auto process_one = [&](auto& b) {
+    using namespace champsim::modules;
+    if constexpr (branch_predictor::has_load_state<decltype(b), champsim::checkpoint_reader&>) {
+      if (auto found = sections.find(*name); found != std::end(sections))
+        b.branch_predictor_load_state(found->second);
+    } else {
+      warn_no_load_state("branch predictor", *name);
+    }
+    ++name;
+  };
+
+  std::apply([&](auto&... b) { (..., process_one(b)); }, intern_);
+}
+
 template <typename... Ts>
 void O3_CPU::btb_module_model<Ts...>::impl_initialize_btb()
 {
@@ -376,6 +471,39 @@ std::pair<champsim::address, bool> O3_CPU::btb_module_model<Ts...>::impl_btb_pre
   return return_type{};
 }
 
+template <typename... Ts>
+void O3_CPU::btb_module_model<Ts...>::impl_btb_save_state(champsim::checkpoint_writer& out)
+{
+  [[maybe_unused]] auto name = std::cbegin(names_);
+  [[maybe_unused]] auto process_one = [&](auto& t) {
+    using namespace champsim::modules;
+    if constexpr (btb::has_save_state<decltype(t), champsim::checkpoint_writer&>)
+      out.write_section(*name, [&](auto& section) { t.btb_save_state(section); });
+    ++name;
+  };
+
+  std::apply([&](auto&... t) { (..., process_one(t)); }, intern_);
+}
+
+template <typename... Ts>
+void O3_CPU::btb_module_model<Ts...>::impl_btb_load_state(champsim::checkpoint_reader& in)
+{
+  [[maybe_unused]] auto sections = in.read_sections();
+  [[maybe_unused]] auto name = std::cbegin(names_);
+  [[maybe_unused]] auto process_one = [&](auto& t) {
+    using namespace champsim::modules;
+    if constexpr (btb::has_load_state<decltype(t), champsim::checkpoint_reader&>) {
+      if (auto found = sections.find(*name); found != std::end(sections))
+        t.btb_load_state(found->second);
+    } else {
+      warn_no_load_state("btb", *name);
+    }
+    ++name;
+  };
+
+  std::apply([&](auto&... t) { (..., process_one(t)); }, intern_);
+}
+
 #ifdef SET_ASIDE_CHAMPSIM_MODULE
 #undef SET_ASIDE_CHAMPSIM_MODULE
 #define CHAMPSIM_MODULE
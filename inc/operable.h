@@ -17,12 +17,22 @@
 #ifndef OPERABLE_H
 #define OPERABLE_H
 
+#include <cstddef>
+
 #include "chrono.h"
 
 namespace champsim
 {
+class scheduler;
+
 class operable
 {
+  friend class scheduler;
+
+  // Set while this operable sleeps in a scheduler's calendar
+  scheduler* sleeping_in = nullptr;
+  std::size_t sleeping_order = 0;
+
 public:
   champsim::chrono::picoseconds clock_period{};
   champsim::chrono::clock::time_point current_time{};
@@ -41,6 +51,32 @@ public:
   virtual void end_phase(unsigned /*cpu index*/) {} // LCOV_EXCL_LINE
   virtual void print_deadlock() {}                  // LCOV_EXCL_LINE
 
+  /**
+   * Report whether operating at the current time would neither make progress nor change any state.
+   * Idle cycles only advance the current time, and the call to operate() is skipped.
+   * The default is conservative: an operable is never idle.
+   */
+  [[nodiscard]] virtual bool is_idle() const { return false; }
+  virtual void operate_idle(long /*cycles*/) {} // LCOV_EXCL_LINE
+
+  /**
+   * The earliest time at which this operable may stop being idle, if no other operable gives it work.
+   * Every cycle that would end before this time is idle, so a scheduler may put the operable to sleep until then.
+   * The default is conservative: the operable may have work in its next cycle.
+   */
+  [[nodiscard]] virtual champsim::chrono::clock::time_point next_wakeup() const { return current_time; }
+
+  /**
+   * Pass over the given number of idle cycles at once, as if each had been operated.
+   */
+  void skip_idle(long cycles);
+
+  /**
+   * Catch up on the cycles this operable slept through, if it is asleep, and return it to its scheduler's calendar.
+   * Anything that gives an operable work, other than the operable itself, must call this first.
+   */
+  void wake();
+
   [[deprecated]] uint64_t current_cycle() const;
 };
 
@@ -0,0 +1,53 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PAGE_PERMUTATION_H
+#define PAGE_PERMUTATION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace champsim
+{
+/**
+ * A seeded bijection over the indices [0, size), evaluated one index at a time in constant memory.
+ * The indices are permuted by a balanced Feistel network over the smallest even number of bits that covers them,
+ * and an index that lands outside the range is permuted again until it lands inside it.
+ * Without a seed, every index maps to itself.
+ */
+class page_permutation
+{
+public:
+  page_permutation() = default;
+  page_permutation(uint64_t size, std::optional<uint64_t> seed);
+
+  [[nodiscard]] uint64_t operator()(uint64_t index) const;
+  [[nodiscard]] uint64_t size() const { return num_indices; }
+
+private:
+  constexpr static std::size_t rounds = 4;
+
+  uint64_t num_indices = 0;
+  unsigned half_bits = 0;
+  std::optional<std::array<uint64_t, rounds>> keys{};
+
+  [[nodiscard]] uint64_t encrypt(uint64_t index) const;
+};
+} // namespace champsim
+
+#endif
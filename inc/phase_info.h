@@ -36,6 +36,14 @@ struct phase_info {
   long long length;
   std::vector<std::size_t> trace_index;
   std::vector<std::string> trace_names;
+  bool is_functional = false; // Warm the caches, TLBs, and predictors without the timing model
+  std::string load_checkpoint_name{}; // If set, restore the warmed state from this file before the phase begins
+  std::string save_checkpoint_name{}; // If set, write the warmed state to this file when the phase completes
+
+  // If the period is nonzero, each period of the phase is warmed functionally, except for a detailed warmup and a measured detailed window at its end
+  long long sample_period = 0;
+  long long sample_warmup = 0;
+  long long sample_window = 0;
 };
 
 struct phase_stats {
@@ -44,6 +52,9 @@ struct phase_stats {
   std::vector<O3_CPU::stats_type> roi_cpu_stats, sim_cpu_stats;
   std::vector<CACHE::stats_type> roi_cache_stats, sim_cache_stats;
   std::vector<DRAM_CHANNEL::stats_type> roi_dram_stats, sim_dram_stats;
+
+  // If the phase was sampled, the statistics above are summed over its windows, and these are each CPU's statistics in each window
+  std::vector<std::vector<O3_CPU::stats_type>> sample_cpu_stats{};
 };
 
 } // namespace champsim
@@ -0,0 +1,60 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFETCH_FILTER_H
+#define PREFETCH_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * Remembers the blocks of the prefetches a cache has issued recently, so that a prefetcher that requests the same block again does not
+ * spend tag-check bandwidth on it. The blocks are kept in a small set-associative table, and the blocks of a full set are replaced in
+ * turn. A block is forgotten when it is filled, since the cache itself then holds it.
+ */
+class prefetch_filter
+{
+public:
+  /**
+   * A filter of zero entries holds nothing. A filter larger than one set must fill a whole number of sets.
+   *
+   * \throws std::invalid_argument If the entries do not divide evenly into sets
+   */
+  explicit prefetch_filter(std::size_t entries);
+
+  [[nodiscard]] bool contains(uint64_t block) const;
+  void insert(uint64_t block);
+  void erase(uint64_t block);
+
+  [[nodiscard]] std::size_t size() const { return std::size(blocks); }
+
+private:
+  constexpr static uint64_t invalid_block = ~uint64_t{};
+  constexpr static std::size_t max_ways = 8;
+
+  std::size_t num_ways;
+  std::size_t num_sets;
+  std::vector<uint64_t> blocks;
+  std::vector<std::size_t> next_victim;
+
+  [[nodiscard]] std::size_t set_offset(uint64_t block) const;
+};
+} // namespace champsim
+
+#endif
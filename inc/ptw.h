@@ -26,12 +26,19 @@
 #include "address.h"
 #include "bandwidth.h"
 #include "channel.h"
+#include "checkpoint.h"
 #include "operable.h"
 #include "ptw_builder.h"
 #include "util/lru_table.h"
 #include "waitable.h"
 
 class VirtualMemory;
+
+namespace champsim
+{
+class functional_warmer;
+}
+
 class PageTableWalker : public champsim::operable
 {
   struct pscl_entry {
@@ -55,8 +62,8 @@ class PageTableWalker : public champsim::operable
     champsim::address v_address{};
     champsim::waitable<champsim::address> data{};
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::dependency_list instr_depend_on_me{};
+    std::vector<champsim::channel::response_queue*> to_return{};
 
     uint32_t pf_metadata = 0;
     uint32_t cpu = std::numeric_limits<uint32_t>::max();
@@ -73,8 +80,8 @@ class PageTableWalker : public champsim::operable
   std::deque<mshr_type> finished;
   std::deque<mshr_type> completed;
 
-  std::vector<channel_type*> upper_levels;
-  channel_type* lower_level;
+  mshr_type begin_walk(const request_type& pkt);
+  [[nodiscard]] static request_type step_request(const mshr_type& source);
 
   std::optional<mshr_type> handle_read(const request_type& pkt, channel_type* ul);
   std::optional<mshr_type> handle_fill(const mshr_type& fill_mshr);
@@ -83,6 +90,9 @@ class PageTableWalker : public champsim::operable
   void finish_packet(const response_type& packet);
 
 public:
+  std::vector<channel_type*> upper_levels;
+  channel_type* lower_level;
+
   const std::string NAME;
   const uint32_t MSHR_SIZE;
   champsim::bandwidth::maximum_type MAX_READ, MAX_FILL;
@@ -97,6 +107,13 @@ public:
 
   long operate() final;
 
+  // Walk the page table for the packet at once, filling the PSCLs, and return the translation
+  response_type warm_access(const request_type& pkt, champsim::functional_warmer& warmer);
+
+  // Save or restore the PSCLs. Walks in progress are not part of the state.
+  void save_state(champsim::checkpoint_writer& out) const;
+  void load_state(champsim::checkpoint_reader& in);
+
   void begin_phase() final;
   void print_deadlock() final;
 };
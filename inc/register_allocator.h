@@ -1,8 +1,10 @@
 #include <array>
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <optional>
 #include <queue>
+#include <vector>
 
 #ifndef REG_ALLOC_H
 #define REG_ALLOC_H
@@ -22,12 +24,14 @@ private:
   std::array<PHYSICAL_REGISTER_ID, std::numeric_limits<uint8_t>::max() + 1> frontend_RAT, backend_RAT;
   std::queue<PHYSICAL_REGISTER_ID> free_registers;
   std::vector<physical_register> physical_register_file;
+  std::vector<std::vector<std::reference_wrapper<ooo_model_instr>>> waiting_instrs; // indexed by physical register
 
 public:
   RegisterAllocator(size_t num_physical_registers);
   PHYSICAL_REGISTER_ID rename_dest_register(int16_t reg, champsim::program_ordered<ooo_model_instr>::id_type producer_id);
   PHYSICAL_REGISTER_ID rename_src_register(int16_t reg);
-  void complete_dest_register(PHYSICAL_REGISTER_ID physreg);
+  void add_waiting_instr(PHYSICAL_REGISTER_ID physreg, ooo_model_instr& instr);
+  void complete_dest_register(PHYSICAL_REGISTER_ID physreg, std::vector<std::reference_wrapper<ooo_model_instr>>& woken);
   void retire_dest_register(PHYSICAL_REGISTER_ID physreg);
   void free_register(PHYSICAL_REGISTER_ID physreg);
   bool isValid(PHYSICAL_REGISTER_ID physreg) const;
@@ -0,0 +1,66 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef REUSE_PROFILER_H
+#define REUSE_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * Measures the LRU stack distance of the accesses to blocks: the number of distinct other blocks accessed since the block was last
+ * accessed. A fully-associative LRU cache of N blocks hits exactly the accesses whose distance is less than N, so a histogram of the
+ * distances gives the miss ratio of every cache size from a single run.
+ *
+ * Only the blocks whose hash falls below a threshold are tracked, as in SHARDS (Waldspurger et al., FAST 2015). The distance among the
+ * sampled blocks, divided by the sampling rate, estimates the distance among all blocks. The distinct blocks between two accesses are
+ * counted with a Fenwick tree that marks the time of the last access to each sampled block.
+ */
+class reuse_profiler
+{
+public:
+  // Bucket 0 holds distances of 0, and bucket b > 0 holds distances in [2^(b-1), 2^b). The last bucket holds first accesses.
+  constexpr static std::size_t num_buckets = 40;
+  constexpr static std::size_t cold_bucket = num_buckets - 1;
+
+  explicit reuse_profiler(double sample_rate);
+
+  /**
+   * Record an access to the given block, and return the bucket of its distance, or nothing if the block is not sampled.
+   */
+  std::optional<std::size_t> access(uint64_t block);
+
+  [[nodiscard]] double sample_rate() const { return rate; }
+
+private:
+  double rate;
+  uint64_t threshold;
+  uint64_t now = 0;
+  std::unordered_map<uint64_t, uint64_t> last_access{};
+  std::vector<long> marks;
+
+  void mark(uint64_t time, long delta);
+  [[nodiscard]] long count_before(uint64_t time) const;
+  void compact();
+};
+} // namespace champsim
+
+#endif
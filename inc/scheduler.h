@@ -0,0 +1,138 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "chrono.h"
+#include "operable.h"
+
+namespace champsim
+{
+/**
+ * A persistent calendar of operables, ordered by the time at which each next needs to operate.
+ *
+ * Operables are woken in order of their current time, with ties broken by their position in the view the scheduler was built from.
+ * This is the same order in which the simulator has always operated them, but avoids rebuilding and sorting the view every cycle.
+ *
+ * When an operable reports that its next cycles are idle, it is put to sleep until its next wakeup, and leaves the calendar until then.
+ * An operable that is given work while it sleeps is woken early. Either way, it passes over the idle cycles it slept through at once,
+ * and rejoins the calendar where the serial order places it. Operables only sleep in serial simulation.
+ *
+ * Each operable may be assigned to a domain, which is the private slice of one core. Operables in different domains never touch the same state,
+ * so the scheduler can operate the domains on separate threads. Operables in the shared domain are always operated on the calling thread.
+ */
+class scheduler
+{
+public:
+  constexpr static std::size_t shared_domain = std::numeric_limits<std::size_t>::max();
+
+private:
+  struct event {
+    champsim::chrono::clock::time_point wakeup;
+    std::size_t order;
+    unsigned long generation;
+  };
+
+  struct worker_pool;
+
+  static bool later(const event& lhs, const event& rhs);
+
+  std::vector<std::reference_wrapper<operable>> operables;
+  std::vector<std::size_t> domains;
+  std::vector<event> calendar;
+  std::vector<std::vector<event>> domain_calendars;
+
+  // An operable that is woken early is given a new event. Its old event is left in the calendar, and is skipped because its generation is stale.
+  std::vector<unsigned long> generations;
+  constexpr static std::size_t none_operating = std::numeric_limits<std::size_t>::max();
+  std::size_t operating = none_operating;
+
+  champsim::chrono::clock::duration tick;
+  champsim::chrono::clock::time_point last_now{};
+  long quantum = 0;
+  std::unique_ptr<worker_pool> pool;
+
+  // Reused by every call to operate_lockstep() and operate_relaxed(), which the pool's jobs read
+  std::vector<event> woken;
+  std::vector<std::vector<std::size_t>> domain_work;
+  const champsim::chrono::clock* lockstep_clock = nullptr;
+  champsim::chrono::clock::time_point window_end{};
+
+  long operate_serial(const champsim::chrono::clock& clock);
+  long operate_lockstep(const champsim::chrono::clock& clock);
+  long operate_relaxed(const champsim::chrono::clock& clock);
+  long operate_window(std::vector<event>& events, champsim::chrono::clock::time_point now);
+
+  void schedule(std::size_t order);
+  void catch_up(std::size_t order, champsim::chrono::clock::time_point until);
+  [[nodiscard]] bool is_stale(const event& ev) const;
+
+public:
+  explicit scheduler(std::vector<std::reference_wrapper<operable>> ops);
+  scheduler(std::vector<std::reference_wrapper<operable>> ops, std::vector<std::size_t> op_domains);
+  ~scheduler();
+
+  scheduler(const scheduler&) = delete;
+  scheduler& operator=(const scheduler&) = delete;
+
+  /**
+   * Operate the private domains on one worker thread each.
+   *
+   * With a quantum of 1, the domains synchronize with the shared operables at every point where the serial order would pass between them,
+   * and the results are identical to serial simulation.
+   * With a larger quantum, each domain runs that many global ticks ahead before the shared operables catch up.
+   * A quantum of 0 returns to serial simulation.
+   * Operables in different private domains run at the same time, so they, and the modules they own, must not share mutable state.
+   */
+  void parallelize(long ticks);
+
+  /**
+   * The number of global ticks that should elapse between calls to operate_on().
+   */
+  [[nodiscard]] long ticks_per_call() const;
+
+  /**
+   * Wake every sleeping operable, and rebuild the calendar from the operables' current times.
+   * This must be called if any operable was operated outside of this scheduler, or before anything else inspects the operables' times.
+   */
+  void reset();
+
+  /**
+   * Wake the operable at the given position, which has been given work by the operable that is operating now.
+   * It passes over every idle cycle that the serial order places before the one in progress.
+   */
+  void wake(std::size_t order);
+
+  /**
+   * Operate every operable that is behind the given clock, in time order.
+   */
+  long operate_on(const champsim::chrono::clock& clock);
+
+  /**
+   * The earliest time at which any operable is woken. Global clock ticks that end at or before this time operate nothing.
+   */
+  [[nodiscard]] champsim::chrono::clock::time_point next_wakeup() const;
+};
+} // namespace champsim
+
+#endif
@@ -17,8 +17,11 @@
 #ifndef TRACEREADER_H
 #define TRACEREADER_H
 
+#include <array>
 #include <cstring>
 #include <deque>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -91,10 +94,18 @@ class bulk_tracereader
   bool presimpoint_done = false;
   uint64_t presimpoint_count = 0;
 
+  template <typename U>
+  using has_read_in_place = decltype(std::declval<U>().read_in_place(std::size_t{}));
+
+  void push_record(const T& record);
+
 public:
   ooo_model_instr operator()();
 
-  bulk_tracereader(uint8_t cpu_idx, std::string tf) : cpu(cpu_idx), trace_file(tf) {}
+  template <typename... Args>
+  bulk_tracereader(uint8_t cpu_idx, std::string tf, Args... args) : cpu(cpu_idx), trace_file(tf, args...)
+  {
+  }
   bulk_tracereader(uint8_t cpu_idx, F&& file) : cpu(cpu_idx), trace_file(std::move(file)) {}
 
   [[nodiscard]] bool eof() const { return trace_file.eof() && std::size(instr_buffer) <= refresh_thresh; }
@@ -111,56 +122,67 @@ void set_branch_targets(It begin, It end)
 }
 
 template <typename T, typename F>
-ooo_model_instr bulk_tracereader<T, F>::operator()()
+void bulk_tracereader<T, F>::push_record(const T& record)
 {
-  while (std::size(instr_buffer) <= refresh_thresh) {
-    std::array<T, buffer_size - refresh_thresh> trace_read_buf;
-    std::array<char, std::size(trace_read_buf) * sizeof(T)> raw_buf;
-    std::size_t bytes_read;
-
-    trace_file.read(std::data(raw_buf), std::size(raw_buf));
-    bytes_read = static_cast<std::size_t>(trace_file.gcount());
-    eof_ = trace_file.eof();
-
-    std::memcpy(std::data(trace_read_buf), std::data(raw_buf), bytes_read);
-
-    auto begin = std::begin(trace_read_buf);
-    auto end = std::next(begin, bytes_read / sizeof(T));
-
-
-    for (auto it = begin; it != end; ++it) {
-      if constexpr (std::is_same_v<T, cheri_instr>) {
-          if (it->cap_op == static_cast<unsigned char>(champsim::cap_op_type::PRESIMPOINT)) {
-              if (!champsim::cap_mem[cpu].is_finalized()) {
-                  for (const auto& dmem : it->destination_memory) {
-                      if (dmem == 0) continue;
-                      champsim::capability cap{
-                          champsim::address{it->cap_offset},
-                          champsim::address{it->cap_base},
-                          champsim::address{it->cap_length},
-                          it->cap_perms,
-                          static_cast<bool>(it->cap_tag)
-                      };
-                      if (cap.tag)
-                          champsim::cap_mem[cpu].store_capability(champsim::address{dmem}, cap);
-                      else
-                          champsim::cap_mem[cpu].invalidate_tag(champsim::address{dmem});
-                  }
+  if constexpr (std::is_same_v<T, cheri_instr>) {
+      if (record.cap_op == static_cast<unsigned char>(champsim::cap_op_type::PRESIMPOINT)) {
+          if (!champsim::cap_mem[cpu].is_finalized()) {
+              for (const auto& dmem : record.destination_memory) {
+                  if (dmem == 0) continue;
+                  champsim::capability cap{
+                      champsim::address{record.cap_offset},
+                      champsim::address{record.cap_base},
+                      champsim::address{record.cap_length},
+                      record.cap_perms,
+                      static_cast<bool>(record.cap_tag)
+                  };
+                  if (cap.tag)
+                      champsim::cap_mem[cpu].store_capability(champsim::address{dmem}, cap);
+                  else
+                      champsim::cap_mem[cpu].invalidate_tag(champsim::address{dmem});
               }
-              presimpoint_count++;
-              continue;
           }
+          presimpoint_count++;
+          return;
+      }
 
-          if (!presimpoint_done) {
-              presimpoint_done = true;
-              champsim::cap_mem[cpu].finalize();
-              fmt::print("[TRACE] CPU {} presimpoint phase complete: {} entries processed, "
-                        "cap_mem size: {}\n", cpu, presimpoint_count, champsim::cap_mem[cpu].size());
-          }
+      if (!presimpoint_done) {
+          presimpoint_done = true;
+          champsim::cap_mem[cpu].finalize();
+          fmt::print("[TRACE] CPU {} presimpoint phase complete: {} entries processed, "
+                    "cap_mem size: {}\n", cpu, presimpoint_count, champsim::cap_mem[cpu].size());
+      }
+  }
+  instr_buffer.push_back(ooo_model_instr{cpu, record});
+}
+
+template <typename T, typename F>
+ooo_model_instr bulk_tracereader<T, F>::operator()()
+{
+  constexpr std::size_t read_size = (buffer_size - refresh_thresh) * sizeof(T);
+
+  while (std::size(instr_buffer) <= refresh_thresh) {
+    if constexpr (champsim::is_detected_v<has_read_in_place, F>) {
+      // Decode directly from the stream's own storage. The records may not be aligned, so each is copied out as it is decoded.
+      auto [first, last] = trace_file.read_in_place(read_size);
+      for (; std::distance(first, last) >= static_cast<std::ptrdiff_t>(sizeof(T)); first = std::next(first, sizeof(T))) {
+        T record;
+        std::memcpy(&record, first, sizeof(T));
+        push_record(record);
+      }
+    } else {
+      std::array<T, buffer_size - refresh_thresh> trace_read_buf;
+      trace_file.read(reinterpret_cast<char*>(std::data(trace_read_buf)), read_size); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+      auto bytes_read = static_cast<std::size_t>(trace_file.gcount());
+
+      auto begin = std::begin(trace_read_buf);
+      auto end = std::next(begin, bytes_read / sizeof(T));
+      for (auto it = begin; it != end; ++it) {
+        push_record(*it);
       }
-      instr_buffer.push_back(ooo_model_instr{cpu, *it});
     }
 
+    eof_ = trace_file.eof();
     if (eof_) break;
   }
 
@@ -176,6 +198,18 @@ ooo_model_instr bulk_tracereader<T, F>::operator()()
 std::string get_fptr_cmd(std::string_view fname);
 } // namespace champsim
 
-champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool is_cheri, bool repeat);
+/**
+ * Open a trace file. If decompress_depth is nonzero, compressed traces are decompressed on a background thread,
+ * which keeps up to that many blocks of records ahead of the simulation.
+ * Uncompressed traces are memory-mapped if use_mmap is set or if the file name ends in ".raw".
+ */
+champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool is_cheri, bool repeat,
+                                      std::size_t decompress_depth = 0, bool use_mmap = false);
+
+/**
+ * Open a trace file to read its records as raw bytes, decompressing them if needed. The returned function fills the given buffer and
+ * returns the number of bytes written to it, which is zero at the end of the trace.
+ */
+std::function<std::size_t(char*, std::size_t)> get_trace_bytes(const std::string& fname);
 
 #endif
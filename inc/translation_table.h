@@ -0,0 +1,134 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRANSLATION_TABLE_H
+#define TRANSLATION_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * An open-addressed (linear probing) hash table from the virtual pages of each address space to their translations.
+ * Translations are never removed, except all at once, so the table needs no tombstones. It doubles when it becomes half full.
+ */
+template <typename T>
+class translation_table
+{
+public:
+  struct key_type {
+    uint32_t cpu;
+    uint32_t level; // 0 for a page, or the page table level of a page table entry
+    uint64_t vaddr;
+
+    bool operator==(const key_type& other) const { return cpu == other.cpu && level == other.level && vaddr == other.vaddr; }
+  };
+
+  /**
+   * Find the value of the key, or insert the given value if the key is absent.
+   *
+   * :returns: A pointer to the value, which is valid until the next insertion, and whether the value was inserted.
+   */
+  std::pair<T*, bool> try_emplace(key_type key, T value)
+  {
+    if (2 * (occupied + 1) > std::size(slots)) {
+      grow();
+    }
+
+    auto& found = probe(key);
+    bool inserted = found.key.cpu == empty_cpu;
+    if (inserted) {
+      found = {key, value};
+      ++occupied;
+    }
+    return {&found.value, inserted};
+  }
+
+  /**
+   * Call the function with the key and value of every translation, in no particular order.
+   */
+  template <typename F>
+  void for_each(F&& func) const
+  {
+    for (const auto& slot : slots) {
+      if (slot.key.cpu != empty_cpu) {
+        func(slot.key, slot.value);
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const { return occupied; }
+
+  void clear()
+  {
+    slots.clear();
+    occupied = 0;
+    slot_shift = std::numeric_limits<uint64_t>::digits;
+  }
+
+private:
+  constexpr static uint32_t empty_cpu = std::numeric_limits<uint32_t>::max();
+  constexpr static std::size_t initial_slots = 1024;
+
+  struct slot_type {
+    key_type key{empty_cpu, 0, 0};
+    T value{};
+  };
+
+  std::vector<slot_type> slots{};
+  std::size_t occupied = 0;
+  unsigned slot_shift = std::numeric_limits<uint64_t>::digits;
+
+  [[nodiscard]] std::size_t home_slot(const key_type& key) const
+  {
+    // Fibonacci hashing spreads the consecutive pages of a heap across the table
+    auto hash = key.vaddr ^ (uint64_t{key.cpu} << 48) ^ (uint64_t{key.level} << 56);
+    return static_cast<std::size_t>((hash * 0x9e3779b97f4a7c15ULL) >> slot_shift);
+  }
+
+  slot_type& probe(const key_type& key)
+  {
+    auto mask = std::size(slots) - 1;
+    for (auto index = home_slot(key);; index = (index + 1) & mask) {
+      if (slots[index].key.cpu == empty_cpu || slots[index].key == key) {
+        return slots[index];
+      }
+    }
+  }
+
+  void grow()
+  {
+    auto old_slots = std::move(slots);
+    slots = std::vector<slot_type>(std::empty(old_slots) ? initial_slots : 2 * std::size(old_slots));
+    slot_shift = static_cast<unsigned>(std::numeric_limits<uint64_t>::digits);
+    for (auto size = std::size(slots); size > 1; size >>= 1) {
+      --slot_shift;
+    }
+
+    for (const auto& slot : old_slots) {
+      if (slot.key.cpu != empty_cpu) {
+        probe(slot.key) = slot;
+      }
+    }
+  }
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_BLOCK_INDEXED_DEQUE_H
+#define UTIL_BLOCK_INDEXED_DEQUE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+#include "util/bit_enum.h"
+
+namespace champsim
+{
+/**
+ * A deque of packets that also counts how many of its packets fall in each block.
+ *
+ * Collision checks can ask whether any packet shares a block with a given address without scanning the queue. Only a block that is
+ * present needs the ordered search, so the first matching packet is the same one that a linear search would find.
+ *
+ * Elements may be modified through iterators, but their addresses must not change while they are in the queue.
+ */
+template <typename T>
+class block_indexed_deque
+{
+  using container_type = std::deque<T>;
+
+  container_type elements{};
+  std::unordered_map<uint64_t, unsigned> block_counts{};
+  champsim::data::bits shamt{};
+
+  template <typename A>
+  [[nodiscard]] uint64_t key_of(const A& addr) const
+  {
+    return addr.slice_upper(shamt).template to<uint64_t>();
+  }
+
+  void add_key(const T& elem) { ++block_counts[key_of(elem.address)]; }
+
+  void remove_key(const T& elem)
+  {
+    auto found = block_counts.find(key_of(elem.address));
+    if (--found->second == 0) {
+      block_counts.erase(found);
+    }
+  }
+
+public:
+  using value_type = typename container_type::value_type;
+  using size_type = typename container_type::size_type;
+  using difference_type = typename container_type::difference_type;
+  using reference = typename container_type::reference;
+  using const_reference = typename container_type::const_reference;
+  using iterator = typename container_type::iterator;
+  using const_iterator = typename container_type::const_iterator;
+
+  block_indexed_deque() = default;
+  explicit block_indexed_deque(champsim::data::bits block_shamt) : shamt(block_shamt) {}
+
+  [[nodiscard]] iterator begin() noexcept { return std::begin(elements); }
+  [[nodiscard]] iterator end() noexcept { return std::end(elements); }
+  [[nodiscard]] const_iterator begin() const noexcept { return std::cbegin(elements); }
+  [[nodiscard]] const_iterator end() const noexcept { return std::cend(elements); }
+  [[nodiscard]] const_iterator cbegin() const noexcept { return std::cbegin(elements); }
+  [[nodiscard]] const_iterator cend() const noexcept { return std::cend(elements); }
+
+  [[nodiscard]] size_type size() const noexcept { return std::size(elements); }
+  [[nodiscard]] bool empty() const noexcept { return std::empty(elements); }
+
+  [[nodiscard]] reference front() { return elements.front(); }
+  [[nodiscard]] const_reference front() const { return elements.front(); }
+  [[nodiscard]] reference back() { return elements.back(); }
+  [[nodiscard]] const_reference back() const { return elements.back(); }
+
+  void push_back(const value_type& elem)
+  {
+    elements.push_back(elem);
+    add_key(elements.back());
+  }
+
+  void push_back(value_type&& elem)
+  {
+    elements.push_back(std::move(elem));
+    add_key(elements.back());
+  }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    auto& elem = elements.emplace_back(std::forward<Args>(args)...);
+    add_key(elem);
+    return elem;
+  }
+
+  void pop_front()
+  {
+    remove_key(elements.front());
+    elements.pop_front();
+  }
+
+  iterator erase(const_iterator pos)
+  {
+    remove_key(*pos);
+    return elements.erase(pos);
+  }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    std::for_each(first, last, [this](const auto& elem) { this->remove_key(elem); });
+    return elements.erase(first, last);
+  }
+
+  void clear()
+  {
+    elements.clear();
+    block_counts.clear();
+  }
+
+  /**
+   * The number of packets in the same block as the given address.
+   */
+  template <typename A>
+  [[nodiscard]] size_type count(const A& addr) const
+  {
+    auto found = block_counts.find(key_of(addr));
+    return found == std::end(block_counts) ? 0 : found->second;
+  }
+
+  /**
+   * Find the oldest packet in the same block as the given address, or end() if there is none.
+   */
+  template <typename A>
+  [[nodiscard]] iterator find(const A& addr)
+  {
+    if (count(addr) == 0) {
+      return end();
+    }
+    return std::find_if(begin(), end(), [match = key_of(addr), this](const auto& elem) { return this->key_of(elem.address) == match; });
+  }
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,286 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_CIRCULAR_BUFFER_H
+#define UTIL_CIRCULAR_BUFFER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "util/bits.h"
+
+namespace champsim
+{
+/**
+ * A first-in, first-out buffer whose storage is allocated once, when it is constructed.
+ *
+ * Elements are appended at the back and removed from the front by advancing a head index, so an element never moves once it is placed.
+ * References and iterators to an element remain valid until it is removed. The capacity is fixed, so appending to a full buffer is an error
+ * rather than a reallocation that would move every element.
+ */
+template <typename T>
+class circular_buffer
+{
+  using storage_type = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+  std::unique_ptr<storage_type[]> storage_; // NOLINT(cppcoreguidelines-avoid-c-arrays)
+  std::size_t mask_ = 0;
+  std::size_t head_ = 0;
+  std::size_t size_ = 0;
+
+  [[nodiscard]] T* slot(std::size_t pos) const { return std::launder(reinterpret_cast<T*>(&storage_[pos & mask_])); } // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+
+  template <bool Const>
+  class iterator_base
+  {
+    using buffer_type = std::conditional_t<Const, const circular_buffer, circular_buffer>;
+    buffer_type* buf_ = nullptr;
+    std::size_t pos_ = 0; // Positions count monotonically, so they stay valid as the head advances
+
+    friend class circular_buffer;
+    friend class iterator_base<!Const>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    iterator_base() = default;
+    iterator_base(buffer_type* buf, std::size_t pos) : buf_(buf), pos_(pos) {}
+
+    // Allow conversion from a mutable iterator to a const one
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    iterator_base(const iterator_base<false>& other) : buf_(other.buf_), pos_(other.pos_) // NOLINT(google-explicit-constructor)
+    {
+    }
+
+    reference operator*() const { return *buf_->slot(pos_); }
+    pointer operator->() const { return buf_->slot(pos_); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    iterator_base& operator++()
+    {
+      ++pos_;
+      return *this;
+    }
+    iterator_base operator++(int)
+    {
+      auto retval = *this;
+      ++pos_;
+      return retval;
+    }
+    iterator_base& operator--()
+    {
+      --pos_;
+      return *this;
+    }
+    iterator_base operator--(int)
+    {
+      auto retval = *this;
+      --pos_;
+      return retval;
+    }
+    iterator_base& operator+=(difference_type n)
+    {
+      pos_ = static_cast<std::size_t>(static_cast<difference_type>(pos_) + n);
+      return *this;
+    }
+    iterator_base& operator-=(difference_type n) { return *this += -n; }
+
+    friend iterator_base operator+(iterator_base it, difference_type n) { return it += n; }
+    friend iterator_base operator+(difference_type n, iterator_base it) { return it += n; }
+    friend iterator_base operator-(iterator_base it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const iterator_base& lhs, const iterator_base& rhs)
+    {
+      return static_cast<difference_type>(lhs.pos_) - static_cast<difference_type>(rhs.pos_);
+    }
+
+    friend bool operator==(const iterator_base& lhs, const iterator_base& rhs) { return lhs.pos_ == rhs.pos_; }
+    friend bool operator!=(const iterator_base& lhs, const iterator_base& rhs) { return lhs.pos_ != rhs.pos_; }
+    friend bool operator<(const iterator_base& lhs, const iterator_base& rhs) { return lhs.pos_ < rhs.pos_; }
+    friend bool operator>(const iterator_base& lhs, const iterator_base& rhs) { return lhs.pos_ > rhs.pos_; }
+    friend bool operator<=(const iterator_base& lhs, const iterator_base& rhs) { return lhs.pos_ <= rhs.pos_; }
+    friend bool operator>=(const iterator_base& lhs, const iterator_base& rhs) { return lhs.pos_ >= rhs.pos_; }
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = iterator_base<false>;
+  using const_iterator = iterator_base<true>;
+
+  /**
+   * Allocate storage for at least the given number of elements. The capacity is rounded up to a power of two.
+   */
+  explicit circular_buffer(size_type capacity = 1)
+      : storage_(std::make_unique<storage_type[]>(champsim::next_pow2(std::max<size_type>(capacity, 1)))), // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        mask_(champsim::next_pow2(std::max<size_type>(capacity, 1)) - 1)
+  {
+  }
+
+  circular_buffer(const circular_buffer& other) : circular_buffer(other.capacity())
+  {
+    std::copy(std::begin(other), std::end(other), std::back_inserter(*this));
+  }
+
+  circular_buffer(circular_buffer&& other) noexcept
+      : storage_(std::move(other.storage_)), mask_(other.mask_), head_(other.head_), size_(std::exchange(other.size_, 0))
+  {
+  }
+
+  circular_buffer& operator=(circular_buffer other) noexcept
+  {
+    swap(other);
+    return *this;
+  }
+
+  ~circular_buffer() { clear(); }
+
+  void swap(circular_buffer& other) noexcept
+  {
+    using std::swap;
+    swap(storage_, other.storage_);
+    swap(mask_, other.mask_);
+    swap(head_, other.head_);
+    swap(size_, other.size_);
+  }
+
+  [[nodiscard]] iterator begin() { return iterator{this, head_}; }
+  [[nodiscard]] iterator end() { return iterator{this, head_ + size_}; }
+  [[nodiscard]] const_iterator begin() const { return const_iterator{this, head_}; }
+  [[nodiscard]] const_iterator end() const { return const_iterator{this, head_ + size_}; }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+
+  [[nodiscard]] size_type size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] bool full() const { return size_ == capacity(); }
+  [[nodiscard]] size_type capacity() const { return storage_ == nullptr ? 0 : mask_ + 1; }
+
+  reference operator[](size_type n)
+  {
+    assert(n < size_);
+    return *slot(head_ + n);
+  }
+
+  const_reference operator[](size_type n) const
+  {
+    assert(n < size_);
+    return *slot(head_ + n);
+  }
+
+  reference at(size_type n)
+  {
+    if (n >= size_) {
+      throw std::out_of_range{"circular_buffer index out of range"};
+    }
+    return (*this)[n];
+  }
+
+  const_reference at(size_type n) const
+  {
+    if (n >= size_) {
+      throw std::out_of_range{"circular_buffer index out of range"};
+    }
+    return (*this)[n];
+  }
+
+  reference front() { return (*this)[0]; }
+  const_reference front() const { return (*this)[0]; }
+  reference back() { return (*this)[size_ - 1]; }
+  const_reference back() const { return (*this)[size_ - 1]; }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    if (full()) {
+      throw std::length_error{"circular_buffer appended past its capacity"};
+    }
+    auto* place = ::new (static_cast<void*>(slot(head_ + size_))) T(std::forward<Args>(args)...);
+    ++size_;
+    return *place;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void pop_front()
+  {
+    assert(size_ > 0);
+    std::destroy_at(slot(head_));
+    ++head_;
+    --size_;
+  }
+
+  /**
+   * Append the range at the end of the buffer. Elements may only be inserted at the end.
+   */
+  template <typename It>
+  iterator insert(const_iterator pos, It first, It last)
+  {
+    assert(pos == cend());
+    auto retval = iterator{this, pos.pos_};
+    std::copy(first, last, std::back_inserter(*this));
+    return retval;
+  }
+
+  /**
+   * Remove the range from the buffer. Removing from the front only advances the head,
+   * while removing from elsewhere moves the later elements forward.
+   */
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    assert(cbegin() <= first && first <= last && last <= cend());
+    auto count = static_cast<size_type>(last - first);
+    if (first == cbegin()) {
+      for (size_type i = 0; i < count; ++i) {
+        pop_front();
+      }
+      return begin();
+    }
+
+    auto dest = iterator{this, first.pos_};
+    auto new_end = std::move(iterator{this, last.pos_}, end(), dest);
+    for (auto it = new_end; it != end(); ++it) {
+      std::destroy_at(std::addressof(*it));
+    }
+    size_ -= count;
+    return dest;
+  }
+
+  void clear()
+  {
+    while (!empty()) {
+      pop_front();
+    }
+  }
+};
+
+} // namespace champsim
+
+#endif
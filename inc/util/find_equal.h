@@ -0,0 +1,69 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_FIND_EQUAL_H
+#define UTIL_FIND_EQUAL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace champsim
+{
+/**
+ * Find the index of the first element of a dense array that is equal to the given value, or count if there is none.
+ *
+ * This compares several elements at once with AVX2 or SSE2, whichever the build targets, and falls back to a scalar search otherwise.
+ */
+inline std::size_t find_first_equal(const uint64_t* first, std::size_t count, uint64_t value)
+{
+  std::size_t idx = 0;
+#if defined(__AVX2__)
+  const auto needle = _mm256_set1_epi64x(static_cast<long long>(value));
+  for (; idx + 4 <= count; idx += 4) {
+    const auto haystack = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + idx)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(haystack, needle)));
+    if (mask != 0) {
+      return idx + ((mask & 0x1) ? 0 : (mask & 0x2) ? 1 : (mask & 0x4) ? 2 : 3);
+    }
+  }
+#elif defined(__SSE2__)
+  // SSE2 has no 64-bit compare, so both 32-bit halves of an element must be equal
+  const auto needle = _mm_set1_epi64x(static_cast<long long>(value));
+  for (; idx + 2 <= count; idx += 2) {
+    const auto haystack = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + idx)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto half_eq = _mm_cmpeq_epi32(haystack, needle);
+    const auto mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(half_eq, _mm_shuffle_epi32(half_eq, _MM_SHUFFLE(2, 3, 0, 1)))));
+    if (mask != 0) {
+      return idx + ((mask & 0x1) ? 0 : 1);
+    }
+  }
+#endif
+  for (; idx < count; ++idx) {
+    if (first[idx] == value) {
+      return idx;
+    }
+  }
+  return count;
+}
+} // namespace champsim
+
+#endif
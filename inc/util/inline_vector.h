@@ -0,0 +1,153 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_INLINE_VECTOR_H
+#define UTIL_INLINE_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace champsim
+{
+/**
+ * A vector with a fixed capacity, whose elements are stored inline.
+ *
+ * This never allocates, and is trivially copyable if its elements are, so objects that hold it can be copied and moved cheaply.
+ * Inserting beyond the capacity throws std::length_error.
+ */
+template <typename T, std::size_t N>
+class inline_vector
+{
+  std::array<T, N> storage_{};
+  std::size_t size_ = 0;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = typename std::array<T, N>::iterator;
+  using const_iterator = typename std::array<T, N>::const_iterator;
+
+  inline_vector() = default;
+  inline_vector(std::initializer_list<T> init)
+  {
+    for (const auto& x : init) {
+      push_back(x);
+    }
+  }
+
+  [[nodiscard]] iterator begin() { return std::begin(storage_); }
+  [[nodiscard]] iterator end() { return std::next(std::begin(storage_), static_cast<difference_type>(size_)); }
+  [[nodiscard]] const_iterator begin() const { return std::cbegin(storage_); }
+  [[nodiscard]] const_iterator end() const { return std::next(std::cbegin(storage_), static_cast<difference_type>(size_)); }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+
+  [[nodiscard]] size_type size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] constexpr static size_type capacity() { return N; }
+  [[nodiscard]] constexpr static size_type max_size() { return N; }
+
+  [[nodiscard]] pointer data() { return std::data(storage_); }
+  [[nodiscard]] const_pointer data() const { return std::data(storage_); }
+
+  reference operator[](size_type pos)
+  {
+    assert(pos < size_);
+    return storage_[pos];
+  }
+
+  const_reference operator[](size_type pos) const
+  {
+    assert(pos < size_);
+    return storage_[pos];
+  }
+
+  reference at(size_type pos)
+  {
+    if (pos >= size_) {
+      throw std::out_of_range{"inline_vector index out of range"};
+    }
+    return storage_[pos];
+  }
+
+  const_reference at(size_type pos) const
+  {
+    if (pos >= size_) {
+      throw std::out_of_range{"inline_vector index out of range"};
+    }
+    return storage_[pos];
+  }
+
+  reference front() { return (*this)[0]; }
+  const_reference front() const { return (*this)[0]; }
+  reference back() { return (*this)[size_ - 1]; }
+  const_reference back() const { return (*this)[size_ - 1]; }
+
+  void push_back(const T& value)
+  {
+    if (size_ == N) {
+      throw std::length_error{"inline_vector capacity exceeded"};
+    }
+    storage_[size_++] = value;
+  }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    push_back(T{std::forward<Args>(args)...});
+    return back();
+  }
+
+  void pop_back()
+  {
+    assert(size_ > 0);
+    storage_[--size_] = T{};
+  }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    auto dest = std::next(begin(), std::distance(cbegin(), first));
+    auto new_end = std::move(std::next(begin(), std::distance(cbegin(), last)), end(), dest);
+    std::fill(new_end, end(), T{});
+    size_ = static_cast<size_type>(std::distance(begin(), new_end));
+    return dest;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  void clear()
+  {
+    std::fill(begin(), end(), T{});
+    size_ = 0;
+  }
+
+  friend bool operator==(const inline_vector& lhs, const inline_vector& rhs) { return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs)); }
+  friend bool operator!=(const inline_vector& lhs, const inline_vector& rhs) { return !(lhs == rhs); }
+};
+} // namespace champsim
+
+#endif
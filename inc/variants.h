@@ -0,0 +1,51 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VARIANTS_H
+#define VARIANTS_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * Simulate each of the given variants in its own forked process, reading and decompressing each trace only once.
+ *
+ * The bytes of each trace are streamed to every variant through a pipe, which the variant reads as an uncompressed trace. A trace is held in
+ * memory only until every variant has been sent it, so the variants may consume their traces at different rates. A variant that gets
+ * max_buffered bytes ahead of the slowest variant still reading a trace waits for it to catch up. The limit is exceeded only while every
+ * variant is waiting on another, as can happen when they read several traces at different rates. If repeat is set, a trace is streamed
+ * again from its beginning whenever it ends, until every variant has stopped reading it.
+ *
+ * In each child, the simulation is called with the index of the variant and the names of the streams to open in place of the traces, and
+ * returns the child's exit status. Each child's output is captured and printed under the name of its variant once all have finished.
+ *
+ * Returns zero if every variant succeeded.
+ */
+int run_variants(const std::vector<std::string>& variant_names, const std::vector<std::string>& trace_names, bool repeat,
+                 const std::function<int(std::size_t, std::vector<std::string>)>& simulate, std::size_t max_buffered = std::size_t{64} << 20);
+
+/**
+ * Name a file for the given variant, by inserting the variant's name before the file's extension.
+ */
+std::string variant_file_name(const std::string& fname, std::string_view variant);
+} // namespace champsim
+
+#endif
@@ -18,14 +18,14 @@
 #define VMEM_H
 
 #include <cstdint>
-#include <deque>
-#include <map>
 #include <optional>
-#include <random>
 
 #include "address.h"
 #include "champsim.h"
+#include "checkpoint.h"
 #include "chrono.h"
+#include "page_permutation.h"
+#include "translation_table.h"
 
 class MEMORY_CONTROLLER;
 
@@ -34,8 +34,9 @@ using pte_entry = champsim::data::size<long long, std::ratio<8>>;
 class VirtualMemory
 {
 private:
-  std::map<std::pair<uint32_t, champsim::page_number>, champsim::page_number> vpage_to_ppage_map;
-  std::map<std::tuple<uint32_t, uint32_t, champsim::address_slice<champsim::dynamic_extent>>, champsim::address> page_table;
+  // Page table entries are keyed by their level and the bits of the virtual address above the entries of that level
+  champsim::translation_table<champsim::page_number> vpage_to_ppage_map;
+  champsim::translation_table<champsim::address> page_table;
   std::optional<uint64_t> randomization_seed;
   MEMORY_CONTROLLER& dram;
 
@@ -45,17 +46,16 @@ public:
   const pte_entry pte_page_size; // Size of a PTE page
 
 private:
-  std::deque<champsim::page_number> ppage_free_list;
+  // Physical pages are handed out in the order of a permutation of the pages above the first MiB, which is evaluated lazily
+  champsim::page_number ppage_base{};
+  champsim::page_permutation ppage_order{};
+  uint64_t ppages_allocated = 0;
   champsim::page_number active_pte_page{};
   champsim::address_slice<champsim::dynamic_extent> next_pte_page;
 
-  // champsim::page_number next_ppage;
-  // champsim::page_number last_ppage;
-
   [[nodiscard]] champsim::page_number ppage_front() const;
   void ppage_pop();
 
-  void shuffle_pages();
   void populate_pages();
 
 public:
@@ -118,6 +118,17 @@ public:
    * :returns: A pair of the page table page address and the latency to be applied to the operation.
    */
   std::pair<champsim::address, champsim::chrono::clock::duration> get_pte_pa(uint32_t cpu_num, champsim::page_number vaddr, std::size_t level);
+
+  /**
+   * Save the page mappings, the page table pages, and the count of unallocated physical pages.
+   */
+  void save_state(champsim::checkpoint_writer& out) const;
+
+  /**
+   * Restore the state written by save_state(). The order of unallocated pages is rebuilt from the configuration, less the pages that had been
+   * allocated, so the virtual memory must have the same physical memory size and randomization seed as the one that was saved.
+   */
+  void load_state(champsim::checkpoint_reader& in);
 };
 
 #endif
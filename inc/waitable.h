@@ -75,6 +75,7 @@ public:
 
   bool is_ready_at(time_type cycle) const;
   bool has_unknown_readiness() const;
+  time_type ready_time() const;
 
   auto& operator*();
   auto& operator*() const;
@@ -134,6 +135,13 @@ bool champsim::waitable<T>::has_unknown_readiness() const
   return !event_cycle.has_value();
 }
 
+// The time at which the value is ready, which is the greatest time if it is not known
+template <typename T>
+auto champsim::waitable<T>::ready_time() const -> time_type
+{
+  return event_cycle.value_or(time_sentinel);
+}
+
 template <typename T>
 auto& champsim::waitable<T>::operator*()
 {
@@ -42,11 +42,6 @@
 /*                      Latency table functions                               */
 /******************************************************************************/
 
-std::vector<berti::HistoryTable*> berti::historyt;
-std::vector<berti::LatencyTable*> berti::latencyt;
-std::vector<berti::ShadowCache*> berti::scache;
-uint64_t berti::others = 0;
-
 uint8_t berti::LatencyTable::add(uint64_t addr, uint64_t tag, bool pf, uint64_t cycle)
 {
   /*
@@ -743,7 +738,7 @@ void berti::find_and_update(uint64_t latency, uint64_t tag, uint64_t cycle,
   uint16_t num_on_time = 0;
 
   // Get the IPs that can launch a prefetch
-  num_on_time = historyt[me]->get(latency, tag, line_addr, tags, addr, cycle);
+  num_on_time = historyt->get(latency, tag, line_addr, tags, addr, cycle);
 
   for (uint32_t i = 0; i < num_on_time; i++)
   {
@@ -918,12 +913,9 @@ void berti::prefetcher_initialize()
 
 
   //fix this
-  latencyt.push_back(new LatencyTable(latency_table_size));
-  scache.push_back(new ShadowCache(intern_->NUM_SET, intern_->NUM_WAY));
-  historyt.push_back(new HistoryTable());
-
-  me = others;
-  others++;
+  latencyt = std::make_unique<LatencyTable>(latency_table_size);
+  scache = std::make_unique<ShadowCache>(intern_->NUM_SET, intern_->NUM_WAY);
+  historyt = std::make_unique<HistoryTable>();
 
   std::cout << "Berti Prefetcher" << std::endl;
   //intern_->internal_PQ.set_timeout(1500);
@@ -989,9 +981,9 @@ uint32_t berti::prefetcher_cache_operate(champsim::address addr, champsim::addre
                                         uint32_t metadata_in, uint32_t metadata_hit)
 {
   // We select the structures for every cpu
-  LatencyTable* tlatencyt = latencyt[me];
-  ShadowCache* tscache = scache[me];
-  HistoryTable* thistoryt = historyt[me];
+  LatencyTable* tlatencyt = latencyt.get();
+  ShadowCache* tscache = scache.get();
+  HistoryTable* thistoryt = historyt.get();
 
   champsim::block_number line_addr{addr}; // Line addr
    
@@ -1096,9 +1088,9 @@ uint32_t berti::prefetcher_cache_fill(champsim::address addr, champsim::address
                                       uint32_t metadata_evict, uint32_t cpu_evict)
 {
   // We select the structures for every cpu
-  LatencyTable* tlatencyt = latencyt[me];
-  ShadowCache* tscache = scache[me];
-  // HistoryTable* thistoryt = historyt[me];
+  LatencyTable* tlatencyt = latencyt.get();
+  ShadowCache* tscache = scache.get();
+  // HistoryTable* thistoryt = historyt.get();
 
 
 
@@ -1158,7 +1150,7 @@ void berti::prefetcher_final_stats()
 {
   std::cout << "\nBERTI " << "TO_L1: " << pf_to_l1 << " TO_L2: " << pf_to_l2;
   std::cout << " TO_L2_BC_MSHR: " << pf_to_l2_bc_mshr << std::endl;
-  std::cout << "DETECTED ALIASES: " << scache[me]->aliased_cache_hits << std::endl;
+  std::cout << "DETECTED ALIASES: " << scache->aliased_cache_hits << std::endl;
 
   std::cout << "BERTI AVG_LAT: ";
   std::cout << average_latency.average << " NUM_TRACK_LATENCY: ";
@@ -51,6 +51,7 @@
 #include <queue>
 #include <cmath>
 #include <map>
+#include <memory>
 
 class berti : public champsim::modules::prefetcher {
 
@@ -228,12 +229,10 @@ class berti : public champsim::modules::prefetcher {
     uint8_t get(uint64_t tag, std::vector<delta_t> &res);
     uint64_t ip_hash(uint64_t ip);
     
-    uint64_t me = 0;
-    static uint64_t others;
-    // This is structure is an adaption of Berti for multicore simulations
-    static std::vector<LatencyTable*> latencyt;
-    static std::vector<ShadowCache*> scache;
-    static std::vector<HistoryTable*> historyt;
+    // Each instance owns its tables, so that cores simulated in parallel share no mutable state
+    std::unique_ptr<LatencyTable> latencyt;
+    std::unique_ptr<ShadowCache> scache;
+    std::unique_ptr<HistoryTable> historyt;
 
     using prefetcher::prefetcher;
     uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint32_t cpu, champsim::capability cap, uint8_t cache_hit,
@@ -1,5 +1,9 @@
 #include "cheri_ptr_chase.h"
 
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
 #include "cache.h"
 
 void cheri_ptr_chase::prefetcher_initialize()
@@ -59,13 +63,12 @@ uint32_t cheri_ptr_chase::prefetcher_cache_fill(champsim::address addr, champsim
   uint64_t cl_base = champsim::block_number{addr}.to<uint64_t>() << LOG2_BLOCK_SIZE;
 
   // scan the newly arrived cacheline
+  const auto line_caps = champsim::cap_mem[intern_->cpu].load_line(champsim::address{cl_base});
   for (unsigned slot = 0; slot < CAP_SLOTS_PER_CL; slot++) {
     uint64_t slot_va = cl_base + (static_cast<uint64_t>(slot) << cheri::CAP_ALIGNMENT_BITS);
 
-    auto stored = champsim::cap_mem[intern_->cpu].load_capability(champsim::address{slot_va});
-
-    if (stored.has_value() && stored->tag) {
-      uint64_t target = cheri::capability_cursor(*stored).to<uint64_t>();
+    if ((line_caps.tag_mask >> slot) & 1u) {
+      uint64_t target = cheri::capability_cursor(line_caps.caps[slot]).to<uint64_t>();
       
         uint64_t current_vpn = slot_va >> LOG2_BLOCK_SIZE;
         uint64_t target_vpn = target >> LOG2_BLOCK_SIZE;
@@ -112,4 +115,33 @@ void cheri_ptr_chase::prefetcher_final_stats()
                  ((double)stat_page_crossings / stat_ptr_found)* 100.0);
   }
   fmt::print("============================================\n");
-}
\ No newline at end of file
+}
+void cheri_ptr_chase::prefetcher_save_state(champsim::checkpoint_writer& out) const
+{
+  pct.save_state(out, [](auto& writer, const pct_entry& entry) {
+    writer.write(entry.ip.to<uint64_t>());
+    writer.write(entry.confidence);
+    writer.write(entry.depth_limit);
+  });
+  out.write(ptr_map, PTR_MAP_SIZE);
+  out.write(filter);
+}
+
+void cheri_ptr_chase::prefetcher_load_state(champsim::checkpoint_reader& in)
+{
+  pct.load_state(in, [](auto& reader, pct_entry& entry) {
+    uint64_t ip{};
+    reader.read(ip);
+    reader.read(entry.confidence);
+    reader.read(entry.depth_limit);
+    entry.ip = champsim::address{ip};
+  });
+
+  std::vector<ptr_map_entry> saved_map;
+  in.read(saved_map);
+  if (std::size(saved_map) != PTR_MAP_SIZE)
+    throw std::runtime_error{"Checkpoint's pointer map is of another size"};
+  std::copy(std::begin(saved_map), std::end(saved_map), std::begin(ptr_map));
+
+  in.read(filter);
+}
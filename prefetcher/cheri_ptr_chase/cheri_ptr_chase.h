@@ -9,6 +9,7 @@
 #include "msl/lru_table.h"
 #include "cheri_prefetch_utils.h"
 #include "capability_memory.h"
+#include "checkpoint.h"
 #include "bloom_filter.h"
 
 struct cheri_ptr_chase : public champsim::modules::prefetcher {
@@ -83,6 +84,8 @@ struct cheri_ptr_chase : public champsim::modules::prefetcher {
                                  bool prefetch, champsim::address evicted_addr, champsim::capability evicted_cap, uint32_t metadata_in,
                                  uint32_t metadata_evict, uint32_t cpu_evict);
   void     prefetcher_final_stats();
+  void     prefetcher_save_state(champsim::checkpoint_writer& out) const;
+  void     prefetcher_load_state(champsim::checkpoint_reader& in);
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
 lru::lru(CACHE* cache) : lru(cache, cache->NUM_SET, cache->NUM_WAY) {}
 
@@ -34,3 +35,19 @@ void lru::update_replacement_state(uint32_t triggering_cpu, long set, long way,
   if (hit && access_type{type} != access_type::WRITE) // Skip this for writeback hits
     last_used_cycles.at((std::size_t)(set * NUM_WAY + way)) = cycle++;
 }
+
+void lru::replacement_save_state(champsim::checkpoint_writer& out) const
+{
+  out.write(cycle);
+  out.write(last_used_cycles);
+}
+
+void lru::replacement_load_state(champsim::checkpoint_reader& in)
+{
+  std::vector<uint64_t> saved_cycles;
+  in.read(cycle);
+  in.read(saved_cycles);
+  if (std::size(saved_cycles) != std::size(last_used_cycles))
+    throw std::runtime_error{"Checkpoint's LRU state is for a cache of another size"};
+  last_used_cycles = std::move(saved_cycles);
+}
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "cache.h"
+#include "checkpoint.h"
 #include "modules.h"
 
 class lru : public champsim::modules::replacement
@@ -24,6 +25,8 @@ public:
   void update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
                                 access_type type, uint8_t hit);
   // void replacement_final_stats()
+  void replacement_save_state(champsim::checkpoint_writer& out) const;
+  void replacement_load_state(champsim::checkpoint_reader& in);
 };
 
 #endif
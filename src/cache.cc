@@ -27,18 +27,21 @@
 #include "champsim.h"
 #include "chrono.h"
 #include "deadlock.h"
+#include "functional_warmer.h"
 #include "instruction.h"
 #include "util/algorithm.h"
 #include "util/bits.h"
+#include "util/find_equal.h"
 #include "util/span.h"
 
 CACHE::CACHE(CACHE&& other)
-    : operable(other),
+    : operable(other), pf_filter(std::move(other.pf_filter)),
 
       upper_levels(std::move(other.upper_levels)), lower_level(std::move(other.lower_level)), lower_translate(std::move(other.lower_translate)),
 
       cpu(other.cpu), NAME(std::move(other.NAME)), NUM_SET(other.NUM_SET), NUM_WAY(other.NUM_WAY), MSHR_SIZE(other.MSHR_SIZE), PQ_SIZE(other.PQ_SIZE),
-      HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS), block(std::move(other.block)), MAX_TAG(other.MAX_TAG),
+      HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS), block(std::move(other.block)), block_tags(std::move(other.block_tags)),
+      MAX_TAG(other.MAX_TAG),
       MAX_FILL(other.MAX_FILL), prefetch_as_load(other.prefetch_as_load), match_offset_bits(other.match_offset_bits), virtual_prefetch(other.virtual_prefetch),
       pref_activate_mask(std::move(other.pref_activate_mask)),
 
@@ -73,6 +76,8 @@ auto CACHE::operator=(CACHE&& other) -> CACHE&
   this->OFFSET_BITS = other.OFFSET_BITS;
   ;
   this->block = std::move(other.block);
+  this->block_tags = std::move(other.block_tags);
+  this->pf_filter = std::move(other.pf_filter);
   this->MAX_TAG = other.MAX_TAG;
   this->MAX_FILL = other.MAX_FILL;
   this->prefetch_as_load = other.prefetch_as_load;
@@ -106,11 +111,9 @@ CACHE::mshr_type::mshr_type(const tag_lookup_type& req, champsim::chrono::clock:
 
 CACHE::mshr_type CACHE::mshr_type::merge(mshr_type predecessor, mshr_type successor)
 {
-  std::vector<uint64_t> merged_instr{};
-  std::vector<std::deque<response_type>*> merged_return{};
+  auto merged_instr = champsim::dependency_list::merge(predecessor.instr_depend_on_me, successor.instr_depend_on_me);
+  std::vector<champsim::channel::response_queue*> merged_return{};
 
-  std::set_union(std::begin(predecessor.instr_depend_on_me), std::end(predecessor.instr_depend_on_me), std::begin(successor.instr_depend_on_me),
-                 std::end(successor.instr_depend_on_me), std::back_inserter(merged_instr));
   std::set_union(std::begin(predecessor.to_return), std::end(predecessor.to_return), std::begin(successor.to_return), std::end(successor.to_return),
                  std::back_inserter(merged_return));
 
@@ -119,7 +122,7 @@ CACHE::mshr_type CACHE::mshr_type::merge(mshr_type predecessor, mshr_type succes
   // set the time enqueued to the predecessor unless its a demand into prefetch, in which case we use the successor
   retval.time_enqueued =
       ((successor.type != access_type::PREFETCH && predecessor.type == access_type::PREFETCH)) ? successor.time_enqueued : predecessor.time_enqueued;
-  retval.instr_depend_on_me = merged_instr;
+  retval.instr_depend_on_me = std::move(merged_instr);
   retval.to_return = merged_return;
   retval.data_promise = predecessor.data_promise;
 
@@ -182,13 +185,21 @@ bool CACHE::module_is_instr(const T& element) const
   return element.is_instr;
 }
 
+template <typename T>
+uint64_t CACHE::prefetch_filter_block(const T& element) const
+{
+  return get_tag(virtual_prefetch ? element.v_address : element.address);
+}
+
 bool CACHE::handle_fill(const mshr_type& fill_mshr)
 {
   cpu = fill_mshr.cpu;
+  pf_filter.erase(prefetch_filter_block(fill_mshr));
 
   // find victim
   auto [set_begin, set_end] = get_set_span(fill_mshr.address);
-  auto way = std::find_if_not(set_begin, set_end, [](auto x) { return x.valid; });
+  const auto* set_tags = std::data(block_tags) + static_cast<std::size_t>(get_set_index(fill_mshr.address)) * NUM_WAY;
+  auto way = std::next(set_begin, static_cast<set_type::difference_type>(champsim::find_first_equal(set_tags, NUM_WAY, invalid_tag)));
   if (way == set_end) {
     way = std::next(set_begin, impl_find_victim(fill_mshr.cpu, fill_mshr.instr_id, get_set_index(fill_mshr.address), &*set_begin, fill_mshr.ip,
                                                 fill_mshr.address, fill_mshr.type));
@@ -263,6 +274,7 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
     }
 
     *way = fill_block(fill_mshr, metadata_thru);
+    update_tag(way);
   }
 
   // COLLECT STATS
@@ -284,7 +296,7 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 
   // access cache
   auto [set_begin, set_end] = get_set_span(handle_pkt.address);
-  auto way = std::find_if(set_begin, set_end, [matcher = matches_address(handle_pkt.address)](const auto& x) { return x.valid && matcher(x); });
+  auto way = find_valid_way(handle_pkt.address);
   const auto hit = (way != set_end);
   const auto useful_prefetch = (hit && way->prefetch && !handle_pkt.prefetch_from_this);
 
@@ -310,11 +322,15 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 
   if (hit) {
     sim_stats.hits.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+    record_reuse(handle_pkt);
+
+    if (handle_pkt.prefetch_from_this) {
+      pf_filter.erase(prefetch_filter_block(handle_pkt));
+    }
 
     // CHERI CACHE STATS
-    champsim::capability response_cap = champsim::cap_mem[cpu]
-                                    .load_capability(handle_pkt.v_address)
-                                    .value_or(champsim::capability{});
+    const auto line_caps = champsim::cap_mem[cpu].load_line(handle_pkt.v_address);
+    champsim::capability response_cap = line_caps.at(handle_pkt.v_address).value_or(champsim::capability{});
 
     auto auth_coverage_events = classify_capability(handle_pkt.cap);
     if (handle_pkt.cap.tag)
@@ -339,14 +355,7 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 
     // count number of capabilities seen in a cache line 
     if (handle_pkt.type == access_type::LOAD || handle_pkt.type == access_type::WRITE || handle_pkt.type == access_type::PREFETCH) {
-      uint64_t base_va = handle_pkt.v_address.to<uint64_t>() & ~(uint64_t)(BLOCK_SIZE - 1);
-      unsigned count = 0;
-      for (unsigned i = 0; i < 4; i++) {
-        auto cap_opt = champsim::cap_mem[handle_pkt.cpu].load_capability(champsim::address{base_va + i * 16});
-        if (cap_opt.has_value() && cap_opt->tag)
-          count++;
-      }
-      sim_stats.capabilities_per_cl_hit.increment(cl_cap_key{count, handle_pkt.type, handle_pkt.cpu});
+      sim_stats.capabilities_per_cl_hit.increment(cl_cap_key{line_caps.count(), handle_pkt.type, handle_pkt.cpu});
     }
   }
 
@@ -394,7 +403,7 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
   auto mshr_pkt = mshr_and_forward_packet(handle_pkt);
 
   // check mshr
-  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), matches_address(handle_pkt.address));
+  auto mshr_entry = MSHR.find(handle_pkt.address);
   bool mshr_full = (MSHR.size() == MSHR_SIZE);
 
   if (mshr_entry != MSHR.end()) // miss already inflight
@@ -429,12 +438,14 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
   }
 
   sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  record_reuse(handle_pkt);
   
   // CHERI CACHE STATS
   if (handle_pkt.cap.tag)
     sim_stats.cap_auth_misses.increment(cap_dist_key{classify_capability(handle_pkt.cap), handle_pkt.type, handle_pkt.cpu});
 
-  auto capability_optional = champsim::cap_mem[handle_pkt.cpu].load_capability(handle_pkt.v_address);
+  const auto line_caps = champsim::cap_mem[handle_pkt.cpu].load_line(handle_pkt.v_address);
+  auto capability_optional = line_caps.at(handle_pkt.v_address);
   sim_stats.cap_data_misses.increment(cap_dist_key{
     capability_optional ? classify_capability(*capability_optional) : cap_size_coverage_events::UNTAGGED, 
     handle_pkt.type, 
@@ -442,14 +453,7 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
   });
 
   if (handle_pkt.type == access_type::LOAD || handle_pkt.type == access_type::WRITE ||handle_pkt.type == access_type::PREFETCH) {
-    uint64_t base_va = handle_pkt.v_address.to<uint64_t>() & ~(uint64_t)(BLOCK_SIZE - 1);
-    unsigned count = 0;
-    for (unsigned i = 0; i < 4; i++) {
-      auto cap_opt = champsim::cap_mem[handle_pkt.cpu].load_capability(champsim::address{base_va + i * 16});
-      if (cap_opt.has_value() && cap_opt->tag)
-        count++;
-    }
-    sim_stats.capabilities_per_cl_miss.increment(cl_cap_key{count, handle_pkt.type, handle_pkt.cpu});
+    sim_stats.capabilities_per_cl_miss.increment(cl_cap_key{line_caps.count(), handle_pkt.type, handle_pkt.cpu});
   }
   
   return true;
@@ -468,26 +472,21 @@ bool CACHE::handle_write(const tag_lookup_type& handle_pkt)
   inflight_writes.push_back(to_allocate);
 
   sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  record_reuse(handle_pkt);
 
   // CHERI CACHE STATS
   if (handle_pkt.cap.tag)
     sim_stats.cap_auth_misses.increment(cap_dist_key{classify_capability(handle_pkt.cap), handle_pkt.type, handle_pkt.cpu});
 
-  auto capability_optional = champsim::cap_mem[handle_pkt.cpu].load_capability(handle_pkt.v_address);
+  const auto line_caps = champsim::cap_mem[handle_pkt.cpu].load_line(handle_pkt.v_address);
+  auto capability_optional = line_caps.at(handle_pkt.v_address);
   sim_stats.cap_data_misses.increment(cap_dist_key{
       capability_optional ? classify_capability(*capability_optional) : cap_size_coverage_events::UNTAGGED, 
       handle_pkt.type, 
       handle_pkt.cpu
   });
 
-  uint64_t base_va = handle_pkt.v_address.to<uint64_t>() & ~(uint64_t)(BLOCK_SIZE - 1);
-  unsigned count = 0;
-  for (unsigned i = 0; i < 4; i++) {
-    auto cap_opt = champsim::cap_mem[handle_pkt.cpu].load_capability(champsim::address{base_va + i * 16});
-    if (cap_opt.has_value() && cap_opt->tag)
-      count++;
-  }
-  sim_stats.capabilities_per_cl_miss.increment(cl_cap_key{count, handle_pkt.type, handle_pkt.cpu});
+  sim_stats.capabilities_per_cl_miss.increment(cl_cap_key{line_caps.count(), handle_pkt.type, handle_pkt.cpu});
   
   return true;
 }
@@ -629,12 +628,75 @@ long CACHE::operate()
   return progress + fill_bw.amount_consumed() + initiate_tag_bw.amount_consumed() + tag_check_bw.amount_consumed();
 }
 
+bool CACHE::is_idle() const
+{
+  auto queues_empty = [](const champsim::channel* ul) {
+    return std::empty(ul->WQ) && std::empty(ul->RQ) && std::empty(ul->PQ);
+  };
+  auto fill_ready = [time = current_time](const auto& x) {
+    return x.data_promise.is_ready_at(time);
+  };
+
+  // Outstanding misses do not keep the cache busy until their data is ready to fill
+  return std::all_of(std::cbegin(upper_levels), std::cend(upper_levels), queues_empty) && std::empty(lower_level->returned)
+         && (lower_translate == nullptr || std::empty(lower_translate->returned)) && std::empty(internal_PQ) && std::empty(inflight_tag_check)
+         && std::empty(translation_stash) && std::none_of(std::cbegin(MSHR), std::cend(MSHR), fill_ready)
+         && std::none_of(std::cbegin(inflight_writes), std::cend(inflight_writes), fill_ready) && !impl_prefetcher_has_cycle_operate();
+}
+
+void CACHE::operate_idle(long cycles)
+{
+  // Keep the round-robin arbitration between upper levels in step with the cycle count
+  if (std::size(upper_levels) > 1) {
+    const auto shift = cycles % static_cast<long>(std::size(upper_levels));
+    std::rotate(upper_levels.begin(), upper_levels.begin() + shift, upper_levels.end());
+  }
+}
+
+champsim::chrono::clock::time_point CACHE::next_wakeup() const
+{
+  if (!is_idle()) {
+    return current_time;
+  }
+
+  // Without new packets, the cache is idle until an outstanding miss is ready to fill
+  auto wakeup = champsim::chrono::clock::time_point::max();
+  for (const auto& entry : MSHR) {
+    wakeup = std::min(wakeup, entry.data_promise.ready_time());
+  }
+  for (const auto& entry : inflight_writes) {
+    wakeup = std::min(wakeup, entry.data_promise.ready_time());
+  }
+  return wakeup;
+}
+
 // LCOV_EXCL_START exclude deprecated function
 uint64_t CACHE::get_set(uint64_t address) const { return static_cast<uint64_t>(get_set_index(champsim::address{address})); }
 // LCOV_EXCL_STOP
 
 long CACHE::get_set_index(champsim::address address) const { return address.slice(champsim::dynamic_extent{OFFSET_BITS, champsim::lg2(NUM_SET)}).to<long>(); }
 
+uint64_t CACHE::get_tag(champsim::address address) const { return address.slice_upper(OFFSET_BITS).to<uint64_t>(); }
+
+auto CACHE::find_valid_way(champsim::address address) -> set_type::iterator
+{
+  const auto set_idx = get_set_index(address);
+  assert(set_idx < NUM_SET);
+  const auto set_offset = static_cast<std::size_t>(set_idx) * NUM_WAY;
+  const auto way_idx = champsim::find_first_equal(std::data(block_tags) + set_offset, NUM_WAY, get_tag(address));
+
+  // An address whose tag collides with the sentinel must not match an invalid block
+  if (way_idx == NUM_WAY || !block[set_offset + way_idx].valid) {
+    return std::next(std::begin(block), static_cast<set_type::difference_type>(set_offset + NUM_WAY));
+  }
+  return std::next(std::begin(block), static_cast<set_type::difference_type>(set_offset + way_idx));
+}
+
+void CACHE::update_tag(set_type::iterator way)
+{
+  block_tags[static_cast<std::size_t>(std::distance(std::begin(block), way))] = way->valid ? get_tag(way->address) : invalid_tag;
+}
+
 template <typename It>
 std::pair<It, It> get_span(It anchor, typename std::iterator_traits<It>::difference_type set_idx, typename std::iterator_traits<It>::difference_type num_way)
 {
@@ -672,6 +734,7 @@ long CACHE::invalidate_entry(champsim::address inval_addr)
 
   if (inv_way != end) {
     inv_way->valid = false;
+    update_tag(inv_way);
   }
 
   return std::distance(begin, inv_way);
@@ -679,6 +742,8 @@ long CACHE::invalidate_entry(champsim::address inval_addr)
 
 bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t prefetch_metadata, champsim::capability cap)
 {
+  if (drop_redundant_prefetch(pf_addr))
+    return true;
   ++sim_stats.pf_requested;
   if (std::size(internal_PQ) >= PQ_SIZE)
     return false;
@@ -693,6 +758,8 @@ bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint3
   pf_packet.cap = cap;
 
   internal_PQ.emplace_back(pf_packet, true, !fill_this_level);
+  if (fill_this_level)
+    pf_filter.insert(get_tag(pf_addr));
   ++sim_stats.pf_issued;
   return true;
 }
@@ -700,6 +767,8 @@ bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint3
 
 bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t pf_cpu, champsim::address pf_ip, uint32_t prefetch_metadata, champsim::capability cap)
 {
+  if (drop_redundant_prefetch(pf_addr))
+    return true;
   ++sim_stats.pf_requested;
   if (std::size(internal_PQ) >= PQ_SIZE)
     return false;
@@ -715,6 +784,8 @@ bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint3
   pf_packet.ip = pf_ip;
 
   internal_PQ.emplace_back(pf_packet, true, !fill_this_level);
+  if (fill_this_level)
+    pf_filter.insert(get_tag(pf_addr));
   ++sim_stats.pf_issued;
   return true;
 }
@@ -722,6 +793,8 @@ bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint3
 
 bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t prefetch_metadata)
 {
+  if (drop_redundant_prefetch(pf_addr))
+    return true;
   ++sim_stats.pf_requested;
   if (std::size(internal_PQ) >= PQ_SIZE)
     return false;
@@ -735,11 +808,36 @@ bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint3
   pf_packet.is_translated = !virtual_prefetch;
 
   internal_PQ.emplace_back(pf_packet, true, !fill_this_level);
+  if (fill_this_level)
+    pf_filter.insert(get_tag(pf_addr));
   ++sim_stats.pf_issued;
   return true;
 }
 
 
+// Only prefetches that fill this level are entered in the filter, since their fills are what remove them from it
+bool CACHE::drop_redundant_prefetch(champsim::address pf_addr)
+{
+  if (pf_filter.size() == 0) {
+    return false;
+  }
+
+  // A virtual prefetch address cannot be compared with the blocks or the MSHRs until it is translated
+  if (!virtual_prefetch && find_valid_way(pf_addr) != get_set_span(pf_addr).second) {
+    ++sim_stats.pf_dropped_resident;
+    return true;
+  }
+  if (!virtual_prefetch && MSHR.count(pf_addr) > 0) {
+    ++sim_stats.pf_dropped_inflight;
+    return true;
+  }
+  if (pf_filter.contains(get_tag(pf_addr))) {
+    ++sim_stats.pf_dropped_recent;
+    return true;
+  }
+  return false;
+}
+
 // LCOV_EXCL_START exclude deprecated function
 bool CACHE::prefetch_line(uint64_t pf_addr, bool fill_this_level, uint32_t prefetch_metadata)
 {
@@ -755,7 +853,7 @@ bool CACHE::prefetch_line(uint64_t /*deprecated*/, uint64_t /*deprecated*/, uint
 void CACHE::finish_packet(const response_type& packet)
 {
   // check MSHR information
-  auto mshr_entry = std::find_if(std::begin(MSHR), std::end(MSHR), matches_address(packet.address));
+  auto mshr_entry = MSHR.find(packet.address);
   auto first_unreturned = std::find_if(MSHR.begin(), MSHR.end(), [](auto x) { return x.data_promise.has_unknown_readiness(); });
 
   // sanity check
@@ -806,26 +904,31 @@ void CACHE::finish_translation(const response_type& packet)
   }
 }
 
+auto CACHE::translation_request(const tag_lookup_type& q_entry) const -> request_type
+{
+  request_type fwd_pkt;
+  fwd_pkt.asid[0] = q_entry.asid[0];
+  fwd_pkt.asid[1] = q_entry.asid[1];
+  fwd_pkt.type = access_type::LOAD;
+  fwd_pkt.cpu = q_entry.cpu;
+  fwd_pkt.cap = q_entry.cap;
+
+  fwd_pkt.address = q_entry.address;
+  fwd_pkt.v_address = q_entry.v_address;
+  fwd_pkt.data = q_entry.data;
+  fwd_pkt.instr_id = q_entry.instr_id;
+  fwd_pkt.ip = q_entry.ip;
+
+  fwd_pkt.instr_depend_on_me = q_entry.instr_depend_on_me;
+  fwd_pkt.is_translated = true;
+
+  return fwd_pkt;
+}
+
 void CACHE::issue_translation(tag_lookup_type& q_entry) const
 {
   if (!q_entry.translate_issued && !q_entry.is_translated) {
-    request_type fwd_pkt;
-    fwd_pkt.asid[0] = q_entry.asid[0];
-    fwd_pkt.asid[1] = q_entry.asid[1];
-    fwd_pkt.type = access_type::LOAD;
-    fwd_pkt.cpu = q_entry.cpu;
-    fwd_pkt.cap = q_entry.cap;
-
-    fwd_pkt.address = q_entry.address;
-    fwd_pkt.v_address = q_entry.v_address;
-    fwd_pkt.data = q_entry.data;
-    fwd_pkt.instr_id = q_entry.instr_id;
-    fwd_pkt.ip = q_entry.ip;
-
-    fwd_pkt.instr_depend_on_me = q_entry.instr_depend_on_me;
-    fwd_pkt.is_translated = true;
-
-    q_entry.translate_issued = lower_translate->add_rq(fwd_pkt);
+    q_entry.translate_issued = lower_translate->add_rq(translation_request(q_entry));
     if constexpr (champsim::debug_print) {
       if (q_entry.translate_issued) {
         fmt::print("[TRANSLATE] do_issue_translation instr_id: {} paddr: {} vaddr: {} type: {}\n", q_entry.instr_id, q_entry.address, q_entry.v_address,
@@ -835,6 +938,161 @@ void CACHE::issue_translation(tag_lookup_type& q_entry) const
   }
 }
 
+void CACHE::warm_translate(tag_lookup_type& q_entry, champsim::functional_warmer& warmer) const
+{
+  if (!q_entry.is_translated) {
+    assert(lower_translate != nullptr);
+    auto translation = warmer.access(lower_translate, translation_request(q_entry));
+    q_entry.address = champsim::address{champsim::splice(champsim::page_number{translation.data}, champsim::page_offset{q_entry.v_address})};
+    q_entry.is_translated = true;
+  }
+}
+
+auto CACHE::warm_lookup(tag_lookup_type handle_pkt, champsim::functional_warmer& warmer) -> response_type
+{
+  champsim::channel::response_queue returned{};
+  handle_pkt.to_return = {&returned};
+
+  if (try_hit(handle_pkt)) {
+    return returned.front();
+  }
+
+  record_reuse(handle_pkt);
+
+  mshr_type fill_mshr{handle_pkt, current_time};
+  mshr_type::returned_value fill_value{handle_pkt.data, handle_pkt.pf_metadata};
+
+  // Writebacks fill without reading the lower level, as in handle_write()
+  if (handle_pkt.type != access_type::WRITE || match_offset_bits) {
+    auto fwd_pkt = mshr_and_forward_packet(handle_pkt).second;
+    auto response = warmer.access(lower_level, fwd_pkt);
+    if (!fwd_pkt.response_requested) {
+      return response;
+    }
+    fill_value = {response.data, response.pf_metadata};
+  }
+
+  fill_mshr.data_promise = champsim::waitable{fill_value, current_time};
+  [[maybe_unused]] const bool filled = handle_fill(fill_mshr);
+  assert(filled);
+
+  // Send the writeback of the victim, if there was one
+  while (!std::empty(lower_level->WQ)) {
+    auto writeback = lower_level->WQ.front();
+    lower_level->WQ.pop_front();
+    warmer.access(lower_level, writeback);
+  }
+
+  return returned.front();
+}
+
+auto CACHE::warm_access(const request_type& pkt, champsim::functional_warmer& warmer) -> response_type
+{
+  tag_lookup_type handle_pkt{pkt};
+  warm_translate(handle_pkt, warmer);
+  auto response = warm_lookup(handle_pkt, warmer);
+
+  // Issue the prefetches requested so far. Those requested while these are handled wait for the next access.
+  for (auto pf_count = std::size(internal_PQ); pf_count > 0; --pf_count) {
+    auto pf_pkt = internal_PQ.front();
+    internal_PQ.pop_front();
+    warm_translate(pf_pkt, warmer);
+    warm_lookup(pf_pkt, warmer);
+  }
+
+  return response;
+}
+
+void CACHE::profile_reuse(double sample_rate) { reuse_profile.emplace(sample_rate); }
+
+void CACHE::record_reuse(const tag_lookup_type& handle_pkt)
+{
+  if (!reuse_profile.has_value()) {
+    return;
+  }
+
+  if (auto bucket = reuse_profile->access(get_tag(handle_pkt.address)); bucket.has_value()) {
+    sim_stats.reuse_distances.increment(reuse_key{static_cast<unsigned>(*bucket), classify_capability(handle_pkt.cap), handle_pkt.type, handle_pkt.cpu});
+  }
+}
+
+namespace
+{
+// The blocks are written field by field, so that their padding never reaches a checkpoint
+void save_block(champsim::checkpoint_writer& out, const champsim::cache_block& blk)
+{
+  out.write(blk.valid);
+  out.write(blk.prefetch);
+  out.write(blk.dirty);
+  out.write(blk.cpu);
+  out.write(blk.address.to<uint64_t>());
+  out.write(blk.v_address.to<uint64_t>());
+  out.write(blk.data.to<uint64_t>());
+  out.write(blk.auth_cap.offset.to<uint64_t>());
+  out.write(blk.auth_cap.base.to<uint64_t>());
+  out.write(blk.auth_cap.length.to<uint64_t>());
+  out.write(blk.auth_cap.permissions);
+  out.write(blk.auth_cap.tag);
+  out.write(blk.pf_metadata);
+}
+
+champsim::address read_address(champsim::checkpoint_reader& in)
+{
+  uint64_t value{};
+  in.read(value);
+  return champsim::address{value};
+}
+
+void load_block(champsim::checkpoint_reader& in, champsim::cache_block& blk)
+{
+  in.read(blk.valid);
+  in.read(blk.prefetch);
+  in.read(blk.dirty);
+  in.read(blk.cpu);
+  blk.address = read_address(in);
+  blk.v_address = read_address(in);
+  blk.data = read_address(in);
+  blk.auth_cap.offset = read_address(in);
+  blk.auth_cap.base = read_address(in);
+  blk.auth_cap.length = read_address(in);
+  in.read(blk.auth_cap.permissions);
+  in.read(blk.auth_cap.tag);
+  in.read(blk.pf_metadata);
+}
+} // namespace
+
+void CACHE::save_state(champsim::checkpoint_writer& out) const
+{
+  out.write(NUM_SET);
+  out.write(NUM_WAY);
+  for (const auto& blk : block) {
+    save_block(out, blk);
+  }
+  out.write_section("prefetcher", [this](auto& section) { impl_prefetcher_save_state(section); });
+  out.write_section("replacement", [this](auto& section) { impl_replacement_save_state(section); });
+}
+
+void CACHE::load_state(champsim::checkpoint_reader& in)
+{
+  decltype(NUM_SET) saved_sets{};
+  decltype(NUM_WAY) saved_ways{};
+  in.read(saved_sets);
+  in.read(saved_ways);
+  if (saved_sets != NUM_SET || saved_ways != NUM_WAY) {
+    throw std::runtime_error{fmt::format("{} has {} sets and {} ways, but the checkpoint has {} sets and {} ways", NAME, NUM_SET, NUM_WAY, saved_sets,
+                                         saved_ways)};
+  }
+
+  for (auto way = std::begin(block); way != std::end(block); ++way) {
+    load_block(in, *way);
+    update_tag(way);
+  }
+
+  auto sections = in.read_sections();
+  impl_prefetcher_load_state(sections.at("prefetcher"));
+  impl_replacement_load_state(sections.at("replacement"));
+}
+
 std::size_t CACHE::get_mshr_occupancy() const { return std::size(MSHR); }
 
 std::vector<std::size_t> CACHE::get_rq_occupancy() const
@@ -955,6 +1213,8 @@ uint32_t CACHE::impl_prefetcher_cache_fill(champsim::address addr, champsim::add
 
 void CACHE::impl_prefetcher_cycle_operate() const { pref_module_pimpl->impl_prefetcher_cycle_operate(); }
 
+bool CACHE::impl_prefetcher_has_cycle_operate() const { return pref_module_pimpl->impl_prefetcher_has_cycle_operate(); }
+
 void CACHE::impl_prefetcher_final_stats() const { pref_module_pimpl->impl_prefetcher_final_stats(); }
 
 void CACHE::impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target) const
@@ -962,6 +1222,10 @@ void CACHE::impl_prefetcher_branch_operate(champsim::address ip, uint8_t branch_
   pref_module_pimpl->impl_prefetcher_branch_operate(ip, branch_type, branch_target);
 }
 
+void CACHE::impl_prefetcher_save_state(champsim::checkpoint_writer& out) const { pref_module_pimpl->impl_prefetcher_save_state(out); }
+
+void CACHE::impl_prefetcher_load_state(champsim::checkpoint_reader& in) const { pref_module_pimpl->impl_prefetcher_load_state(in); }
+
 void CACHE::impl_initialize_replacement() const { repl_module_pimpl->impl_initialize_replacement(); }
 
 long CACHE::impl_find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const BLOCK* current_set, champsim::address ip, champsim::address full_addr,
@@ -984,8 +1248,21 @@ void CACHE::impl_replacement_cache_fill(uint32_t triggering_cpu, long set, long
 
 void CACHE::impl_replacement_final_stats() const { repl_module_pimpl->impl_replacement_final_stats(); }
 
+void CACHE::impl_replacement_save_state(champsim::checkpoint_writer& out) const { repl_module_pimpl->impl_replacement_save_state(out); }
+
+void CACHE::impl_replacement_load_state(champsim::checkpoint_reader& in) const { repl_module_pimpl->impl_replacement_load_state(in); }
+
 void CACHE::initialize()
 {
+  // This cache is woken when its channels are given work
+  for (auto* ul : upper_levels) {
+    ul->queue_consumer = this;
+  }
+  lower_level->returned.consumer = this;
+  if (lower_translate != nullptr) {
+    lower_translate->returned.consumer = this;
+  }
+
   impl_prefetcher_initialize();
   impl_initialize_replacement();
 }
@@ -1021,6 +1298,9 @@ void CACHE::end_phase(unsigned finished_cpu)
 
   roi_stats.pf_requested = sim_stats.pf_requested;
   roi_stats.pf_issued = sim_stats.pf_issued;
+  roi_stats.pf_dropped_resident = sim_stats.pf_dropped_resident;
+  roi_stats.pf_dropped_inflight = sim_stats.pf_dropped_inflight;
+  roi_stats.pf_dropped_recent = sim_stats.pf_dropped_recent;
   roi_stats.pf_useful = sim_stats.pf_useful;
   roi_stats.pf_useless = sim_stats.pf_useless;
   roi_stats.pf_fill = sim_stats.pf_fill;
@@ -1031,6 +1311,7 @@ void CACHE::end_phase(unsigned finished_cpu)
   roi_stats.cap_data_misses = sim_stats.cap_data_misses;
   roi_stats.capabilities_per_cl_hit = sim_stats.capabilities_per_cl_hit;
   roi_stats.capabilities_per_cl_miss = sim_stats.capabilities_per_cl_miss;
+  roi_stats.reuse_distances = sim_stats.reuse_distances;
 
 
   for (auto* ul : upper_levels) {
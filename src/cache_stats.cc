@@ -1,10 +1,16 @@
 #include "cache_stats.h"
 
+#include <array>
+#include <numeric>
+
 cache_stats operator-(cache_stats lhs, cache_stats rhs)
 {
   cache_stats result;
   result.pf_requested = lhs.pf_requested - rhs.pf_requested;
   result.pf_issued = lhs.pf_issued - rhs.pf_issued;
+  result.pf_dropped_resident = lhs.pf_dropped_resident - rhs.pf_dropped_resident;
+  result.pf_dropped_inflight = lhs.pf_dropped_inflight - rhs.pf_dropped_inflight;
+  result.pf_dropped_recent = lhs.pf_dropped_recent - rhs.pf_dropped_recent;
   result.pf_useful = lhs.pf_useful - rhs.pf_useful;
   result.pf_useless = lhs.pf_useless - rhs.pf_useless;
   result.pf_fill = lhs.pf_fill - rhs.pf_fill;
@@ -19,8 +25,65 @@ cache_stats operator-(cache_stats lhs, cache_stats rhs)
   
   result.capabilities_per_cl_hit = lhs.capabilities_per_cl_hit - rhs.capabilities_per_cl_hit;
   result.capabilities_per_cl_miss = lhs.capabilities_per_cl_miss - rhs.capabilities_per_cl_miss;
+  result.reuse_distances = lhs.reuse_distances - rhs.reuse_distances;
   
   result.total_miss_latency_cycles = lhs.total_miss_latency_cycles - rhs.total_miss_latency_cycles;
 
   return result;
 }
+
+cache_stats operator+(cache_stats lhs, cache_stats rhs)
+{
+  lhs.pf_requested += rhs.pf_requested;
+  lhs.pf_issued += rhs.pf_issued;
+  lhs.pf_dropped_resident += rhs.pf_dropped_resident;
+  lhs.pf_dropped_inflight += rhs.pf_dropped_inflight;
+  lhs.pf_dropped_recent += rhs.pf_dropped_recent;
+  lhs.pf_useful += rhs.pf_useful;
+  lhs.pf_useless += rhs.pf_useless;
+  lhs.pf_fill += rhs.pf_fill;
+
+  lhs.hits.merge(rhs.hits);
+  lhs.misses.merge(rhs.misses);
+  lhs.mshr_merge.merge(rhs.mshr_merge);
+  lhs.mshr_return.merge(rhs.mshr_return);
+
+  lhs.cap_auth_hits.merge(rhs.cap_auth_hits);
+  lhs.cap_auth_misses.merge(rhs.cap_auth_misses);
+  lhs.cap_data_hits.merge(rhs.cap_data_hits);
+  lhs.cap_data_misses.merge(rhs.cap_data_misses);
+
+  lhs.capabilities_per_cl_hit.merge(rhs.capabilities_per_cl_hit);
+  lhs.capabilities_per_cl_miss.merge(rhs.capabilities_per_cl_miss);
+  lhs.reuse_distances.merge(rhs.reuse_distances);
+
+  lhs.total_miss_latency_cycles += rhs.total_miss_latency_cycles;
+
+  return lhs;
+}
+
+std::vector<double> miss_ratio_curve(const cache_stats::reuse_counter& distances, std::remove_cv_t<decltype(NUM_CPUS)> cpu,
+                                     const std::function<bool(cap_size_coverage_events, access_type)>& select)
+{
+  std::array<long, NUM_REUSE_BUCKETS> histogram{};
+  for (auto key : distances.get_keys()) {
+    auto [bucket, size, type, key_cpu] = key;
+    if (key_cpu == cpu && select(size, type)) {
+      histogram.at(bucket) += distances.value_or(key, 0);
+    }
+  }
+
+  auto total = std::accumulate(std::begin(histogram), std::end(histogram), long{});
+  if (total == 0) {
+    return {};
+  }
+
+  // A cache of 2^k blocks hits the accesses in buckets 0 through k
+  std::vector<double> curve;
+  long hits = 0;
+  for (std::size_t k = 0; k < champsim::reuse_profiler::cold_bucket; ++k) {
+    hits += histogram.at(k);
+    curve.push_back(static_cast<double>(total - hits) / static_cast<double>(total));
+  }
+  return curve;
+}
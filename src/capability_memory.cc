@@ -16,6 +16,23 @@
 
 #include "capability_memory.h"
 
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <fmt/core.h>
+
+#include "util/bits.h"
+
 namespace champsim {
 
 std::vector<capability_memory> cap_mem;
@@ -27,11 +44,11 @@ void initialize_capability_memory(size_t num_cpus)
 }
 
 
-capability capability_memory::rebuild(const presimpoint_entry& e) const
+capability capability_memory::rebuild(const line_slot& slot, std::size_t granule) const
 {
-  const auto& cap_ = cap_table_[e.cap_id];
+  const auto& cap_ = cap_table_[slot.cap_ids[granule]];
   return capability{
-      champsim::address{e.offset},
+      champsim::address{slot.offsets[granule]},
       champsim::address{cap_.base},
       champsim::address{cap_.length},
       cap_.permissions,
@@ -39,15 +56,108 @@ capability capability_memory::rebuild(const presimpoint_entry& e) const
   };
 }
 
-const capability_memory::presimpoint_entry* capability_memory::find_in_presimpoint(uint64_t key) const
+auto capability_memory::find_slot(uint64_t line_key) const -> const line_slot*
+{
+  if (occupied_ == 0)
+    return nullptr;
+
+  const auto mask = num_slots_ - 1;
+  for (auto idx = home_slot(line_key);; idx = (idx + 1) & mask) {
+    const auto& slot = slots_[idx];
+    if (slot.line_key == line_key)
+      return &slot;
+    if (slot.line_key == empty_key)
+      return nullptr;
+  }
+}
+
+auto capability_memory::emplace_slot(uint64_t line_key) -> line_slot&
+{
+  if (static_cast<double>(occupied_ + 1) > max_load_factor * static_cast<double>(num_slots_))
+    reserve_slots(2 * (occupied_ + 1));
+
+  const auto mask = num_slots_ - 1;
+  auto idx = home_slot(line_key);
+  while (slots_[idx].line_key != empty_key && slots_[idx].line_key != line_key)
+    idx = (idx + 1) & mask;
+
+  if (slots_[idx].line_key == empty_key) {
+    slots_[idx].line_key = line_key;
+    ++occupied_;
+  }
+  return slots_[idx];
+}
+
+uint32_t capability_memory::intern(const capability& cap)
+{
+  cap_descriptor desc{cap.base.to<uint64_t>(), cap.length.to<uint64_t>(), cap.permissions};
+
+  // A loaded table arrives without its index
+  if (std::empty(region_cap_ids_) && !std::empty(cap_table_)) {
+    region_cap_ids_.reserve(std::size(cap_table_));
+    for (std::size_t i = 0; i < std::size(cap_table_); ++i)
+      region_cap_ids_.try_emplace(cap_table_[i], static_cast<uint32_t>(i));
+  }
+
+  auto [it, inserted] = region_cap_ids_.try_emplace(desc, static_cast<uint32_t>(cap_table_.size()));
+  if (inserted)
+    cap_table_.push_back(desc);
+  return it->second;
+}
+
+void capability_memory::reserve_slots(std::size_t count)
 {
-  auto it = std::lower_bound(
-      presimpoint_entries_.begin(), presimpoint_entries_.end(), key,
-      [](const presimpoint_entry& entry, uint64_t k) { return entry.va_key < k; });
+  auto capacity = champsim::next_pow2(std::max<std::size_t>(16, static_cast<std::size_t>(static_cast<double>(count) / max_load_factor) + 1));
+  if (capacity <= num_slots_)
+    return;
 
-  if (it != presimpoint_entries_.end() && it->va_key == key)
-    return &(*it);
-  return nullptr;
+  // The old slots may be in a snapshot mapping, which is released once they have been copied out
+  std::vector<line_slot> old_owned(capacity);
+  owned_slots_.swap(old_owned);
+  auto old_mapping = std::move(snapshot_mapping_);
+  const line_slot* old_slots = std::exchange(slots_, std::data(owned_slots_));
+  const auto old_num_slots = std::exchange(num_slots_, capacity);
+  slot_shift_ = static_cast<unsigned>(64 - champsim::lg2(capacity));
+  occupied_ = 0;
+
+  for (std::size_t i = 0; i < old_num_slots; ++i) {
+    if (old_slots[i].line_key != empty_key)
+      emplace_slot(old_slots[i].line_key) = old_slots[i];
+  }
+}
+
+void capability_memory::erase_slot(const line_slot* slot)
+{
+  // Backward-shift deletion: pull later members of the probe sequence into the hole, so no tombstones are needed
+  const auto mask = num_slots_ - 1;
+  auto hole = static_cast<std::size_t>(std::distance(static_cast<const line_slot*>(slots_), slot));
+  for (auto idx = (hole + 1) & mask; slots_[idx].line_key != empty_key; idx = (idx + 1) & mask) {
+    auto home = home_slot(slots_[idx].line_key);
+    if (((idx - home) & mask) >= ((idx - hole) & mask)) {
+      slots_[hole] = slots_[idx];
+      hole = idx;
+    }
+  }
+
+  slots_[hole] = line_slot{};
+  --occupied_;
+}
+
+void capability_memory::erase_granule(uint64_t key)
+{
+  const auto* found = find_slot(line_of(key));
+  if (found == nullptr)
+    return;
+
+  auto& slot = slots_[static_cast<std::size_t>(std::distance(static_cast<const line_slot*>(slots_), found))];
+  const auto bit = static_cast<uint8_t>(1u << granule_in_line(key));
+  if ((slot.tag_mask & bit) == 0)
+    return;
+
+  slot.tag_mask = static_cast<uint8_t>(slot.tag_mask & ~bit);
+  --tagged_granules_;
+  if (slot.tag_mask == 0)
+    erase_slot(&slot);
 }
 
 void capability_memory::finalize()
@@ -55,42 +165,296 @@ void capability_memory::finalize()
   if (finalized_)
     return;
 
-  std::unordered_map<cap_descriptor, uint32_t, cap_descriptor_hash> prune;
-  prune.reserve(128 * 1024);
+  region_cap_ids_.reserve(128 * 1024);
   cap_table_.reserve(128 * 1024);
-
-  presimpoint_entries_.reserve(presimpoint_map_.size());
+  reserve_slots(presimpoint_map_.size());
 
   for (const auto& [key, cap] : presimpoint_map_) {
-    cap_descriptor desc{cap.base.to<uint64_t>(),
-                           cap.length.to<uint64_t>(),
-                           cap.permissions};
-
-    auto [it, inserted] = prune.try_emplace(desc, static_cast<uint32_t>(cap_table_.size()));
-    if (inserted)
-      cap_table_.push_back(desc);
-
-    presimpoint_entries_.push_back({key, cap.offset.to<uint64_t>(), it->second});
+    auto& slot = emplace_slot(line_of(key));
+    auto granule = granule_in_line(key);
+    slot.offsets[granule] = cap.offset.to<uint64_t>();
+    slot.cap_ids[granule] = intern(cap);
+    slot.tag_mask = static_cast<uint8_t>(slot.tag_mask | (1u << granule));
+    ++tagged_granules_;
   }
 
+  // The index is kept, so that stores during the simulation reuse the descriptors they share
   std::unordered_map<uint64_t, capability>().swap(presimpoint_map_);
-  std::unordered_map<cap_descriptor, uint32_t, cap_descriptor_hash>().swap(prune);
-
-  std::sort(presimpoint_entries_.begin(), presimpoint_entries_.end());
-  presimpoint_entries_.shrink_to_fit();
-  cap_table_.shrink_to_fit();
 
   finalized_ = true;
 
-  double entry_mb = static_cast<double>(presimpoint_entries_.size() * sizeof(presimpoint_entry)) / (1024.0 * 1024.0);
+  double entry_mb = static_cast<double>(num_slots_ * sizeof(line_slot)) / (1024.0 * 1024.0);
   double table_mb = static_cast<double>(cap_table_.size() * sizeof(cap_descriptor)) / (1024.0 * 1024.0);
 
-  fmt::print("[CAP_MEM] finalize: {} entries, {} unique caps "
+  fmt::print("[CAP_MEM] finalize: {} entries in {} lines, {} unique caps "
              "(entries: {:.1f} MB, caps: {:.1f} MB, total: {:.1f} MB)\n",
-             presimpoint_entries_.size(), cap_table_.size(),
+             tagged_granules_, occupied_, cap_table_.size(),
              entry_mb, table_mb, entry_mb + table_mb);
+
+  if (!snapshot_output_.empty())
+    save_snapshot(snapshot_output_, snapshot_source_);
+}
+
+namespace {
+constexpr std::size_t trace_identity_block = 1 << 16;
+
+// FNV-1a
+uint64_t hash_bytes(uint64_t hash, const char* first, const char* last)
+{
+  for (; first != last; ++first) {
+    hash ^= static_cast<unsigned char>(*first);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+} // namespace
+
+trace_identity trace_identity::of(const std::string& fname)
+{
+  std::ifstream in{fname, std::ios::binary | std::ios::ate};
+  if (!in)
+    throw std::runtime_error{fmt::format("Could not open trace {}: {}", fname, std::strerror(errno))};
+
+  trace_identity result{static_cast<uint64_t>(in.tellg()), 0xcbf29ce484222325ULL};
+  std::vector<char> block(trace_identity_block);
+  for (auto position : {uint64_t{0}, result.size > trace_identity_block ? result.size - trace_identity_block : uint64_t{0}}) {
+    in.seekg(static_cast<std::streamoff>(position));
+    in.read(std::data(block), static_cast<std::streamsize>(std::size(block)));
+    result.hash = hash_bytes(result.hash, std::data(block), std::next(std::data(block), in.gcount()));
+    in.clear();
+  }
+  return result;
+}
+
+namespace {
+constexpr std::array<char, 8> snapshot_magic{'C', 'H', 'S', 'M', 'C', 'A', 'P', 'S'};
+constexpr uint32_t snapshot_version = 2;
+constexpr uint32_t snapshot_byte_order = 0x01020304;
+
+// The header occupies the first block of the file, so that the slot table that follows it is aligned in the mapping
+struct snapshot_header {
+  std::array<char, 8> magic;
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t slot_size;
+  uint32_t descriptor_size;
+  uint64_t num_slots;
+  uint64_t occupied;
+  uint64_t tagged_granules;
+  uint64_t num_descriptors;
+  uint64_t trace_size;
+  uint64_t trace_hash;
+};
+constexpr std::size_t snapshot_header_size = 128;
+static_assert(sizeof(snapshot_header) <= snapshot_header_size);
+
+// Copy a field into its place in the image of the object that holds it
+template <typename Field>
+void place(char* image, std::size_t offset, const Field& field)
+{
+  std::memcpy(image + offset, &field, sizeof(Field));
+}
+
+// A snapshot is mapped as the table itself, so the structures are written as they are laid out in memory, but with their padding zeroed
+template <typename Slot>
+std::array<char, sizeof(Slot)> slot_image(const Slot& slot)
+{
+  std::array<char, sizeof(Slot)> image{};
+  place(std::data(image), offsetof(Slot, line_key), slot.line_key);
+  place(std::data(image), offsetof(Slot, offsets), slot.offsets);
+  place(std::data(image), offsetof(Slot, cap_ids), slot.cap_ids);
+  place(std::data(image), offsetof(Slot, tag_mask), slot.tag_mask);
+  return image;
+}
+
+template <typename Descriptor>
+std::array<char, sizeof(Descriptor)> descriptor_image(const Descriptor& descriptor)
+{
+  std::array<char, sizeof(Descriptor)> image{};
+  place(std::data(image), offsetof(Descriptor, base), descriptor.base);
+  place(std::data(image), offsetof(Descriptor, length), descriptor.length);
+  place(std::data(image), offsetof(Descriptor, permissions), descriptor.permissions);
+  return image;
+}
+} // namespace
+
+void capability_memory::save_snapshot(const std::string& fname, const trace_identity& source) const
+{
+  if (!finalized_)
+    throw std::logic_error{"Capability memory must be finalized before it is saved"};
+
+  snapshot_header header{snapshot_magic, snapshot_version, snapshot_byte_order, sizeof(line_slot), sizeof(cap_descriptor), num_slots_, occupied_,
+                         tagged_granules_, std::size(cap_table_), source.size, source.hash};
+  std::array<char, snapshot_header_size> header_block{};
+  std::memcpy(std::data(header_block), &header, sizeof(header));
+
+  // Write to a temporary name first, so that a concurrent run never maps a partial snapshot
+  const auto tmp_name = fname + ".tmp";
+  std::ofstream out{tmp_name, std::ios::binary | std::ios::trunc};
+  out.write(std::data(header_block), std::size(header_block));
+  for (std::size_t i = 0; i < num_slots_; ++i) {
+    const auto image = slot_image(slots_[i]);
+    out.write(std::data(image), std::size(image));
+  }
+  for (const auto& descriptor : cap_table_) {
+    const auto image = descriptor_image(descriptor);
+    out.write(std::data(image), std::size(image));
+  }
+  out.close();
+
+  if (!out || std::rename(tmp_name.c_str(), fname.c_str()) != 0)
+    throw std::runtime_error{fmt::format("Could not write capability snapshot {}: {}", fname, std::strerror(errno))};
+
+  fmt::print("[CAP_MEM] wrote snapshot {}\n", fname);
+}
+
+void capability_memory::load_snapshot(const std::string& fname, const trace_identity& source)
+{
+  auto fd = ::open(fname.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+  if (fd < 0)
+    throw std::runtime_error{fmt::format("Could not open capability snapshot {}: {}", fname, std::strerror(errno))};
+
+  struct stat file_info {};
+  if (::fstat(fd, &file_info) != 0) {
+    ::close(fd);
+    throw std::runtime_error{fmt::format("Could not stat capability snapshot {}: {}", fname, std::strerror(errno))};
+  }
+
+  const auto file_size = static_cast<std::size_t>(file_info.st_size);
+  snapshot_header header{};
+  if (file_size < snapshot_header_size || ::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+    ::close(fd);
+    throw std::runtime_error{fmt::format("Capability snapshot {} is truncated", fname)};
+  }
+
+  if (header.magic != snapshot_magic || header.version != snapshot_version || header.byte_order != snapshot_byte_order
+      || header.slot_size != sizeof(line_slot) || header.descriptor_size != sizeof(cap_descriptor) || !champsim::is_power_of_2(header.num_slots)
+      || file_size != snapshot_header_size + header.num_slots * sizeof(line_slot) + header.num_descriptors * sizeof(cap_descriptor)) {
+    ::close(fd);
+    throw std::runtime_error{fmt::format("Capability snapshot {} is not compatible with this build", fname)};
+  }
+
+  if (trace_identity{header.trace_size, header.trace_hash} != source) {
+    ::close(fd);
+    throw std::runtime_error{fmt::format("Capability snapshot {} was not built from this trace", fname)};
+  }
+
+  // A private, writable mapping: untouched pages are shared with every other run that maps this snapshot
+  void* mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+    throw std::runtime_error{fmt::format("Could not map capability snapshot {}: {}", fname, std::strerror(errno))};
+
+  clear();
+  snapshot_mapping_ = std::shared_ptr<void>{mapping, [file_size](void* ptr) { ::munmap(ptr, file_size); }};
+
+  auto* base = static_cast<char*>(mapping);
+  slots_ = reinterpret_cast<line_slot*>(base + snapshot_header_size); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  num_slots_ = header.num_slots;
+  slot_shift_ = static_cast<unsigned>(64 - champsim::lg2(num_slots_));
+  occupied_ = header.occupied;
+  tagged_granules_ = header.tagged_granules;
+
+  cap_table_.resize(header.num_descriptors);
+  std::memcpy(std::data(cap_table_), base + snapshot_header_size + num_slots_ * sizeof(line_slot), header.num_descriptors * sizeof(cap_descriptor));
+
+  finalized_ = true;
+
+  fmt::print("[CAP_MEM] loaded snapshot {}: {} entries in {} lines, {} unique caps\n", fname, tagged_granules_, occupied_, std::size(cap_table_));
 }
 
+// The structures are written field by field, so that their padding never reaches a checkpoint
+void capability_memory::save_state(champsim::checkpoint_writer& out) const
+{
+  out.write(finalized_);
+  if (!finalized_) {
+    out.write(std::size(presimpoint_map_));
+    for (const auto& [key, cap] : presimpoint_map_) {
+      out.write(key);
+      out.write(cap.offset.to<uint64_t>());
+      out.write(cap.base.to<uint64_t>());
+      out.write(cap.length.to<uint64_t>());
+      out.write(cap.permissions);
+      out.write(cap.tag);
+    }
+    return;
+  }
+
+  out.write(num_slots_);
+  for (std::size_t i = 0; i < num_slots_; ++i) {
+    out.write(slots_[i].line_key);
+    out.write(slots_[i].offsets);
+    out.write(slots_[i].cap_ids);
+    out.write(slots_[i].tag_mask);
+  }
+  out.write(occupied_);
+  out.write(tagged_granules_);
+  out.write(std::size(cap_table_));
+  for (const auto& descriptor : cap_table_) {
+    out.write(descriptor.base);
+    out.write(descriptor.length);
+    out.write(descriptor.permissions);
+  }
+}
+
+void capability_memory::load_state(champsim::checkpoint_reader& in)
+{
+  clear();
+
+  bool saved_finalized{};
+  in.read(saved_finalized);
+  if (!saved_finalized) {
+    std::size_t saved_granules{};
+    in.read(saved_granules);
+    for (std::size_t i = 0; i < saved_granules; ++i) {
+      uint64_t key{};
+      uint64_t offset{};
+      uint64_t base{};
+      uint64_t length{};
+      capability cap{};
+      in.read(key);
+      in.read(offset);
+      in.read(base);
+      in.read(length);
+      in.read(cap.permissions);
+      in.read(cap.tag);
+      cap.offset = champsim::address{offset};
+      cap.base = champsim::address{base};
+      cap.length = champsim::address{length};
+      presimpoint_map_.insert_or_assign(key, cap);
+    }
+    return;
+  }
+
+  // The tables grow as they are read, so that a corrupt count runs into the end of the checkpoint rather than allocating it all at once
+  std::size_t saved_slots{};
+  in.read(saved_slots);
+  if (saved_slots > 0 && !champsim::is_power_of_2(saved_slots))
+    throw std::runtime_error{"Checkpoint's capability table is not a power of 2 in size"};
+  for (std::size_t i = 0; i < saved_slots; ++i) {
+    auto& slot = owned_slots_.emplace_back();
+    in.read(slot.line_key);
+    in.read(slot.offsets);
+    in.read(slot.cap_ids);
+    in.read(slot.tag_mask);
+  }
+
+  slots_ = std::data(owned_slots_);
+  num_slots_ = std::size(owned_slots_);
+  slot_shift_ = num_slots_ > 0 ? static_cast<unsigned>(64 - champsim::lg2(num_slots_)) : 64;
+  in.read(occupied_);
+  in.read(tagged_granules_);
+
+  std::size_t saved_descriptors{};
+  in.read(saved_descriptors);
+  for (std::size_t i = 0; i < saved_descriptors; ++i) {
+    auto& descriptor = cap_table_.emplace_back();
+    in.read(descriptor.base);
+    in.read(descriptor.length);
+    in.read(descriptor.permissions);
+  }
+  finalized_ = true;
+}
 
 void capability_memory::store_capability(champsim::address addr, const capability& cap)
 {
@@ -104,12 +468,19 @@ void capability_memory::store_capability(champsim::address addr, const capabilit
     return;
   }
 
-  if (cap.tag) {
-    simpoint_region_map_[key] = cap;
-    invalidated_keys_.erase(key);
-  } else {
-    invalidate_tag(addr);
+  if (!cap.tag) {
+    erase_granule(key);
+    return;
   }
+
+  auto cap_id = intern(cap);
+  auto& slot = emplace_slot(line_of(key));
+  auto granule = granule_in_line(key);
+  if (((slot.tag_mask >> granule) & 1u) == 0)
+    ++tagged_granules_;
+  slot.offsets[granule] = cap.offset.to<uint64_t>();
+  slot.cap_ids[granule] = cap_id;
+  slot.tag_mask = static_cast<uint8_t>(slot.tag_mask | (1u << granule));
 }
 
 
@@ -124,20 +495,9 @@ std::optional<capability> capability_memory::load_capability(champsim::address a
     return std::nullopt;
   }
 
-  // simpoint region writes take priority.
-  auto rt = simpoint_region_map_.find(key);
-  if (rt != simpoint_region_map_.end()) {
-    if (rt->second.tag)
-      return rt->second;
-    return std::nullopt;
-  }
-
-  if (!invalidated_keys_.empty() && invalidated_keys_.count(key))
-    return std::nullopt;
-
-  const presimpoint_entry* entry = find_in_presimpoint(key);
-  if (entry)
-    return rebuild(*entry);
+  const line_slot* slot = find_slot(line_of(key));
+  if (slot && ((slot->tag_mask >> granule_in_line(key)) & 1u))
+    return rebuild(*slot, granule_in_line(key));
 
   return std::nullopt;
 }
@@ -151,14 +511,8 @@ bool capability_memory::has_capability(champsim::address addr) const
     return it != presimpoint_map_.end() && it->second.tag;
   }
 
-  auto rt = simpoint_region_map_.find(key);
-  if (rt != simpoint_region_map_.end())
-    return rt->second.tag;
-
-  if (!invalidated_keys_.empty() && invalidated_keys_.count(key))
-    return false;
-
-  return find_in_presimpoint(key) != nullptr;
+  const line_slot* slot = find_slot(line_of(key));
+  return slot && ((slot->tag_mask >> granule_in_line(key)) & 1u);
 }
 
 void capability_memory::invalidate_tag(champsim::address addr)
@@ -170,10 +524,43 @@ void capability_memory::invalidate_tag(champsim::address addr)
     return;
   }
 
-  simpoint_region_map_.erase(key);
+  erase_granule(key);
+}
+
+auto capability_memory::load_line(champsim::address addr) const -> line_capabilities
+{
+  line_capabilities result;
+  const auto first_key = line_of(addr_to_key(addr)) << (LINE_BITS - CAP_ALIGNMENT_BITS);
+
+  if (!finalized_) {
+    for (std::size_t granule = 0; granule < GRANULES_PER_LINE; ++granule) {
+      auto it = presimpoint_map_.find(first_key + granule);
+      if (it != presimpoint_map_.end() && it->second.tag) {
+        result.tag_mask = static_cast<uint8_t>(result.tag_mask | (1u << granule));
+        result.caps[granule] = it->second;
+      }
+    }
+    return result;
+  }
+
+  const line_slot* slot = find_slot(line_of(first_key));
+  if (slot) {
+    result.tag_mask = slot->tag_mask;
+    for (std::size_t granule = 0; granule < GRANULES_PER_LINE; ++granule) {
+      if ((slot->tag_mask >> granule) & 1u)
+        result.caps[granule] = rebuild(*slot, granule);
+    }
+  }
+  return result;
+}
+
+uint8_t capability_memory::line_tag_mask(champsim::address addr) const
+{
+  if (!finalized_)
+    return load_line(addr).tag_mask;
 
-  if (find_in_presimpoint(key))
-    invalidated_keys_.insert(key);
+  const line_slot* slot = find_slot(line_of(addr_to_key(addr)));
+  return slot ? slot->tag_mask : uint8_t{0};
 }
 
 
@@ -182,17 +569,22 @@ size_t capability_memory::size() const
   if (!finalized_)
     return presimpoint_map_.size();
 
-  return presimpoint_entries_.size() - invalidated_keys_.size() + simpoint_region_map_.size();
+  return tagged_granules_;
 }
 
 void capability_memory::clear()
 {
   std::unordered_map<uint64_t, capability>().swap(presimpoint_map_);
-  std::vector<presimpoint_entry>().swap(presimpoint_entries_);
+  std::vector<line_slot>().swap(owned_slots_);
+  snapshot_mapping_.reset();
+  slots_ = nullptr;
+  num_slots_ = 0;
   std::vector<cap_descriptor>().swap(cap_table_);
-  std::unordered_map<uint64_t, capability>().swap(simpoint_region_map_);
-  std::unordered_set<uint64_t>().swap(invalidated_keys_);
+  std::unordered_map<cap_descriptor, uint32_t, cap_descriptor_hash>().swap(region_cap_ids_);
+  occupied_ = 0;
+  tagged_granules_ = 0;
+  slot_shift_ = 64;
   finalized_ = false;
 }
 
-} // namespace champsim
\ No newline at end of file
+} // namespace champsim
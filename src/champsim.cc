@@ -18,12 +18,15 @@
 
 #include <algorithm>
 #include <chrono>
+#include <functional>
 #include <numeric>
 #include <vector>
 #include <fmt/chrono.h>
 #include <fmt/core.h>
 
+#include "checkpoint.h"
 #include "environment.h"
+#include "functional_warmer.h"
 #include "ooo_cpu.h"
 #include "operable.h"
 #include "phase_info.h"
@@ -39,20 +42,15 @@ namespace champsim
 {
 long do_cycle(environment& env, std::vector<tracereader>& traces, std::vector<std::size_t> trace_index, champsim::chrono::clock& global_clock)
 {
-  auto operables = env.operable_view();
-  std::sort(std::begin(operables), std::end(operables),
-            [](const champsim::operable& lhs, const champsim::operable& rhs) { return lhs.current_time < rhs.current_time; });
-
   // Operate
-  long progress{0};
-  for (champsim::operable& op : operables) {
-    progress += op.operate_on(global_clock);
-  }
+  long progress = env.scheduler_view().operate_on(global_clock);
 
   // Read from trace
+  // If the scheduler runs several ticks per call, the cores must have enough instructions buffered to last until the next call.
+  const auto ticks = env.scheduler_view().ticks_per_call();
   for (O3_CPU& cpu : env.cpu_view()) {
     auto& trace = traces.at(trace_index.at(cpu.cpu));
-    for (auto pkt_count = cpu.IN_QUEUE_SIZE - static_cast<long>(std::size(cpu.input_queue)); !trace.eof() && pkt_count > 0; --pkt_count) {
+    for (auto pkt_count = cpu.IN_QUEUE_SIZE * ticks - static_cast<long>(std::size(cpu.input_queue)); !trace.eof() && pkt_count > 0; --pkt_count) {
       cpu.input_queue.push_back(trace());
     }
   }
@@ -60,16 +58,116 @@ long do_cycle(environment& env, std::vector<tracereader>& traces, std::vector<st
   return progress;
 }
 
-phase_stats do_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock)
+phase_stats collect_phase_stats(const phase_info& phase, environment& env)
+{
+  phase_stats stats;
+  stats.name = phase.name;
+
+  for (std::size_t i = 0; i < std::size(phase.trace_index); ++i) {
+    stats.trace_names.push_back(phase.trace_names.at(phase.trace_index.at(i)));
+  }
+
+  auto cpus = env.cpu_view();
+  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.sim_cpu_stats), [](const O3_CPU& cpu) { return cpu.sim_stats; });
+  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.roi_cpu_stats), [](const O3_CPU& cpu) { return cpu.roi_stats; });
+
+  auto caches = env.cache_view();
+  std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.sim_cache_stats), [](const CACHE& cache) { return cache.sim_stats; });
+  std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.roi_cache_stats), [](const CACHE& cache) { return cache.roi_stats; });
+
+  auto dram = env.dram_view();
+  std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.sim_dram_stats),
+                 [](const DRAM_CHANNEL& chan) { return chan.sim_stats; });
+  std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.roi_dram_stats),
+                 [](const DRAM_CHANNEL& chan) { return chan.roi_stats; });
+
+  return stats;
+}
+
+// Warm the environment with the phase's instructions, calling cpu_finished() for each core as it reaches the end of the phase
+template <typename F>
+void run_functional_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, F&& cpu_finished)
+{
+  auto operables = env.operable_view();
+  auto [phase_name, is_warmup, length, trace_index, trace_names, is_functional, load_checkpoint_name, save_checkpoint_name, sample_period, sample_warmup,
+        sample_window] = phase;
+
+  // Initialize phase
+  for (champsim::operable& op : operables) {
+    op.warmup = is_warmup;
+    op.begin_phase();
+  }
+
+  champsim::functional_warmer warmer{env};
+
+  // Perform phase, one instruction from each core at a time so that the shared caches see the cores' accesses interleaved
+  std::vector<bool> phase_complete(std::size(env.cpu_view()), false);
+  while (!std::accumulate(std::begin(phase_complete), std::end(phase_complete), true, std::logical_and{})) {
+    auto next_phase_complete = phase_complete;
+
+    for (O3_CPU& cpu : env.cpu_view()) {
+      // Instructions left over from a timed phase are handled first
+      if (!std::empty(cpu.input_queue)) {
+        cpu.warm_instruction(cpu.input_queue.front(), warmer);
+        cpu.input_queue.pop_front();
+      } else if (auto& trace = traces.at(trace_index.at(cpu.cpu)); !trace.eof()) {
+        cpu.warm_instruction(trace(), warmer);
+      }
+    }
+
+    // If any trace reaches EOF, terminate all phases
+    if (std::any_of(std::begin(traces), std::end(traces), [](const auto& tr) { return tr.eof(); })) {
+      std::fill(std::begin(next_phase_complete), std::end(next_phase_complete), true);
+    }
+
+    // Check for phase finish
+    for (O3_CPU& cpu : env.cpu_view()) {
+      next_phase_complete[cpu.cpu] = next_phase_complete[cpu.cpu] || (cpu.sim_instr() >= length);
+    }
+
+    for (O3_CPU& cpu : env.cpu_view()) {
+      if (next_phase_complete[cpu.cpu] != phase_complete[cpu.cpu]) {
+        for (champsim::operable& op : operables) {
+          op.end_phase(cpu.cpu);
+        }
+
+        cpu_finished(cpu);
+      }
+    }
+
+    phase_complete = next_phase_complete;
+  }
+}
+
+phase_stats do_functional_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces)
+{
+  run_functional_phase(phase, env, traces, [&phase](const O3_CPU& cpu) {
+    fmt::print("{} finished CPU {} instructions: {} functional (Simulation time: {:%H hr %M min %S sec})\n", phase.name, cpu.cpu, cpu.sim_instr(),
+               elapsed_time());
+  });
+
+  for (O3_CPU& cpu : env.cpu_view()) {
+    fmt::print("{} complete CPU {} instructions: {} functional (Simulation time: {:%H hr %M min %S sec})\n", phase.name, cpu.cpu, cpu.sim_instr(),
+               elapsed_time());
+  }
+
+  return collect_phase_stats(phase, env);
+}
+
+// Simulate the phase's instructions in detail, calling cpu_finished() for each core as it reaches the end of the phase
+template <typename F>
+void run_timed_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock, F&& cpu_finished)
 {
   auto operables = env.operable_view();
-  auto [phase_name, is_warmup, length, trace_index, trace_names] = phase;
+  auto [phase_name, is_warmup, length, trace_index, trace_names, is_functional, load_checkpoint_name, save_checkpoint_name, sample_period, sample_warmup,
+        sample_window] = phase;
 
   // Initialize phase
   for (champsim::operable& op : operables) {
     op.warmup = is_warmup;
     op.begin_phase();
   }
+  env.scheduler_view().reset();
 
   const auto time_quantum = std::accumulate(std::cbegin(operables), std::cend(operables), champsim::chrono::clock::duration::max(),
                                             [](const auto acc, const operable& y) { return std::min(acc, y.clock_period); });
@@ -86,18 +184,26 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
   std::vector<bool> phase_complete(std::size(env.cpu_view()), false);
   while (!std::accumulate(std::begin(phase_complete), std::end(phase_complete), true, std::logical_and{})) {
     auto next_phase_complete = phase_complete;
-    global_clock.tick(time_quantum);
+    const auto ticks = env.scheduler_view().ticks_per_call();
+    global_clock.tick(ticks * time_quantum);
+
+    // Skip over ticks in which no operable would be woken. These would make no progress.
+    long skipped_ticks{0};
+    if (auto wakeup = env.scheduler_view().next_wakeup(); wakeup >= global_clock.now()) {
+      skipped_ticks = (wakeup - global_clock.now()) / time_quantum + 1;
+      global_clock.tick(skipped_ticks * time_quantum);
+    }
 
     auto progress = do_cycle(env, traces, trace_index, global_clock);
 
     if (progress == 0) {
-      ++stalled_cycle;
+      stalled_cycle += static_cast<int>(skipped_ticks + ticks);
     } else {
       stalled_cycle = 0;
     }
 
     // Livelock detect, every livelock_period cycles, check progress and alert the user
-    livelock_timer++;
+    livelock_timer += static_cast<uint64_t>(skipped_ticks + ticks);
     if (livelock_timer >= livelock_period) {
       // for each cpu
       for (O3_CPU& cpu : env.cpu_view()) {
@@ -143,39 +249,178 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
           op.end_phase(cpu.cpu);
         }
 
-        fmt::print("{} finished CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase_name, cpu.cpu,
-                   cpu.sim_instr(), cpu.sim_cycle(), std::ceil(cpu.sim_instr()) / std::ceil(cpu.sim_cycle()), elapsed_time());
+        cpu_finished(cpu);
       }
     }
 
     phase_complete = next_phase_complete;
   }
 
+  // Sleeping operables catch up, so that whatever follows the phase sees every operable at the current time
+  env.scheduler_view().reset();
+}
+
+phase_stats do_timed_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock)
+{
+  run_timed_phase(phase, env, traces, global_clock, [&phase](const O3_CPU& cpu) {
+    fmt::print("{} finished CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase.name, cpu.cpu,
+               cpu.sim_instr(), cpu.sim_cycle(), std::ceil(cpu.sim_instr()) / std::ceil(cpu.sim_cycle()), elapsed_time());
+  });
+
   for (O3_CPU& cpu : env.cpu_view()) {
-    fmt::print("{} complete CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase_name, cpu.cpu,
+    fmt::print("{} complete CPU {} instructions: {} cycles: {} cumulative IPC: {:.4g} (Simulation time: {:%H hr %M min %S sec})\n", phase.name, cpu.cpu,
                cpu.sim_instr(), cpu.sim_cycle(), std::ceil(cpu.sim_instr()) / std::ceil(cpu.sim_cycle()), elapsed_time());
   }
 
+  return collect_phase_stats(phase, env);
+}
+
+// The cores have retired every instruction they were given, and no cache has a miss or a write outstanding
+bool is_drained(environment& env)
+{
+  auto cpus = env.cpu_view();
+  auto caches = env.cache_view();
+  auto cpu_drained = [](const O3_CPU& cpu) {
+    return std::empty(cpu.input_queue) && std::empty(cpu.IFETCH_BUFFER) && std::empty(cpu.DECODE_BUFFER) && std::empty(cpu.DISPATCH_BUFFER)
+           && std::empty(cpu.ROB) && std::empty(cpu.SQ) && std::none_of(std::cbegin(cpu.LQ), std::cend(cpu.LQ), [](const auto& x) { return x.has_value(); });
+  };
+  // A page walk is only outstanding while a TLB waits for it in its MSHR
+  auto cache_drained = [](const CACHE& cache) {
+    return std::empty(cache.MSHR) && std::empty(cache.inflight_writes);
+  };
+  return std::all_of(std::begin(cpus), std::end(cpus), cpu_drained) && std::all_of(std::begin(caches), std::end(caches), cache_drained);
+}
+
+// Simulate, without reading any more of the traces, until the environment is drained
+void drain(environment& env, champsim::chrono::clock& global_clock)
+{
+  auto operables = env.operable_view();
+  const auto time_quantum = std::accumulate(std::cbegin(operables), std::cend(operables), champsim::chrono::clock::duration::max(),
+                                            [](const auto acc, const operable& y) { return std::min(acc, y.clock_period); });
+
+  env.scheduler_view().reset();
+  int stalled_cycle{0};
+  while (!is_drained(env)) {
+    const auto ticks = env.scheduler_view().ticks_per_call();
+    global_clock.tick(ticks * time_quantum);
+
+    long skipped_ticks{0};
+    if (auto wakeup = env.scheduler_view().next_wakeup(); wakeup >= global_clock.now()) {
+      skipped_ticks = (wakeup - global_clock.now()) / time_quantum + 1;
+      global_clock.tick(skipped_ticks * time_quantum);
+    }
+
+    if (env.scheduler_view().operate_on(global_clock) == 0) {
+      stalled_cycle += static_cast<int>(skipped_ticks + ticks);
+    } else {
+      stalled_cycle = 0;
+    }
+
+    if (stalled_cycle >= DEADLOCK_CYCLE) {
+      std::for_each(std::begin(operables), std::end(operables), [](champsim::operable& c) { c.print_deadlock(); });
+      abort();
+    }
+  }
+  env.scheduler_view().reset();
+}
+
+// Add the statistics of a detailed window to the sum over the windows so far
+template <typename T>
+void accumulate_window(std::vector<T>& total, const std::vector<T>& window)
+{
+  if (std::empty(total)) {
+    total = window;
+  } else {
+    std::transform(std::begin(total), std::end(total), std::begin(window), std::begin(total), std::plus<>{});
+  }
+}
+
+phase_stats do_sampled_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock)
+{
+  const phase_info functional{phase.name + " functional",
+                              true,
+                              phase.sample_period - phase.sample_warmup - phase.sample_window,
+                              phase.trace_index,
+                              phase.trace_names,
+                              true};
+  // The detailed warmup is timed as a measured window is, so that the queues and MSHRs are occupied as they would be, but its statistics are discarded
+  const phase_info detailed_warmup{phase.name + " detailed warmup", false, phase.sample_warmup, phase.trace_index, phase.trace_names};
+  const phase_info window{phase.name + " window", phase.is_warmup, phase.sample_window, phase.trace_index, phase.trace_names};
+
   phase_stats stats;
   stats.name = phase.name;
+  for (std::size_t i = 0; i < std::size(phase.trace_index); ++i) {
+    stats.trace_names.push_back(phase.trace_names.at(phase.trace_index.at(i)));
+  }
+  stats.sample_cpu_stats.resize(std::size(env.cpu_view()));
 
-  for (std::size_t i = 0; i < std::size(trace_index); ++i) {
-    stats.trace_names.push_back(trace_names.at(trace_index.at(i)));
+  std::vector<long long> begin_retired;
+  for (O3_CPU& cpu : env.cpu_view()) {
+    begin_retired.push_back(cpu.num_retired);
   }
 
   auto cpus = env.cpu_view();
-  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.sim_cpu_stats), [](const O3_CPU& cpu) { return cpu.sim_stats; });
-  std::transform(std::begin(cpus), std::end(cpus), std::back_inserter(stats.roi_cpu_stats), [](const O3_CPU& cpu) { return cpu.roi_stats; });
+  auto phase_complete = [&] {
+    return std::any_of(std::begin(traces), std::end(traces), [](const auto& tr) { return tr.eof(); })
+           || std::all_of(std::begin(cpus), std::end(cpus), [&](const O3_CPU& cpu) {
+                return cpu.num_retired - begin_retired.at(cpu.cpu) >= phase.length;
+              });
+  };
+
+  // The windows are simulated quietly. Only the estimate over all of them is reported.
+  auto quietly = [](const O3_CPU&) {};
+  while (!phase_complete()) {
+    if (functional.length > 0) {
+      run_functional_phase(functional, env, traces, quietly);
+    }
+    if (detailed_warmup.length > 0) {
+      run_timed_phase(detailed_warmup, env, traces, global_clock, quietly);
+    }
 
-  auto caches = env.cache_view();
-  std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.sim_cache_stats), [](const CACHE& cache) { return cache.sim_stats; });
-  std::transform(std::begin(caches), std::end(caches), std::back_inserter(stats.roi_cache_stats), [](const CACHE& cache) { return cache.roi_stats; });
+    run_timed_phase(window, env, traces, global_clock, quietly);
+    auto window_stats = collect_phase_stats(window, env);
 
-  auto dram = env.dram_view();
-  std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.sim_dram_stats),
-                 [](const DRAM_CHANNEL& chan) { return chan.sim_stats; });
-  std::transform(std::begin(dram.channels), std::end(dram.channels), std::back_inserter(stats.roi_dram_stats),
-                 [](const DRAM_CHANNEL& chan) { return chan.roi_stats; });
+    // Finish the instructions in flight before warming functionally, so that none are left stalled in the pipeline across the gap
+    drain(env, global_clock);
+
+    accumulate_window(stats.roi_cpu_stats, window_stats.roi_cpu_stats);
+    accumulate_window(stats.sim_cpu_stats, window_stats.sim_cpu_stats);
+    accumulate_window(stats.roi_cache_stats, window_stats.roi_cache_stats);
+    accumulate_window(stats.sim_cache_stats, window_stats.sim_cache_stats);
+    accumulate_window(stats.roi_dram_stats, window_stats.roi_dram_stats);
+    accumulate_window(stats.sim_dram_stats, window_stats.sim_dram_stats);
+    for (std::size_t cpu = 0; cpu < std::size(window_stats.roi_cpu_stats); ++cpu) {
+      stats.sample_cpu_stats.at(cpu).push_back(window_stats.roi_cpu_stats.at(cpu));
+    }
+  }
+
+  for (O3_CPU& cpu : cpus) {
+    auto estimate = estimate_ipc(stats.sample_cpu_stats.at(cpu.cpu));
+    fmt::print("{} complete CPU {} windows: {} sampled IPC: {:.4g} ({:.4g} to {:.4g}) (Simulation time: {:%H hr %M min %S sec})\n", phase.name,
+               cpu.cpu, estimate.windows, estimate.ipc, estimate.lower, estimate.upper, elapsed_time());
+  }
+
+  return stats;
+}
+
+phase_stats do_phase(const phase_info& phase, environment& env, std::vector<tracereader>& traces, champsim::chrono::clock& global_clock)
+{
+  if (!phase.load_checkpoint_name.empty()) {
+    load_checkpoint(phase.load_checkpoint_name, env, traces, phase);
+  }
+
+  phase_stats stats;
+  if (phase.sample_period > 0) {
+    stats = do_sampled_phase(phase, env, traces, global_clock);
+  } else if (phase.is_functional) {
+    stats = do_functional_phase(phase, env, traces);
+  } else {
+    stats = do_timed_phase(phase, env, traces, global_clock);
+  }
+
+  if (!phase.save_checkpoint_name.empty()) {
+    save_checkpoint(phase.save_checkpoint_name, env, phase);
+  }
 
   return stats;
 }
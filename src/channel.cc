@@ -25,7 +25,8 @@
 #include "util/to_underlying.h" // for to_underlying
 
 champsim::channel::channel(std::size_t rq_size, std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset_bits, bool match_offset)
-    : RQ_SIZE(rq_size), PQ_SIZE(pq_size), WQ_SIZE(wq_size), OFFSET_BITS(offset_bits), match_offset_bits(match_offset)
+    : RQ_SIZE(rq_size), PQ_SIZE(pq_size), WQ_SIZE(wq_size), OFFSET_BITS(offset_bits), match_offset_bits(match_offset), RQ{offset_bits}, PQ{offset_bits},
+      WQ{offset_bits}
 {
 }
 
@@ -51,16 +52,13 @@ bool do_collision_for_merge(Iter begin, Iter end, champsim::channel::request_typ
 {
   return do_collision_for(begin, end, packet, shamt, [](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
     destination.response_requested |= source.response_requested;
-    auto instr_copy = std::move(destination.instr_depend_on_me);
-
-    std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(source.instr_depend_on_me), std::end(source.instr_depend_on_me),
-                   std::back_inserter(destination.instr_depend_on_me));
+    destination.instr_depend_on_me = champsim::dependency_list::merge(destination.instr_depend_on_me, source.instr_depend_on_me);
   });
 }
 
 template <typename Iter>
 bool do_collision_for_return(Iter begin, Iter end, champsim::channel::request_type& packet, champsim::data::bits shamt,
-                             std::deque<champsim::channel::response_type>& returned)
+                             champsim::channel::response_queue& returned)
 {
   return do_collision_for(begin, end, packet, shamt, [&](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
     if (source.response_requested) {
@@ -74,9 +72,14 @@ void champsim::channel::check_collision()
   auto write_shamt = match_offset_bits ? champsim::data::bits{} : OFFSET_BITS;
   auto read_shamt = OFFSET_BITS;
 
+  // The queues count their packets by block. Since both shift amounts are no wider than a block, a packet with no other packet in
+  // its block cannot collide, and the search can be skipped.
+  auto may_merge = [](const auto& queue, const request_type& packet) { return queue.count(packet.address) > 1; };
+  auto may_forward = [this](const request_type& packet) { return WQ.count(packet.address) > 0; };
+
   // Check WQ for duplicates, merging if they are found
   for (auto wq_it = std::find_if(std::begin(WQ), std::end(WQ), std::not_fn(&request_type::forward_checked)); wq_it != std::end(WQ);) {
-    if (do_collision_for_merge(std::begin(WQ), wq_it, *wq_it, write_shamt)) {
+    if (may_merge(WQ, *wq_it) && do_collision_for_merge(std::begin(WQ), wq_it, *wq_it, write_shamt)) {
       sim_stats.WQ_MERGED++;
       wq_it = WQ.erase(wq_it);
     } else {
@@ -87,10 +90,10 @@ void champsim::channel::check_collision()
 
   // Check RQ for forwarding from WQ (return if found), then for duplicates (merge if found)
   for (auto rq_it = std::find_if(std::begin(RQ), std::end(RQ), std::not_fn(&request_type::forward_checked)); rq_it != std::end(RQ);) {
-    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *rq_it, write_shamt, returned)) {
+    if (may_forward(*rq_it) && do_collision_for_return(std::begin(WQ), std::end(WQ), *rq_it, write_shamt, returned)) {
       sim_stats.WQ_FORWARD++;
       rq_it = RQ.erase(rq_it);
-    } else if (do_collision_for_merge(std::begin(RQ), rq_it, *rq_it, read_shamt)) {
+    } else if (may_merge(RQ, *rq_it) && do_collision_for_merge(std::begin(RQ), rq_it, *rq_it, read_shamt)) {
       sim_stats.RQ_MERGED++;
       rq_it = RQ.erase(rq_it);
     } else {
@@ -101,10 +104,10 @@ void champsim::channel::check_collision()
 
   // Check PQ for forwarding from WQ (return if found), then for duplicates (merge if found)
   for (auto pq_it = std::find_if(std::begin(PQ), std::end(PQ), std::not_fn(&request_type::forward_checked)); pq_it != std::end(PQ);) {
-    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *pq_it, write_shamt, returned)) {
+    if (may_forward(*pq_it) && do_collision_for_return(std::begin(WQ), std::end(WQ), *pq_it, write_shamt, returned)) {
       sim_stats.WQ_FORWARD++;
       pq_it = PQ.erase(pq_it);
-    } else if (do_collision_for_merge(std::begin(PQ), pq_it, *pq_it, read_shamt)) {
+    } else if (may_merge(PQ, *pq_it) && do_collision_for_merge(std::begin(PQ), pq_it, *pq_it, read_shamt)) {
       sim_stats.PQ_MERGED++;
       pq_it = PQ.erase(pq_it);
     } else {
@@ -122,6 +125,10 @@ bool champsim::channel::do_add_queue(R& queue, std::size_t queue_size, const typ
     return false; // cannot handle this request
   }
 
+  if (queue_consumer != nullptr) {
+    queue_consumer->wake();
+  }
+
   // Insert the packet ahead of the translation misses
   auto fwd_pkt = packet;
   fwd_pkt.forward_checked = false;
@@ -0,0 +1,157 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "checkpoint.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <fmt/core.h>
+
+#include "capability_memory.h"
+#include "environment.h"
+#include "phase_info.h"
+#include "tracereader.h"
+#include "vmem.h"
+
+namespace
+{
+constexpr std::array<char, 8> checkpoint_magic{'C', 'H', 'S', 'M', 'C', 'K', 'P', 'T'};
+constexpr uint32_t checkpoint_version = 2;
+constexpr uint32_t checkpoint_byte_order = 0x01020304;
+
+struct checkpoint_header {
+  std::array<char, 8> magic;
+  uint32_t version;
+  uint32_t byte_order;
+};
+
+// The page table walkers may share a virtual memory
+std::vector<VirtualMemory*> unique_vmems(champsim::environment& env)
+{
+  std::vector<VirtualMemory*> retval;
+  for (PageTableWalker& ptw : env.ptw_view()) {
+    if (std::find(std::begin(retval), std::end(retval), ptw.vmem) == std::end(retval)) {
+      retval.push_back(ptw.vmem);
+    }
+  }
+  return retval;
+}
+
+// Traces are matched by file name, so that a checkpoint can be used after the traces have moved
+std::string_view trace_file_name(const champsim::phase_info& phase, uint32_t cpu)
+{
+  std::string_view path{phase.trace_names.at(phase.trace_index.at(cpu))};
+  return path.substr(path.find_last_of('/') + 1);
+}
+} // namespace
+
+void champsim::save_checkpoint(const std::string& fname, environment& env, const phase_info& phase)
+{
+  checkpoint_writer out;
+  out.write(checkpoint_header{checkpoint_magic, checkpoint_version, checkpoint_byte_order});
+
+  for (O3_CPU& cpu : env.cpu_view()) {
+    out.write_section(fmt::format("cpu{}", cpu.cpu), [&](auto& section) {
+      section.write_string(trace_file_name(phase, cpu.cpu));
+      cpu.save_state(section);
+    });
+    out.write_section(fmt::format("cap_mem{}", cpu.cpu), [&](auto& section) { cap_mem.at(cpu.cpu).save_state(section); });
+  }
+
+  for (CACHE& cache : env.cache_view()) {
+    out.write_section(cache.NAME, [&](auto& section) { cache.save_state(section); });
+  }
+
+  for (PageTableWalker& ptw : env.ptw_view()) {
+    out.write_section(ptw.NAME, [&](auto& section) { ptw.save_state(section); });
+  }
+
+  auto vmems = unique_vmems(env);
+  for (std::size_t i = 0; i < std::size(vmems); ++i) {
+    out.write_section(fmt::format("vmem{}", i), [&](auto& section) { vmems[i]->save_state(section); });
+  }
+
+  // Write to a temporary name first, so that a concurrent run never reads a partial checkpoint
+  const auto tmp_name = fname + ".tmp";
+  std::ofstream file{tmp_name, std::ios::binary | std::ios::trunc};
+  file.write(std::data(out.data()), static_cast<std::streamsize>(std::size(out.data())));
+  file.close();
+
+  if (!file || std::rename(tmp_name.c_str(), fname.c_str()) != 0)
+    throw std::runtime_error{fmt::format("Could not write checkpoint {}: {}", fname, std::strerror(errno))};
+
+  fmt::print("[CHECKPOINT] wrote {}\n", fname);
+}
+
+void champsim::load_checkpoint(const std::string& fname, environment& env, std::vector<tracereader>& traces, const phase_info& phase)
+{
+  std::ifstream file{fname, std::ios::binary};
+  if (!file)
+    throw std::runtime_error{fmt::format("Could not open checkpoint {}: {}", fname, std::strerror(errno))};
+  const std::string contents{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+  checkpoint_reader in{contents};
+  checkpoint_header header{};
+  in.read(header);
+  if (header.magic != checkpoint_magic || header.version != checkpoint_version || header.byte_order != checkpoint_byte_order)
+    throw std::runtime_error{fmt::format("Checkpoint {} is not compatible with this build", fname)};
+
+  auto sections = in.read_sections();
+  auto find_section = [&](const std::string& name) -> checkpoint_reader& {
+    auto found = sections.find(name);
+    if (found == std::end(sections))
+      throw std::runtime_error{fmt::format("Checkpoint {} has no state for {}", fname, name)};
+    return found->second;
+  };
+
+  for (O3_CPU& cpu : env.cpu_view()) {
+    auto& section = find_section(fmt::format("cpu{}", cpu.cpu));
+    if (auto saved_trace = section.read_string(); saved_trace != trace_file_name(phase, cpu.cpu)) {
+      throw std::runtime_error{
+          fmt::format("Checkpoint {} was taken with CPU {} running {}, not {}", fname, cpu.cpu, saved_trace, trace_file_name(phase, cpu.cpu))};
+    }
+    cpu.load_state(section);
+    cap_mem.at(cpu.cpu).load_state(find_section(fmt::format("cap_mem{}", cpu.cpu)));
+  }
+
+  for (CACHE& cache : env.cache_view()) {
+    cache.load_state(find_section(cache.NAME));
+  }
+
+  for (PageTableWalker& ptw : env.ptw_view()) {
+    ptw.load_state(find_section(ptw.NAME));
+  }
+
+  auto vmems = unique_vmems(env);
+  for (std::size_t i = 0; i < std::size(vmems); ++i) {
+    vmems[i]->load_state(find_section(fmt::format("vmem{}", i)));
+  }
+
+  // Compressed traces cannot seek, so each trace is read past the instructions that were retired before the checkpoint
+  for (O3_CPU& cpu : env.cpu_view()) {
+    auto& trace = traces.at(phase.trace_index.at(cpu.cpu));
+    for (auto count = cpu.num_retired; count > 0 && !trace.eof(); --count) {
+      trace();
+    }
+  }
+
+  fmt::print("[CHECKPOINT] loaded {}\n", fname);
+}
@@ -1,5 +1,9 @@
 #include "core_stats.h"
 
+#include <cmath>
+#include <limits>
+#include <numeric>
+
 cpu_stats operator-(cpu_stats lhs, cpu_stats rhs)
 {
   lhs.begin_instrs -= rhs.begin_instrs;
@@ -13,3 +17,48 @@ cpu_stats operator-(cpu_stats lhs, cpu_stats rhs)
 
   return lhs;
 }
+
+cpu_stats operator+(cpu_stats lhs, cpu_stats rhs)
+{
+  lhs.begin_instrs += rhs.begin_instrs;
+  lhs.begin_cycles += rhs.begin_cycles;
+  lhs.end_instrs += rhs.end_instrs;
+  lhs.end_cycles += rhs.end_cycles;
+  lhs.total_rob_occupancy_at_branch_mispredict += rhs.total_rob_occupancy_at_branch_mispredict;
+
+  lhs.total_branch_types.merge(rhs.total_branch_types);
+  lhs.branch_type_misses.merge(rhs.branch_type_misses);
+
+  return lhs;
+}
+
+ipc_estimate estimate_ipc(const std::vector<cpu_stats>& windows)
+{
+  std::vector<double> cpis;
+  for (const auto& window : windows) {
+    if (window.instrs() > 0 && window.cycles() > 0)
+      cpis.push_back(std::ceil(window.cycles()) / std::ceil(window.instrs()));
+  }
+
+  ipc_estimate result;
+  result.windows = std::size(cpis);
+  if (std::empty(cpis))
+    return result;
+
+  auto mean_cpi = std::accumulate(std::begin(cpis), std::end(cpis), 0.0) / static_cast<double>(std::size(cpis));
+  auto half_width = 0.0;
+  if (std::size(cpis) > 1) {
+    auto sum_sq = std::accumulate(std::begin(cpis), std::end(cpis), 0.0, [mean_cpi](auto acc, auto x) { return acc + (x - mean_cpi) * (x - mean_cpi); });
+    auto std_dev = std::sqrt(sum_sq / static_cast<double>(std::size(cpis) - 1));
+
+    // The normal approximation, which is close to Student's t once there are more than a few tens of windows
+    constexpr double z_95 = 1.96;
+    half_width = z_95 * std_dev / std::sqrt(static_cast<double>(std::size(cpis)));
+  }
+
+  // A CPI interval that reaches zero leaves the IPC unbounded above
+  result.ipc = 1.0 / mean_cpi;
+  result.lower = 1.0 / (mean_cpi + half_width);
+  result.upper = (mean_cpi > half_width) ? 1.0 / (mean_cpi - half_width) : std::numeric_limits<double>::infinity();
+  return result;
+}
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cfenv>
 #include <cmath>
+#include <numeric>
 #include <fmt/core.h>
 
 #include "deadlock.h"
@@ -30,20 +31,22 @@
 MEMORY_CONTROLLER::MEMORY_CONTROLLER(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd,
                                      std::size_t t_cas, std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::vector<channel_type*>&& ul,
                                      std::size_t rq_size, std::size_t wq_size, std::size_t chans, champsim::data::bytes chan_width, std::size_t rows,
-                                     std::size_t columns, std::size_t ranks, std::size_t bankgroups, std::size_t banks, std::size_t refreshes_per_period)
+                                     std::size_t columns, std::size_t ranks, std::size_t bankgroups, std::size_t banks, std::size_t refreshes_per_period,
+                                     champsim::dram_scheduling_policy sched, champsim::dram_model timing)
     : champsim::operable(mc_period), queues(std::move(ul)), channel_width(chan_width),
       address_mapping(chan_width, BLOCK_SIZE / chan_width.count(), chans, bankgroups, banks, columns, ranks, rows), data_bus_period(dbus_period)
 {
   for (std::size_t i{0}; i < chans; ++i) {
     channels.emplace_back(dbus_period, mc_period, t_rp, t_rcd, t_cas, t_ras, refresh_period, refreshes_per_period, chan_width, rq_size, wq_size,
-                          address_mapping);
+                          address_mapping, sched, timing);
   }
 }
 
 DRAM_CHANNEL::DRAM_CHANNEL(champsim::chrono::picoseconds dbus_period, champsim::chrono::picoseconds mc_period, std::size_t t_rp, std::size_t t_rcd,
                            std::size_t t_cas, std::size_t t_ras, champsim::chrono::microseconds refresh_period, std::size_t refreshes_per_period,
-                           champsim::data::bytes width, std::size_t rq_size, std::size_t wq_size, DRAM_ADDRESS_MAPPING addr_mapper)
-    : champsim::operable(mc_period), address_mapping(addr_mapper), WQ{wq_size}, RQ{rq_size}, channel_width(width),
+                           champsim::data::bytes width, std::size_t rq_size, std::size_t wq_size, DRAM_ADDRESS_MAPPING addr_mapper,
+                           champsim::dram_scheduling_policy sched, champsim::dram_model timing)
+    : champsim::operable(mc_period), address_mapping(addr_mapper), WQ{wq_size}, RQ{rq_size}, channel_width(width), scheduling(sched), model(timing),
       DRAM_ROWS_PER_REFRESH(address_mapping.rows() / refreshes_per_period), tRP(t_rp * mc_period), tRCD(t_rcd * mc_period), tCAS(t_cas * mc_period),
       tRAS(t_ras * mc_period), tREF(refresh_period / refreshes_per_period),
       tRFC(std::chrono::duration_cast<champsim::chrono::clock::duration>(
@@ -57,6 +60,8 @@ DRAM_CHANNEL::DRAM_CHANNEL(champsim::chrono::picoseconds dbus_period, champsim::
   request_array_type br(address_mapping.ranks() * address_mapping.banks() * address_mapping.bankgroups());
   bank_request = br;
   active_request = std::end(bank_request);
+  bank_reads.resize(std::size(bank_request));
+  bank_writes.resize(std::size(bank_request));
 }
 
 DRAM_ADDRESS_MAPPING::DRAM_ADDRESS_MAPPING(champsim::data::bytes channel_width_, std::size_t pref_size_, std::size_t channels_, std::size_t bankgroups_,
@@ -109,26 +114,39 @@ long DRAM_CHANNEL::operate()
   long progress{0};
 
   if (warmup) {
-    for (auto& entry : RQ) {
-      if (entry.has_value()) {
-        response_type response{entry->address, entry->v_address, entry->data, entry->pf_metadata, entry->cap, entry->instr_depend_on_me};        
-        for (auto* ret : entry.value().to_return) {
+    // Requests already scheduled to a bank are left to finish, since the bank refers to them. These remain only if a warmup phase follows a
+    // timed phase.
+    for (auto entry = std::begin(RQ); entry != std::end(RQ); ++entry) {
+      if (entry->has_value() && !entry->value().scheduled) {
+        response_type response{entry->value().address, entry->value().v_address, entry->value().data, entry->value().pf_metadata, entry->value().cap,
+                               entry->value().instr_depend_on_me};
+        for (auto* ret : entry->value().to_return) {
           ret->push_back(response);
         }
 
+        if (entry->value().forward_checked) {
+          remove_from_bank(entry);
+        }
         ++progress;
-        entry.reset();
+        entry->reset();
       }
     }
 
-    for (auto& entry : WQ) {
-      if (entry.has_value()) {
+    for (auto entry = std::begin(WQ); entry != std::end(WQ); ++entry) {
+      if (entry->has_value() && !entry->value().scheduled) {
+        if (entry->value().forward_checked) {
+          remove_from_bank(entry);
+        }
         ++progress;
+        entry->reset();
       }
-      entry.reset();
     }
   }
 
+  if (model == champsim::dram_model::analytical) {
+    return progress + operate_analytical();
+  }
+
   check_write_collision();
   check_read_collision();
   progress += finish_dbus_request();
@@ -140,6 +158,82 @@ long DRAM_CHANNEL::operate()
   return progress;
 }
 
+bool MEMORY_CONTROLLER::is_idle() const
+{
+  auto queues_empty = [](const channel_type* ul) {
+    return std::empty(ul->RQ) && std::empty(ul->WQ) && std::empty(ul->PQ);
+  };
+
+  // The channels are operated after the controller's time has advanced, so they are checked at the controller's time
+  return std::all_of(std::cbegin(queues), std::cend(queues), queues_empty)
+         && std::all_of(std::cbegin(channels), std::cend(channels), [time = current_time](const auto& chan) { return chan.is_idle_at(time); });
+}
+
+void MEMORY_CONTROLLER::operate_idle(long cycles)
+{
+  for (auto& channel : channels) {
+    channel.skip_idle(cycles);
+  }
+}
+
+champsim::chrono::clock::time_point MEMORY_CONTROLLER::next_wakeup() const
+{
+  if (!is_idle()) {
+    return current_time;
+  }
+
+  auto wakeup = champsim::chrono::clock::time_point::max();
+  for (const auto& channel : channels) {
+    wakeup = std::min(wakeup, channel.next_wakeup());
+  }
+  return wakeup;
+}
+
+bool DRAM_CHANNEL::is_idle() const { return is_idle_at(current_time); }
+
+bool DRAM_CHANNEL::is_idle_at(champsim::chrono::clock::time_point time) const
+{
+  if (model == champsim::dram_model::analytical) {
+    // Requests are reserved as soon as they arrive, so the channel waits only on completions
+    auto waiting = [time](const auto& x) {
+      return x.has_value() && (!x->scheduled || x->ready_time <= time);
+    };
+    return std::none_of(std::begin(RQ), std::end(RQ), waiting) && std::none_of(std::begin(WQ), std::end(WQ), waiting);
+  }
+
+  auto bank_idle = [](const auto& b_req) {
+    return !b_req.valid && !b_req.need_refresh && !b_req.under_refresh;
+  };
+
+  // An empty channel still swaps out of write mode, and may swap into it if the write queue is tiny
+  const bool write_mode_stable = !write_mode && ((std::size(WQ) * 7) >> 3) > 0;
+
+  return write_mode_stable && active_request == std::end(bank_request) && time < last_refresh + tREF
+         && std::none_of(std::begin(RQ), std::end(RQ), [](const auto& x) { return x.has_value(); })
+         && std::none_of(std::begin(WQ), std::end(WQ), [](const auto& x) { return x.has_value(); })
+         && std::all_of(std::begin(bank_request), std::end(bank_request), bank_idle);
+}
+
+champsim::chrono::clock::time_point DRAM_CHANNEL::next_wakeup() const
+{
+  if (!is_idle()) {
+    return current_time;
+  }
+
+  if (model == champsim::dram_model::analytical) {
+    // Every request has been reserved, so the channel is idle until the first of them completes
+    auto wakeup = champsim::chrono::clock::time_point::max();
+    auto earlier = [](auto acc, const auto& entry) {
+      return entry.has_value() ? std::min(acc, entry->ready_time) : acc;
+    };
+    wakeup = std::accumulate(std::begin(RQ), std::end(RQ), wakeup, earlier);
+    return std::accumulate(std::begin(WQ), std::end(WQ), wakeup, earlier);
+  }
+
+  // An empty channel is idle until its next refresh
+  return last_refresh + tREF;
+}
+
 long DRAM_CHANNEL::finish_dbus_request()
 {
   long progress{0};
@@ -152,7 +246,13 @@ long DRAM_CHANNEL::finish_dbus_request()
     }
 
     active_request->valid = false;
+    if (scheduling.page_policy == champsim::dram_page_policy::closed) {
+      // The row is precharged as the access completes, so the bank cannot activate another row until tRP later
+      active_request->open_row.reset();
+      active_request->precharge_done = current_time + tRP;
+    }
 
+    remove_from_bank(active_request->pkt);
     active_request->pkt->reset();
     active_request = std::end(bank_request);
     ++progress;
@@ -256,7 +356,7 @@ long DRAM_CHANNEL::populate_dbus()
       // Put this request on the data bus
 
       // get which bankgroup we are in
-      auto op_bankgroup = bankgroup_request_index(iter_next_process->pkt->value().address);
+      auto op_bankgroup = iter_next_process->pkt->value().bankgroup_index;
       auto bankgroup_ready_time = bankgroup_readytime[op_bankgroup];
 
       active_request = iter_next_process;
@@ -325,12 +425,15 @@ DRAM_CHANNEL::queue_type::iterator DRAM_CHANNEL::schedule_packet()
       return false;
     }
 
-    auto lop_idx = this->bank_request_index(lhs.value().address);
-    auto rop_idx = this->bank_request_index(rhs.value().address);
-    auto rready = !this->bank_request[rop_idx].valid;
-    auto lready = !this->bank_request[lop_idx].valid;
+    auto rready = !this->bank_request[rhs.value().bank_index].valid;
+    auto lready = !this->bank_request[lhs.value().bank_index].valid;
     return (rready == lready) ? lhs.value().ready_time <= rhs.value().ready_time : lready;
   };
+
+  if (scheduling.scheduler == champsim::dram_scheduler::frfcfs) {
+    return schedule_row_hits_first();
+  }
+
   queue_type::iterator iter_next_schedule;
   if (write_mode) {
     iter_next_schedule = std::min_element(std::begin(WQ), std::end(WQ), next_schedule);
@@ -340,21 +443,57 @@ DRAM_CHANNEL::queue_type::iterator DRAM_CHANNEL::schedule_packet()
   return (iter_next_schedule);
 }
 
+// Look for the oldest ready request to a free bank, preferring requests that hit in the bank's open row
+DRAM_CHANNEL::queue_type::iterator DRAM_CHANNEL::schedule_row_hits_first()
+{
+  auto& queue = write_mode ? WQ : RQ;
+  auto& bank_queues = write_mode ? bank_writes : bank_reads;
+
+  auto best = std::end(queue);
+  bool best_hit = false;
+  for (std::size_t bank = 0; bank < std::size(bank_request); ++bank) {
+    const auto& b_req = bank_request[bank];
+    if (b_req.valid || b_req.under_refresh) {
+      continue;
+    }
+
+    // A bank that has served its cap of row hits serves the oldest request next, so that requests to other rows are not starved
+    const bool hits_first = scheduling.row_hit_cap == 0 || b_req.row_hits < scheduling.row_hit_cap;
+    for (auto pkt : bank_queues[bank]) {
+      const auto& req = pkt->value();
+      if (req.scheduled || req.ready_time > current_time) {
+        continue;
+      }
+
+      const bool hit = hits_first && b_req.open_row.has_value() && *b_req.open_row == req.row;
+      if (best == std::end(queue) || (hit && !best_hit) || (hit == best_hit && req.ready_time < best->value().ready_time)) {
+        best = pkt;
+        best_hit = hit;
+      }
+    }
+  }
+
+  // Any request that is not ready or whose bank is busy is left unserviced
+  return best == std::end(queue) ? std::begin(queue) : best;
+}
+
 long DRAM_CHANNEL::service_packet(DRAM_CHANNEL::queue_type::iterator pkt)
 {
   long progress{0};
   if (pkt->has_value() && pkt->value().ready_time <= current_time) {
-    auto op_row = address_mapping.get_row(pkt->value().address);
-    auto op_idx = bank_request_index(pkt->value().address);
+    auto op_row = pkt->value().row;
+    auto op_idx = pkt->value().bank_index;
 
     if (!bank_request[op_idx].valid && !bank_request[op_idx].under_refresh) {
       bool row_buffer_hit = (bank_request[op_idx].open_row.has_value() && *(bank_request[op_idx].open_row) == op_row);
+      auto row_hits = row_buffer_hit ? bank_request[op_idx].row_hits + 1 : std::size_t{0};
 
       // this bank is now busy
       auto row_charge_delay = champsim::chrono::clock::duration{bank_request[op_idx].open_row.has_value() ? tRP + tRCD : tRCD};
+      auto start_time = std::max(current_time, bank_request[op_idx].precharge_done);
       bank_request[op_idx] = {true,  row_buffer_hit,        false,
-                              false, std::optional{op_row}, current_time + tCAS + (row_buffer_hit ? champsim::chrono::clock::duration{} : row_charge_delay),
-                              pkt};
+                              false, std::optional{op_row}, start_time + tCAS + (row_buffer_hit ? champsim::chrono::clock::duration{} : row_charge_delay),
+                              pkt,   row_hits};
       pkt->value().scheduled = true;
       pkt->value().ready_time = champsim::chrono::clock::time_point::max();
 
@@ -365,8 +504,85 @@ long DRAM_CHANNEL::service_packet(DRAM_CHANNEL::queue_type::iterator pkt)
   return progress;
 }
 
+long DRAM_CHANNEL::operate_analytical()
+{
+  long progress{0};
+
+  for (auto* queue : {&RQ, &WQ}) {
+    for (auto entry = std::begin(*queue); entry != std::end(*queue); ++entry) {
+      if (!entry->has_value()) {
+        continue;
+      }
+
+      if (!entry->value().scheduled) {
+        reserve_analytical(entry, queue == &WQ);
+        ++progress;
+      } else if (entry->value().ready_time <= current_time) {
+        response_type response{entry->value().address, entry->value().v_address, entry->value().data, entry->value().pf_metadata, entry->value().cap,
+                               entry->value().instr_depend_on_me};
+        for (auto* ret : entry->value().to_return) {
+          ret->push_back(response);
+        }
+
+        entry->reset();
+        ++progress;
+      }
+    }
+  }
+
+  return progress;
+}
+
+// Estimate the completion time of a request from its bank's open row and the bursts already reserved on the data bus.
+// Refreshes, bankgroup stalls, and bus turnarounds are not modeled.
+void DRAM_CHANNEL::reserve_analytical(DRAM_CHANNEL::queue_type::iterator pkt, bool is_write)
+{
+  auto& bank = bank_request[bank_request_index(pkt->value().address)];
+  auto op_row = address_mapping.get_row(pkt->value().address);
+
+  bool row_buffer_hit = (bank.open_row.has_value() && *(bank.open_row) == op_row);
+  auto row_charge_delay = champsim::chrono::clock::duration{bank.open_row.has_value() ? tRP + tRCD : tRCD};
+  auto data_ready = std::max(current_time, bank.ready_time) + tCAS + (row_buffer_hit ? champsim::chrono::clock::duration{} : row_charge_delay);
+
+  // The burst waits for the bursts reserved before it
+  if (dbus_cycle_available > data_ready) {
+    sim_stats.dbus_cycle_congested += (dbus_cycle_available - data_ready) / data_bus_period;
+    ++sim_stats.dbus_count_congested;
+  }
+  dbus_cycle_available = std::max(data_ready, dbus_cycle_available) + DRAM_DBUS_RETURN_TIME;
+
+  bank.ready_time = data_ready;
+  if (scheduling.page_policy == champsim::dram_page_policy::closed) {
+    // The row is precharged after the access, before the bank can activate another
+    bank.ready_time += tRP;
+    bank.open_row.reset();
+  } else {
+    bank.open_row = op_row;
+  }
+
+  if (row_buffer_hit) {
+    if (is_write) {
+      ++sim_stats.WQ_ROW_BUFFER_HIT;
+    } else {
+      ++sim_stats.RQ_ROW_BUFFER_HIT;
+    }
+  } else if (is_write) {
+    ++sim_stats.WQ_ROW_BUFFER_MISS;
+  } else {
+    ++sim_stats.RQ_ROW_BUFFER_MISS;
+  }
+
+  pkt->value().scheduled = true;
+  pkt->value().ready_time = dbus_cycle_available;
+}
+
 void MEMORY_CONTROLLER::initialize()
 {
+  // The controller is woken when its channels are given work
+  for (auto* ul : queues) {
+    ul->queue_consumer = this;
+  }
+
   using namespace champsim::data::data_literals;
   using namespace std::literals::chrono_literals;
   auto sz = this->size();
@@ -421,6 +637,27 @@ bool DRAM_ADDRESS_MAPPING::is_collision(champsim::address a, champsim::address b
   return (a.slice_upper(offset_bits) == b.slice_upper(offset_bits));
 }
 
+void DRAM_CHANNEL::decode_to_bank(queue_type::iterator pkt, bank_queue_type& bank_queues)
+{
+  auto& req = pkt->value();
+  req.bank_index = bank_request_index(req.address);
+  req.bankgroup_index = bankgroup_request_index(req.address);
+  req.row = address_mapping.get_row(req.address);
+  bank_queues.at(req.bank_index).push_back(pkt);
+}
+
+void DRAM_CHANNEL::remove_from_bank(queue_type::iterator pkt)
+{
+  const auto* target = &*pkt;
+  for (auto* bank_queues : {&bank_reads, &bank_writes}) {
+    auto& bank_queue = bank_queues->at(pkt->value().bank_index);
+    if (auto found = std::find_if(std::begin(bank_queue), std::end(bank_queue), [target](auto x) { return &*x == target; }); found != std::end(bank_queue)) {
+      bank_queue.erase(found);
+      return;
+    }
+  }
+}
+
 void DRAM_CHANNEL::check_write_collision()
 {
   for (auto wq_it = std::begin(WQ); wq_it != std::end(WQ); ++wq_it) {
@@ -438,6 +675,7 @@ void DRAM_CHANNEL::check_write_collision()
         wq_it->reset();
       } else {
         wq_it->value().forward_checked = true;
+        decode_to_bank(wq_it, bank_writes);
       }
     }
   }
@@ -464,11 +702,9 @@ void DRAM_CHANNEL::check_read_collision()
       }
       // backwards check
       else if (auto found = std::find_if(std::begin(RQ), rq_it, checker); found != rq_it) {
-        auto instr_copy = std::move(found->value().instr_depend_on_me);
         auto ret_copy = std::move(found->value().to_return);
 
-        std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(rq_it->value().instr_depend_on_me), std::end(rq_it->value().instr_depend_on_me),
-                       std::back_inserter(found->value().instr_depend_on_me));
+        found->value().instr_depend_on_me = champsim::dependency_list::merge(found->value().instr_depend_on_me, rq_it->value().instr_depend_on_me);
         std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_it->value().to_return), std::end(rq_it->value().to_return),
                        std::back_inserter(found->value().to_return));
 
@@ -477,17 +713,16 @@ void DRAM_CHANNEL::check_read_collision()
       }
       // forwards check
       else if (found = std::find_if(std::next(rq_it), std::end(RQ), checker); found != std::end(RQ)) {
-        auto instr_copy = std::move(found->value().instr_depend_on_me);
         auto ret_copy = std::move(found->value().to_return);
 
-        std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(rq_it->value().instr_depend_on_me), std::end(rq_it->value().instr_depend_on_me),
-                       std::back_inserter(found->value().instr_depend_on_me));
+        found->value().instr_depend_on_me = champsim::dependency_list::merge(found->value().instr_depend_on_me, rq_it->value().instr_depend_on_me);
         std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_it->value().to_return), std::end(rq_it->value().to_return),
                        std::back_inserter(found->value().to_return));
 
         rq_it->reset();
       } else {
         rq_it->value().forward_checked = true;
+        decode_to_bank(rq_it, bank_reads);
       }
     }
   }
@@ -11,3 +11,16 @@ dram_stats operator-(dram_stats lhs, dram_stats rhs)
   lhs.WQ_FULL -= rhs.WQ_FULL;
   return lhs;
 }
+
+dram_stats operator+(dram_stats lhs, dram_stats rhs)
+{
+  lhs.dbus_cycle_congested += rhs.dbus_cycle_congested;
+  lhs.dbus_count_congested += rhs.dbus_count_congested;
+  lhs.refresh_cycles += rhs.refresh_cycles;
+  lhs.WQ_ROW_BUFFER_HIT += rhs.WQ_ROW_BUFFER_HIT;
+  lhs.WQ_ROW_BUFFER_MISS += rhs.WQ_ROW_BUFFER_MISS;
+  lhs.RQ_ROW_BUFFER_HIT += rhs.RQ_ROW_BUFFER_HIT;
+  lhs.RQ_ROW_BUFFER_MISS += rhs.RQ_ROW_BUFFER_MISS;
+  lhs.WQ_FULL += rhs.WQ_FULL;
+  return lhs;
+}
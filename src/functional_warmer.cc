@@ -0,0 +1,52 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "functional_warmer.h"
+
+#include "cache.h"
+#include "environment.h"
+#include "ptw.h"
+
+champsim::functional_warmer::functional_warmer(environment& env) : functional_warmer(env.cache_view(), env.ptw_view()) {}
+
+champsim::functional_warmer::functional_warmer(const std::vector<std::reference_wrapper<CACHE>>& cache_view,
+                                               const std::vector<std::reference_wrapper<PageTableWalker>>& ptw_view)
+{
+  for (CACHE& cache : cache_view) {
+    for (const auto* ul : cache.upper_levels) {
+      caches.insert_or_assign(ul, cache);
+    }
+  }
+
+  for (PageTableWalker& ptw : ptw_view) {
+    for (const auto* ul : ptw.upper_levels) {
+      walkers.insert_or_assign(ul, ptw);
+    }
+  }
+}
+
+auto champsim::functional_warmer::access(const channel* ch, const channel::request_type& packet) -> channel::response_type
+{
+  if (auto cache = caches.find(ch); cache != std::end(caches)) {
+    return cache->second.get().warm_access(packet, *this);
+  }
+
+  if (auto walker = walkers.find(ch); walker != std::end(walkers)) {
+    return walker->second.get().warm_access(packet, *this);
+  }
+
+  return channel::response_type{packet};
+}
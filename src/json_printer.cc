@@ -49,6 +49,9 @@ void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
   std::map<std::string, nlohmann::json> statsmap;
   statsmap.emplace("prefetch requested", stats.pf_requested);
   statsmap.emplace("prefetch issued", stats.pf_issued);
+  statsmap.emplace("prefetch dropped", nlohmann::json{{"resident", stats.pf_dropped_resident},
+                                                      {"inflight", stats.pf_dropped_inflight},
+                                                      {"recent", stats.pf_dropped_recent}});
   statsmap.emplace("useful prefetch", stats.pf_useful);
   statsmap.emplace("useless prefetch", stats.pf_useless);
 
@@ -71,6 +74,30 @@ void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
     statsmap.emplace(access_type_names.at(champsim::to_underlying(type)), nlohmann::json{{"hit", hits}, {"miss", misses}, {"mshr_merge", mshr_merges}});
   }
 
+  // Element k of each curve is the miss ratio of a fully-associative LRU cache of 2^k blocks
+  if (stats.reuse_distances.total() > 0) {
+    auto curves = [&stats](auto select) {
+      std::vector<std::vector<double>> by_cpu;
+      for (std::size_t cpu = 0; cpu < NUM_CPUS; ++cpu) {
+        by_cpu.push_back(miss_ratio_curve(stats.reuse_distances, cpu, select));
+      }
+      return by_cpu;
+    };
+
+    std::map<std::string, nlohmann::json> mrc{{"TOTAL", curves([](auto, auto) { return true; })}};
+    for (const auto type : {access_type::LOAD, access_type::RFO, access_type::PREFETCH, access_type::WRITE, access_type::TRANSLATION}) {
+      mrc.emplace(access_type_names.at(champsim::to_underlying(type)), curves([type](auto, auto x) { return x == type; }));
+    }
+
+    std::map<std::string, nlohmann::json> by_size;
+    for (auto b : cap_size_coverage_events_with_untagged) {
+      by_size.emplace(cap_size_coverage_events_names.at(static_cast<std::size_t>(b)), curves([b](auto x, auto) { return x == b; }));
+    }
+    mrc.emplace("authority capability size", by_size);
+
+    statsmap.emplace("miss ratio curve", mrc);
+  }
+
   j = statsmap;
 }
 
@@ -105,6 +132,16 @@ void to_json(nlohmann::json& j, const champsim::phase_stats stats)
   std::map<std::string, nlohmann::json> statsmap{{"name", stats.name}, {"traces", stats.trace_names}};
   statsmap.emplace("roi", roi_stats);
   statsmap.emplace("sim", sim_stats);
+
+  if (!std::empty(stats.sample_cpu_stats)) {
+    std::vector<nlohmann::json> samples;
+    for (const auto& windows : stats.sample_cpu_stats) {
+      auto estimate = estimate_ipc(windows);
+      samples.push_back(
+          nlohmann::json{{"windows", estimate.windows}, {"IPC", estimate.ipc}, {"IPC 95% lower", estimate.lower}, {"IPC 95% upper", estimate.upper}});
+    }
+    statsmap.emplace("sampled", samples);
+  }
   j = statsmap;
 }
 } // namespace champsim
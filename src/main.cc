@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -33,6 +34,7 @@
 #include "phase_info.h"
 #include "stats_printer.h"
 #include "tracereader.h"
+#include "variants.h"
 #include "vmem.h"
 
 
@@ -43,6 +45,7 @@ std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases,
 
 #ifndef CHAMPSIM_TEST_BUILD
 using configured_environment = champsim::configured::generated_environment<CHAMPSIM_BUILD>;
+using configured_variants = champsim::configured::variants<CHAMPSIM_BUILD>;
 
 const std::size_t NUM_CPUS = configured_environment::num_cpus;
 
@@ -55,34 +58,93 @@ const unsigned LOG2_PAGE_SIZE = champsim::lg2(PAGE_SIZE);
 #ifndef CHAMPSIM_TEST_BUILD
 int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
 {
-  configured_environment gen_environment{};
-
   CLI::App app{"A microarchitecture simulator for research and education"};
 
   bool knob_cloudsuite{false};
   bool knob_cheri{false};
+  bool knob_mmap{false};
+  bool knob_functional_warmup{false};
+  bool knob_hide_heartbeat{false};
+  long parallel_quantum = 0;
+  std::size_t decompress_depth = 8;
   long long warmup_instructions = 0;
   long long simulation_instructions = std::numeric_limits<long long>::max();
+  long long sample_period = 0;
+  long long sample_warmup = 2000;
+  long long sample_window = 10000;
+  double reuse_sample_rate = 0;
   std::string json_file_name;
+  std::string save_checkpoint_name;
+  std::string load_checkpoint_name;
   std::vector<std::string> trace_names;
-
-  auto set_heartbeat_callback = [&](auto) {
-    for (O3_CPU& cpu : gen_environment.cpu_view()) {
-      cpu.show_heartbeat = false;
-    }
-  };
+  std::vector<std::string> save_cap_snapshot_names;
+  std::vector<std::string> load_cap_snapshot_names;
+  std::vector<std::string> variant_selection;
 
   app.add_flag("-c,--cloudsuite", knob_cloudsuite, "Read all traces using the cloudsuite format");
   app.add_flag("-p,--cheri-purecap", knob_cheri, "Read all traces using the CHERI format");
-  app.add_flag("--hide-heartbeat", set_heartbeat_callback, "Hide the heartbeat output");
+  app.add_flag("--mmap-traces", knob_mmap, "Memory-map all uncompressed traces. Traces ending in .raw are always memory-mapped");
+  app.add_flag("--hide-heartbeat", knob_hide_heartbeat, "Hide the heartbeat output");
   auto* warmup_instr_option = app.add_option("-w,--warmup-instructions", warmup_instructions, "The number of instructions in the warmup phase");
   auto* deprec_warmup_instr_option =
       app.add_option("--warmup_instructions", warmup_instructions, "[deprecated] use --warmup-instructions instead")->excludes(warmup_instr_option);
+  app.add_flag("--functional-warmup", knob_functional_warmup,
+               "Warm the caches, TLBs, branch predictors, and prefetchers in the warmup phase without simulating the pipeline or the memory timing");
   auto* sim_instr_option = app.add_option("-i,--simulation-instructions", simulation_instructions,
                                           "The number of instructions in the detailed phase. If not specified, run to the end of the trace.");
   auto* deprec_sim_instr_option =
       app.add_option("--simulation_instructions", simulation_instructions, "[deprecated] use --simulation-instructions instead")->excludes(sim_instr_option);
 
+  auto* sample_period_option =
+      app.add_option("--sample-period", sample_period,
+                     "Sample the detailed phase: in each period of this many instructions, warm functionally and then simulate a detailed warmup and a "
+                     "measured window in detail")
+          ->check(CLI::PositiveNumber);
+  app.add_option("--sample-warmup", sample_warmup, "The number of instructions simulated in detail before each sampled window")
+      ->check(CLI::NonNegativeNumber)
+      ->needs(sample_period_option);
+  app.add_option("--sample-window", sample_window, "The number of instructions measured in each sampled window")
+      ->check(CLI::PositiveNumber)
+      ->needs(sample_period_option);
+
+  auto* profile_reuse_option =
+      app.add_option("--profile-reuse", reuse_sample_rate,
+                     "Measure the LRU reuse distances of the accesses to every cache, tracking the given fraction of the blocks, and print the miss ratio "
+                     "of each cache size. A rate of 1 tracks every block.");
+
+  app.add_option("--parallel-quantum", parallel_quantum,
+                 "Simulate each core's private caches on its own thread, synchronizing with shared elements every given number of cycles. A quantum of 1 "
+                 "gives the same results as serial simulation. Modules must not share mutable state between cores.")
+      ->check(CLI::NonNegativeNumber);
+
+  app.add_option("--decompress-depth", decompress_depth,
+                 "The number of blocks of records to decompress ahead of the simulation on a background thread. A depth of 0 decompresses on the "
+                 "simulation thread.")
+      ->check(CLI::NonNegativeNumber);
+
+  auto* save_cap_snapshot_option =
+      app.add_option("--save-cap-snapshot", save_cap_snapshot_names,
+                     "Write each CPU's capability memory to the given file once its trace's presimpoint records have been read")
+          ->expected(NUM_CPUS);
+  app.add_option("--load-cap-snapshot", load_cap_snapshot_names,
+                 "Load each CPU's capability memory from the given file, written by --save-cap-snapshot, instead of replaying its trace's presimpoint "
+                 "records. Each snapshot must have been written from the same trace.")
+      ->expected(NUM_CPUS)
+      ->check(CLI::ExistingFile)
+      ->excludes(save_cap_snapshot_option);
+
+  auto* save_checkpoint_option = app.add_option("--save-checkpoint", save_checkpoint_name,
+                                                "Write the warmed caches, TLBs, predictors, and prefetchers to the given file at the end of the warmup phase");
+  app.add_option("--load-checkpoint", load_checkpoint_name,
+                 "Restore the state written by --save-checkpoint from the given file and skip the warmup phase. The traces must have the same names as "
+                 "those the checkpoint was taken with.")
+      ->check(CLI::ExistingFile)
+      ->excludes(save_checkpoint_option);
+
+  app.add_option("--variant", variant_selection,
+                 "Simulate only the given variants of the configuration, where \"base\" names the configuration itself. By default, the configuration and all "
+                 "of its variants are simulated, each in its own process, from a single reading of the traces.");
+
   auto* json_option =
       app.add_option("--json", json_file_name, "The name of the file to receive JSON output. If no name is specified, stdout will be used")->expected(0, 1);
 
@@ -93,6 +155,16 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   const bool warmup_given = (warmup_instr_option->count() > 0) || (deprec_warmup_instr_option->count() > 0);
   const bool simulation_given = (sim_instr_option->count() > 0) || (deprec_sim_instr_option->count() > 0);
 
+  if (sample_period_option->count() > 0 && sample_period < sample_warmup + sample_window) {
+    fmt::print(stderr, "--sample-period must be at least the sum of --sample-warmup and --sample-window\n");
+    return 1;
+  }
+
+  if (profile_reuse_option->count() > 0 && !(reuse_sample_rate > 0 && reuse_sample_rate <= 1)) {
+    fmt::print(stderr, "--profile-reuse must be greater than 0 and at most 1\n");
+    return 1;
+  }
+
   if (deprec_warmup_instr_option->count() > 0) {
     fmt::print("WARNING: option --warmup_instructions is deprecated. Use --warmup-instructions instead.\n");
   }
@@ -107,47 +179,151 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     warmup_instructions = simulation_instructions / 5;
   }
 
-  std::vector<champsim::tracereader> traces;
-  std::transform(
-      std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
-      [knob_cloudsuite, knob_cheri, repeat = simulation_given, i = uint8_t(0)](auto name) mutable { return get_tracereader(name, i++, knob_cloudsuite, knob_cheri, repeat); });
-
   std::vector<champsim::phase_info> phases{
-      {champsim::phase_info{"Warmup", true, warmup_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names},
+      {champsim::phase_info{"Warmup", true, warmup_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names, knob_functional_warmup},
        champsim::phase_info{"Simulation", false, simulation_instructions, std::vector<std::size_t>(std::size(trace_names), 0), trace_names}}};
 
   for (auto& p : phases) {
     std::iota(std::begin(p.trace_index), std::end(p.trace_index), 0);
   }
 
+  phases.at(0).save_checkpoint_name = save_checkpoint_name;
+  phases.at(1).load_checkpoint_name = load_checkpoint_name;
+  if (sample_period_option->count() > 0) {
+    phases.at(1).sample_period = sample_period;
+    phases.at(1).sample_warmup = sample_warmup;
+    phases.at(1).sample_window = sample_window;
+  }
+
   champsim::initialize_capability_memory(NUM_CPUS); //always initialize or guard?
+  for (std::size_t i = 0; i < std::size(save_cap_snapshot_names); ++i) {
+    champsim::cap_mem.at(i).set_snapshot_output(save_cap_snapshot_names[i], champsim::trace_identity::of(trace_names.at(i)));
+  }
+  for (std::size_t i = 0; i < std::size(load_cap_snapshot_names); ++i) {
+    champsim::cap_mem.at(i).load_snapshot(load_cap_snapshot_names[i], champsim::trace_identity::of(trace_names.at(i)));
+  }
+
+  // The configuration itself is variant 0
+  std::vector<std::string> variant_names{"base"};
+  std::transform(std::begin(configured_variants::names), std::end(configured_variants::names), std::back_inserter(variant_names),
+                 [](auto name) { return std::string{name}; });
+
+  std::vector<std::size_t> selected_variants;
+  for (const auto& name : variant_selection) {
+    auto found = std::find(std::begin(variant_names), std::end(variant_names), name);
+    if (found == std::end(variant_names)) {
+      fmt::print(stderr, "Unknown variant {}. The variants of this configuration are:", name);
+      for (const auto& known : variant_names) {
+        fmt::print(stderr, " {}", known);
+      }
+      fmt::print(stderr, "\n");
+      return 1;
+    }
+    selected_variants.push_back(static_cast<std::size_t>(std::distance(std::begin(variant_names), found)));
+  }
+  if (std::empty(selected_variants)) {
+    selected_variants.resize(std::size(variant_names));
+    std::iota(std::begin(selected_variants), std::end(selected_variants), 0);
+  }
 
-  fmt::print("\n*** ChampSim Multicore Out-of-Order Simulator ***\nWarmup Instructions: {}\nSimulation Instructions: {}\nNumber of CPUs: {}\nPage size: {}\n\n",
-             phases.at(0).length, phases.at(1).length, std::size(gen_environment.cpu_view()), PAGE_SIZE);
+  if (std::size(selected_variants) > 1 && (!save_checkpoint_name.empty() || !load_checkpoint_name.empty())) {
+    fmt::print(stderr, "Checkpoints can be saved or loaded for only one variant. Select it with --variant.\n");
+    return 1;
+  }
 
-  auto phase_stats = champsim::main(gen_environment, phases, traces);
+  auto make_environment = [](std::size_t variant) -> std::unique_ptr<champsim::environment> {
+    if (variant == 0) {
+      return std::make_unique<configured_environment>();
+    }
+    return configured_variants::make(variant - 1);
+  };
 
-  fmt::print("\nChampSim completed all CPUs\n\n");
+  auto simulate = [&](champsim::environment& env, std::vector<champsim::tracereader>& traces, const std::string& json_name) {
+    if (knob_hide_heartbeat) {
+      for (O3_CPU& cpu : env.cpu_view()) {
+        cpu.show_heartbeat = false;
+      }
+    }
 
-  champsim::plain_printer{std::cout}.print(phase_stats);
+    if (profile_reuse_option->count() > 0) {
+      for (CACHE& cache : env.cache_view()) {
+        cache.profile_reuse(reuse_sample_rate);
+      }
+    }
 
-  for (CACHE& cache : gen_environment.cache_view()) {
-    cache.impl_prefetcher_final_stats();
-  }
+    env.scheduler_view().parallelize(parallel_quantum);
+
+    fmt::print("\n*** ChampSim Multicore Out-of-Order Simulator ***\nWarmup Instructions: {}\nSimulation Instructions: {}\nNumber of CPUs: {}\nPage size: {}\n\n",
+               phases.at(0).length, phases.at(1).length, std::size(env.cpu_view()), PAGE_SIZE);
 
-  for (CACHE& cache : gen_environment.cache_view()) {
-    cache.impl_replacement_final_stats();
+    // A restored checkpoint takes the place of the warmup phase
+    auto simulated_phases = phases;
+    if (!load_checkpoint_name.empty()) {
+      simulated_phases.erase(std::begin(simulated_phases));
+    }
+
+    auto phase_stats = champsim::main(env, simulated_phases, traces);
+
+    fmt::print("\nChampSim completed all CPUs\n\n");
+
+    champsim::plain_printer{std::cout}.print(phase_stats);
+
+    for (CACHE& cache : env.cache_view()) {
+      cache.impl_prefetcher_final_stats();
+    }
+
+    for (CACHE& cache : env.cache_view()) {
+      cache.impl_replacement_final_stats();
+    }
+
+    if (json_option->count() > 0) {
+      if (json_name.empty()) {
+        champsim::json_printer{std::cout}.print(phase_stats);
+      } else {
+        std::ofstream json_file{json_name};
+        champsim::json_printer{json_file}.print(phase_stats);
+      }
+    }
+
+    return 0;
+  };
+
+  if (std::size(selected_variants) == 1) {
+    auto env = make_environment(selected_variants.front());
+
+    std::vector<champsim::tracereader> traces;
+    std::transform(
+        std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
+        [knob_cloudsuite, knob_cheri, knob_mmap, decompress_depth, repeat = simulation_given, i = uint8_t(0)](auto name) mutable {
+          return get_tracereader(name, i++, knob_cloudsuite, knob_cheri, repeat, decompress_depth, knob_mmap);
+        });
+
+    return simulate(*env, traces, json_file_name);
   }
 
-  if (json_option->count() > 0) {
-    if (json_file_name.empty()) {
-      champsim::json_printer{std::cout}.print(phase_stats);
-    } else {
-      std::ofstream json_file{json_file_name};
-      champsim::json_printer{json_file}.print(phase_stats);
+  // Build each CPU's capability memory before the variants are forked, so that they share it rather than each replaying the presimpoint records
+  if (knob_cheri && std::empty(load_cap_snapshot_names)) {
+    for (std::size_t i = 0; i < std::size(trace_names); ++i) {
+      auto reader = get_tracereader(trace_names[i], static_cast<uint8_t>(i), knob_cloudsuite, knob_cheri, false, decompress_depth, knob_mmap);
+      reader();
     }
   }
 
-  return 0;
+  std::vector<std::string> selected_names;
+  std::transform(std::begin(selected_variants), std::end(selected_variants), std::back_inserter(selected_names),
+                 [&](auto variant) { return variant_names.at(variant); });
+
+  return champsim::run_variants(selected_names, trace_names, simulation_given, [&](std::size_t i, std::vector<std::string> stream_names) {
+    auto variant = selected_variants.at(i);
+    auto env = make_environment(variant);
+
+    // The streams are already decompressed, and they repeat if needed
+    std::vector<champsim::tracereader> traces;
+    std::transform(std::begin(stream_names), std::end(stream_names), std::back_inserter(traces),
+                   [knob_cloudsuite, knob_cheri, i = uint8_t(0)](auto name) mutable { return get_tracereader(name, i++, knob_cloudsuite, knob_cheri, false); });
+
+    auto json_name = json_file_name.empty() ? json_file_name : champsim::variant_file_name(json_file_name, variant_names.at(variant));
+    return simulate(*env, traces, json_name);
+  });
 }
 #endif
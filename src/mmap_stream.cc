@@ -0,0 +1,104 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mmap_stream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fmt/core.h>
+
+champsim::mmap_istream::mmap_istream(const std::string& fname)
+{
+  auto fd = ::open(fname.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+  if (fd < 0) {
+    throw std::runtime_error{fmt::format("Could not open trace {}: {}", fname, std::strerror(errno))};
+  }
+
+  struct stat file_info {};
+  if (::fstat(fd, &file_info) != 0) {
+    ::close(fd);
+    throw std::runtime_error{fmt::format("Could not stat trace {}: {}", fname, std::strerror(errno))};
+  }
+
+  size_ = static_cast<std::size_t>(file_info.st_size);
+  if (size_ > 0) {
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error{fmt::format("Could not map trace {}: {}", fname, std::strerror(errno))};
+    }
+    begin_ = static_cast<const char*>(mapping);
+
+    // These are only hints, so failures are not errors
+    ::madvise(mapping, size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    ::madvise(mapping, size_, MADV_HUGEPAGE);
+#endif
+  }
+
+  // The mapping remains valid after the descriptor is closed
+  ::close(fd);
+}
+
+champsim::mmap_istream::mmap_istream(mmap_istream&& other) noexcept
+    : begin_(std::exchange(other.begin_, nullptr)), size_(std::exchange(other.size_, 0)), offset_(other.offset_), gcount_(other.gcount_), eof_(other.eof_)
+{
+}
+
+auto champsim::mmap_istream::operator=(mmap_istream&& other) noexcept -> mmap_istream&
+{
+  unmap();
+  begin_ = std::exchange(other.begin_, nullptr);
+  size_ = std::exchange(other.size_, 0);
+  offset_ = other.offset_;
+  gcount_ = other.gcount_;
+  eof_ = other.eof_;
+  return *this;
+}
+
+void champsim::mmap_istream::unmap()
+{
+  if (begin_ != nullptr) {
+    ::munmap(const_cast<char*>(begin_), size_); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    begin_ = nullptr;
+  }
+}
+
+std::pair<const char*, const char*> champsim::mmap_istream::read_in_place(std::size_t count)
+{
+  auto available = std::min(count, size_ - offset_);
+  auto first = std::next(begin_, static_cast<std::ptrdiff_t>(offset_));
+  offset_ += available;
+  gcount_ = static_cast<std::streamsize>(available);
+  eof_ = available < count;
+  return {first, std::next(first, static_cast<std::ptrdiff_t>(available))};
+}
+
+auto champsim::mmap_istream::read(char* s, std::streamsize count) -> mmap_istream&
+{
+  assert(count >= 0);
+  auto [first, last] = read_in_place(static_cast<std::size_t>(count));
+  std::copy(first, last, s);
+  return *this;
+}
@@ -16,8 +16,24 @@
 
 #include "modules.h"
 
+#include <fmt/core.h>
+
 #include "cache.h"
 
+std::vector<std::string> champsim::modules::section_names(std::vector<std::string> configured, std::size_t count)
+{
+  for (auto i = std::size(configured); i < count; ++i) {
+    configured.push_back(std::to_string(i));
+  }
+  configured.resize(count);
+  return configured;
+}
+
+void champsim::modules::warn_no_load_state(std::string_view kind, std::string_view name)
+{
+  fmt::print("[CHECKPOINT] WARNING: {} {} has no hook to load its state, so it starts cold\n", kind, name);
+}
+
 bool champsim::modules::prefetcher::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t prefetch_metadata) const
 {
   return intern_->prefetch_line(pf_addr, fill_this_level, prefetch_metadata);
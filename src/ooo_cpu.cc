@@ -27,6 +27,7 @@
 #include "cache.h"
 #include "champsim.h"
 #include "deadlock.h"
+#include "functional_warmer.h"
 #include "instruction.h"
 #include "util/span.h"
 #include "capability_memory.h"
@@ -167,7 +168,8 @@ bool O3_CPU::do_predict_branch(ooo_model_instr& arch_instr)
       fmt::print("[BRANCH] instr_id: {} ip: {} taken: {}\n", arch_instr.instr_id, arch_instr.ip, arch_instr.branch_taken);
     }
 
-    // call code prefetcher every time the branch predictor is used
+    // call code prefetcher every time the branch predictor is used. It may issue prefetches, which are work for the L1I.
+    l1i->wake();
     l1i->impl_prefetcher_branch_operate(arch_instr.ip, arch_instr.branch, predicted_branch_target);
 
     if (predicted_branch_target != arch_instr.branch_target
@@ -203,6 +205,72 @@ bool O3_CPU::do_init_instruction(ooo_model_instr& arch_instr)
   return do_predict_branch(arch_instr);
 }
 
+void O3_CPU::warm_instruction(ooo_model_instr instr, champsim::functional_warmer& warmer)
+{
+  do_init_instruction(instr);
+
+  // Instructions that miss in the DIB are fetched from the L1I and decoded into the DIB
+  if (!DIB.check_hit(instr.ip).has_value()) {
+    CacheBus::request_type fetch_packet;
+    fetch_packet.v_address = instr.ip;
+    fetch_packet.instr_id = instr.instr_id;
+    fetch_packet.ip = instr.ip;
+    fetch_packet.is_instr = true;
+
+    L1I_bus.warm_read(fetch_packet, warmer);
+    do_dib_update(instr);
+  }
+
+  for (auto smem : instr.source_memory) {
+    CacheBus::request_type data_packet;
+    data_packet.v_address = smem;
+    data_packet.instr_id = instr.instr_id;
+    data_packet.ip = instr.ip;
+    data_packet.cap = instr.auth_cap;
+
+    L1D_bus.warm_read(data_packet, warmer);
+  }
+
+  for (auto dmem : instr.destination_memory) {
+    CacheBus::request_type data_packet;
+    data_packet.v_address = dmem;
+    data_packet.instr_id = instr.instr_id;
+    data_packet.ip = instr.ip;
+    data_packet.cap = instr.auth_cap;
+
+    if (instr.transferred_cap.tag)
+      champsim::cap_mem[this->cpu].store_capability(data_packet.v_address, instr.transferred_cap);
+    else
+      champsim::cap_mem[this->cpu].invalidate_tag(data_packet.v_address);
+
+    L1D_bus.warm_write(data_packet, warmer);
+  }
+
+  ++num_retired;
+}
+
+void O3_CPU::save_state(champsim::checkpoint_writer& out) const
+{
+  out.write(num_retired);
+  DIB.save_state(out, [](auto& writer, champsim::address addr) { writer.write(addr.to<uint64_t>()); });
+  out.write_section("branch_predictor", [this](auto& section) { impl_branch_predictor_save_state(section); });
+  out.write_section("btb", [this](auto& section) { impl_btb_save_state(section); });
+}
+
+void O3_CPU::load_state(champsim::checkpoint_reader& in)
+{
+  in.read(num_retired);
+  DIB.load_state(in, [](auto& reader, champsim::address& addr) {
+    uint64_t value{};
+    reader.read(value);
+    addr = champsim::address{value};
+  });
+
+  auto sections = in.read_sections();
+  impl_branch_predictor_load_state(sections.at("branch_predictor"));
+  impl_btb_load_state(sections.at("btb"));
+}
+
 long O3_CPU::check_dib()
 {
   // scan through IFETCH_BUFFER to find instructions that hit in the decoded instruction buffer
@@ -269,7 +337,7 @@ long O3_CPU::fetch_instruction()
   return progress;
 }
 
-bool O3_CPU::do_fetch_instruction(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end)
+bool O3_CPU::do_fetch_instruction(instr_buffer_type::iterator begin, instr_buffer_type::iterator end)
 {
   CacheBus::request_type fetch_packet;
   fetch_packet.v_address = begin->ip;
@@ -301,10 +369,6 @@ long O3_CPU::promote_to_decode()
       std::min(FETCH_WIDTH, std::min(champsim::bandwidth::maximum_type{static_cast<long>(DIB_HIT_BUFFER_SIZE - std::size(DIB_HIT_BUFFER))},
                                      champsim::bandwidth::maximum_type{static_cast<long>(DECODE_BUFFER_SIZE - std::size(DECODE_BUFFER))}))};
 
-  auto fetched_check_end = std::find_if(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), [](const ooo_model_instr& x) { return !x.fetch_completed; });
-  // find the first not fetch completed
-  auto [window_begin, window_end] = champsim::get_span_p(std::begin(IFETCH_BUFFER), fetched_check_end, available_fetch_bandwidth, fetch_complete_and_ready);
-  auto decoded_window_end = std::stable_partition(window_begin, window_end, is_decoded); // reorder instructions
   auto mark_for_decode = [time = current_time, lat = DECODE_LATENCY, warmup = warmup](auto& x) {
     return x.ready_time = time + (warmup ? champsim::chrono::clock::duration{} : lat);
   };
@@ -313,15 +377,22 @@ long O3_CPU::promote_to_decode()
     return x.ready_time = time + lat;
   };
 
-  std::for_each(window_begin, decoded_window_end, mark_for_dib); // assume DECODE_LATENCY = DIB_HIT_LATENCY
-  std::move(window_begin, decoded_window_end, std::back_inserter(DIB_HIT_BUFFER));
-  // to DECODE_BUFFER
-
-  std::for_each(decoded_window_end, window_end, mark_for_decode);
-  std::move(decoded_window_end, window_end, std::back_inserter(DECODE_BUFFER));
+  // Move the fetched instructions at the front in order, the decoded ones to DIB_HIT_BUFFER and the others to DECODE_BUFFER
+  long progress{0};
+  for (; available_fetch_bandwidth.has_remaining() && !std::empty(IFETCH_BUFFER) && fetch_complete_and_ready(IFETCH_BUFFER.front());
+       available_fetch_bandwidth.consume()) {
+    auto& instr = IFETCH_BUFFER.front();
+    if (is_decoded(instr)) {
+      mark_for_dib(instr); // assume DECODE_LATENCY = DIB_HIT_LATENCY
+      DIB_HIT_BUFFER.push_back(std::move(instr));
+    } else {
+      mark_for_decode(instr);
+      DECODE_BUFFER.push_back(std::move(instr));
+    }
+    IFETCH_BUFFER.pop_front();
+    ++progress;
+  }
 
-  long progress{std::distance(window_begin, window_end)};
-  IFETCH_BUFFER.erase(window_begin, window_end);
   return progress;
 }
 long O3_CPU::decode_instruction()
@@ -330,42 +401,12 @@ long O3_CPU::decode_instruction()
     return x.ready_time <= time;
   };
 
-  auto dib_hit_buffer_begin = std::begin(DIB_HIT_BUFFER);
-  auto dib_hit_buffer_end = dib_hit_buffer_begin;
-  auto decode_buffer_begin = std::begin(DECODE_BUFFER);
-  auto decode_buffer_end = decode_buffer_begin;
-
   champsim::bandwidth available_decode_bandwidth{DECODE_WIDTH};
 
   // bw move instructions to dispatch_buffer
   champsim::bandwidth available_dib_inorder_bandwidth{
       std::min(DIB_INORDER_WIDTH, champsim::bandwidth::maximum_type{static_cast<long>(DISPATCH_BUFFER_SIZE - std::size(DISPATCH_BUFFER))})};
 
-  // conditions choose how many instructions sent to dispatch_buffer
-  while (dib_hit_buffer_end != std::end(DIB_HIT_BUFFER) && decode_buffer_end != std::end(DECODE_BUFFER) && available_dib_inorder_bandwidth.has_remaining()
-         && available_decode_bandwidth.has_remaining() && is_ready(std::min(*dib_hit_buffer_end, *decode_buffer_end, ooo_model_instr::program_order))) {
-    if (ooo_model_instr::program_order(*dib_hit_buffer_end, *decode_buffer_end)) {
-      dib_hit_buffer_end++;
-      available_dib_inorder_bandwidth.consume();
-    } else {
-      decode_buffer_end++;
-      available_dib_inorder_bandwidth.consume();
-      available_decode_bandwidth.consume();
-    }
-  }
-  while (dib_hit_buffer_end != std::end(DIB_HIT_BUFFER) && available_dib_inorder_bandwidth.has_remaining() && is_ready(*dib_hit_buffer_end)
-         && (decode_buffer_end == std::end(DECODE_BUFFER) || ooo_model_instr::program_order(*dib_hit_buffer_end, *decode_buffer_end))) {
-    dib_hit_buffer_end++;
-    available_dib_inorder_bandwidth.consume();
-  }
-  while (decode_buffer_end != std::end(DECODE_BUFFER) && available_dib_inorder_bandwidth.has_remaining() && available_decode_bandwidth.has_remaining()
-         && is_ready(*decode_buffer_end)
-         && (dib_hit_buffer_end == std::end(DIB_HIT_BUFFER) || ooo_model_instr::program_order(*decode_buffer_end, *dib_hit_buffer_end))) {
-    decode_buffer_end++;
-    available_dib_inorder_bandwidth.consume();
-    available_decode_bandwidth.consume();
-  }
-
   // decode instructions have not decoded, merge instructions with dib_hit_buffer then send to dispatch_buffer
   auto do_decode = [&, this](auto& db_entry) {
     this->do_dib_update(db_entry);
@@ -393,15 +434,28 @@ long O3_CPU::decode_instruction()
     dib_entry.ready_time = this->current_time + (this->warmup ? champsim::chrono::clock::duration{} : this->DISPATCH_LATENCY);
   };
 
-  std::for_each(decode_buffer_begin, decode_buffer_end, do_decode);
-  std::for_each(dib_hit_buffer_begin, dib_hit_buffer_end, do_dib_hit);
+  // Take the older of the two fronts, so that instructions reach dispatch_buffer in program order
+  long progress{0};
+  while (available_dib_inorder_bandwidth.has_remaining() && (!std::empty(DIB_HIT_BUFFER) || !std::empty(DECODE_BUFFER))) {
+    bool from_dib = std::empty(DECODE_BUFFER)
+                    || (!std::empty(DIB_HIT_BUFFER) && ooo_model_instr::program_order(DIB_HIT_BUFFER.front(), DECODE_BUFFER.front()));
+    auto& source = from_dib ? DIB_HIT_BUFFER : DECODE_BUFFER;
+    if (!is_ready(source.front()) || (!from_dib && !available_decode_bandwidth.has_remaining())) {
+      break;
+    }
 
-  long progress{std::distance(dib_hit_buffer_begin, dib_hit_buffer_end) + std::distance(decode_buffer_begin, decode_buffer_end)};
+    if (from_dib) {
+      do_dib_hit(source.front());
+    } else {
+      do_decode(source.front());
+      available_decode_bandwidth.consume();
+    }
+    available_dib_inorder_bandwidth.consume();
 
-  std::merge(dib_hit_buffer_begin, dib_hit_buffer_end, decode_buffer_begin, decode_buffer_end, std::back_inserter(DISPATCH_BUFFER),
-             ooo_model_instr::program_order);
-  DECODE_BUFFER.erase(decode_buffer_begin, decode_buffer_end);
-  DIB_HIT_BUFFER.erase(dib_hit_buffer_begin, dib_hit_buffer_end);
+    DISPATCH_BUFFER.push_back(std::move(source.front()));
+    source.pop_front();
+    ++progress;
+  }
 
   return progress;
 }
@@ -414,9 +468,7 @@ long O3_CPU::dispatch_instruction()
 
   // dispatch DISPATCH_WIDTH instructions into the ROB
   while (available_dispatch_bandwidth.has_remaining() && !std::empty(DISPATCH_BUFFER) && DISPATCH_BUFFER.front().ready_time <= current_time
-         && std::size(ROB) != ROB_SIZE
-         && ((std::size_t)std::count_if(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return !lq_entry.has_value(); })
-             >= std::size(DISPATCH_BUFFER.front().source_memory))
+         && std::size(ROB) < ROB_SIZE && std::size(LQ_free_slots) >= std::size(DISPATCH_BUFFER.front().source_memory)
          && ((std::size(DISPATCH_BUFFER.front().destination_memory) + std::size(SQ)) <= SQ_SIZE)) {
     ROB.push_back(std::move(DISPATCH_BUFFER.front()));
     DISPATCH_BUFFER.pop_front();
@@ -431,23 +483,41 @@ long O3_CPU::dispatch_instruction()
 
 long O3_CPU::schedule_instruction()
 {
-  champsim::bandwidth search_bw{SCHEDULER_SIZE};
+  auto lacks_registers = [&alloc = std::as_const(reg_allocator)](const ooo_model_instr& instr) {
+    unsigned long sources_to_allocate =
+        std::count_if(instr.source_registers.begin(), instr.source_registers.end(), [&alloc](auto srcreg) { return !alloc.isAllocated(srcreg); });
+    return alloc.count_free_registers() < (sources_to_allocate + instr.destination_registers.size());
+  };
+
+  // Instructions are scheduled in program order, so the scheduled instructions are a prefix of the ROB.
+  // The scheduler holds the oldest SCHEDULER_SIZE unexecuted instructions, so only the unscheduled ones among those are visited.
+  auto unscheduled_begin = std::partition_point(std::begin(ROB), std::end(ROB), [](const ooo_model_instr& x) { return x.scheduled; });
+  auto window_size = std::clamp<long>(champsim::to_underlying(SCHEDULER_SIZE) - num_scheduled_unexecuted, 0, std::distance(unscheduled_begin, std::end(ROB)));
+  auto window_end = std::next(unscheduled_begin, window_size);
+
+  // The register check has always been applied to the scheduled instructions ahead of the window as well.
+  // It can only fail for them when nearly all registers are in use, so they are only visited then.
+  if (reg_allocator.count_free_registers() < ooo_model_instr::max_sources + ooo_model_instr::max_destinations) {
+    champsim::bandwidth search_bw{SCHEDULER_SIZE};
+    for (auto rob_it = std::begin(ROB); rob_it != unscheduled_begin && search_bw.has_remaining(); ++rob_it) {
+      if (lacks_registers(*rob_it)) {
+        return 0;
+      }
+      if (!rob_it->executed) {
+        search_bw.consume();
+      }
+    }
+  }
+
   int progress{0};
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && search_bw.has_remaining(); ++rob_it) {
+  for (auto rob_it = unscheduled_begin; rob_it != window_end && rob_it->ready_time <= current_time; ++rob_it) {
     // if there aren't enough physical registers available for the next instruction, stop scheduling
-    unsigned long sources_to_allocate = std::count_if(rob_it->source_registers.begin(), rob_it->source_registers.end(),
-                                                      [&alloc = std::as_const(reg_allocator)](auto srcreg) { return !alloc.isAllocated(srcreg); });
-    if (reg_allocator.count_free_registers() < (sources_to_allocate + rob_it->destination_registers.size())) {
+    if (lacks_registers(*rob_it)) {
       break;
     }
-    if (!rob_it->scheduled && rob_it->ready_time <= current_time) {
-      do_scheduling(*rob_it);
-      ++progress;
-    }
 
-    if (!rob_it->executed) {
-      search_bw.consume();
-    }
+    do_scheduling(*rob_it);
+    ++progress;
   }
 
   return progress;
@@ -466,23 +536,59 @@ void O3_CPU::do_scheduling(ooo_model_instr& instr)
     dreg = reg_allocator.rename_dest_register(dreg, instr.instr_id);
   }
 
+  // Wait for the producers of any sources that are not yet valid
+  instr.num_reg_dependent = 0;
+  for (auto src_reg : instr.source_registers) {
+    if (!reg_allocator.isValid(src_reg)) {
+      reg_allocator.add_waiting_instr(src_reg, instr);
+      ++instr.num_reg_dependent;
+    }
+  }
+
   instr.scheduled = true;
+  ++num_scheduled_unexecuted;
+
+  if (instr.num_reg_dependent == 0) {
+    do_wakeup(instr);
+  }
+}
+
+namespace
+{
+// Orders the ready heap so that the oldest instruction is on top
+bool younger(const ooo_model_instr& lhs, const ooo_model_instr& rhs) { return ooo_model_instr::program_order(rhs, lhs); }
+} // namespace
+
+void O3_CPU::do_wakeup(ooo_model_instr& instr)
+{
+  ready_to_execute.emplace_back(instr);
+  std::push_heap(std::begin(ready_to_execute), std::end(ready_to_execute), younger);
 }
 
 long O3_CPU::execute_instruction()
 {
   champsim::bandwidth exec_bw{EXEC_WIDTH};
-  for (auto rob_it = std::begin(ROB); rob_it != std::end(ROB) && exec_bw.has_remaining(); ++rob_it) {
-    if (rob_it->scheduled && !rob_it->executed && rob_it->ready_time <= current_time) {
-      bool ready = std::all_of(std::begin(rob_it->source_registers), std::end(rob_it->source_registers),
-                               [&alloc = std::as_const(reg_allocator)](auto srcreg) { return alloc.isValid(srcreg); });
-      if (ready) {
-        do_execution(*rob_it);
-        exec_bw.consume();
-      }
+
+  // Issue the oldest ready instructions, setting aside those whose latency has not elapsed
+  not_yet_ready.clear();
+  while (!std::empty(ready_to_execute) && exec_bw.has_remaining()) {
+    std::pop_heap(std::begin(ready_to_execute), std::end(ready_to_execute), younger);
+    ooo_model_instr& instr = ready_to_execute.back();
+    ready_to_execute.pop_back();
+
+    if (instr.ready_time <= current_time) {
+      do_execution(instr);
+      exec_bw.consume();
+    } else {
+      not_yet_ready.emplace_back(instr);
     }
   }
 
+  for (ooo_model_instr& instr : not_yet_ready) {
+    ready_to_execute.emplace_back(instr);
+    std::push_heap(std::begin(ready_to_execute), std::end(ready_to_execute), younger);
+  }
+
   return exec_bw.amount_consumed();
 }
 
@@ -490,20 +596,24 @@ void O3_CPU::do_execution(ooo_model_instr& instr)
 {
   instr.executed = true;
   instr.ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
+  --num_scheduled_unexecuted;
 
   // Mark LQ entries as ready to translate
-  for (auto& lq_entry : LQ) {
+  // A slot may have been released by store forwarding, or reused by a later load
+  for (auto slot : instr.lq_slots) {
+    auto& lq_entry = LQ.at(slot);
     if (lq_entry.has_value() && lq_entry->instr_id == instr.instr_id) {
       lq_entry->ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
     }
   }
 
   // Mark SQ entries as ready to translate
-  for (auto& sq_entry : SQ) {
-    if (sq_entry.instr_id == instr.instr_id) {
-      sq_entry.ready_time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY);
-    }
-  }
+  // The SQ is filled in program order, so this instruction's entries are contiguous
+  auto sq_begin = std::partition_point(std::begin(SQ), std::end(SQ), LSQ_ENTRY::precedes(instr.instr_id));
+  auto sq_end = std::find_if_not(sq_begin, std::end(SQ), LSQ_ENTRY::matches_id(instr.instr_id));
+  std::for_each(sq_begin, sq_end, [time = current_time + (warmup ? champsim::chrono::clock::duration{} : EXEC_LATENCY)](auto& sq_entry) {
+    sq_entry.ready_time = time;
+  });
 
   if constexpr (champsim::debug_print) {
     fmt::print("[ROB] {} instr_id: {} ready_time: {}\n", __func__, instr.instr_id, instr.ready_time.time_since_epoch() / clock_period);
@@ -513,20 +623,21 @@ void O3_CPU::do_execution(ooo_model_instr& instr)
 void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
 {
   // load
+  instr.lq_slots.clear();
   for (auto& smem : instr.source_memory) {
-    auto q_entry = std::find_if_not(std::begin(LQ), std::end(LQ), [](const auto& lq_entry) { return lq_entry.has_value(); });
-    assert(q_entry != std::end(LQ));
+    assert(!std::empty(LQ_free_slots));
+    auto q_entry = std::next(std::begin(LQ), static_cast<long>(LQ_free_slots.top()));
+    instr.lq_slots.push_back(LQ_free_slots.top());
+    LQ_free_slots.pop();
     q_entry->emplace(smem, instr.instr_id, instr.ip, instr.asid, instr.auth_cap, instr.transferred_cap); // add it to the load queue
 
 
-    // Check for forwarding
-    auto sq_it = std::max_element(std::begin(SQ), std::end(SQ), [smem](const auto& lhs, const auto& rhs) {
-      return lhs.virtual_address != smem || (rhs.virtual_address == smem && LSQ_ENTRY::program_order(lhs, rhs));
-    });
-    if (sq_it != std::end(SQ) && sq_it->virtual_address == smem) {
+    // Check for forwarding from the youngest store to the same address
+    if (auto sq_found = SQ_youngest.find(smem.to<uint64_t>()); sq_found != std::end(SQ_youngest)) {
+      auto* sq_it = sq_found->second;
       if (sq_it->fetch_issued) { // Store already executed
         (*q_entry)->finish(instr);
-        q_entry->reset();
+        release_lq_entry(*q_entry);
       } else {
         assert(sq_it->instr_id < instr.instr_id);      // The found SQ entry is a prior store
         sq_it->lq_depend_on_me.emplace_back(*q_entry); // Forward the load when the store finishes
@@ -542,6 +653,12 @@ void O3_CPU::do_memory_scheduling(ooo_model_instr& instr)
   // store
   for (auto& dmem : instr.destination_memory) {
     SQ.emplace_back(dmem, instr.instr_id, instr.ip, instr.asid, instr.auth_cap, instr.transferred_cap); // add it to the store queue
+
+    // If an instruction stores to an address twice, loads forward from the first of its stores
+    auto [youngest, inserted] = SQ_youngest.try_emplace(dmem.to<uint64_t>(), &SQ.back());
+    if (!inserted && youngest->second->instr_id != instr.instr_id) {
+      youngest->second = &SQ.back();
+    }
   }
 
   if constexpr (champsim::debug_print) {
@@ -571,6 +688,11 @@ long O3_CPU::operate_lsq()
 
   auto [complete_begin, complete_end] = champsim::get_span_p(std::cbegin(SQ), std::cend(SQ), store_bw, do_complete);
   store_bw.consume(std::distance(complete_begin, complete_end));
+  std::for_each(complete_begin, complete_end, [this](const auto& sq_entry) {
+    if (auto found = SQ_youngest.find(sq_entry.virtual_address.template to<uint64_t>()); found != std::end(SQ_youngest) && found->second == &sq_entry) {
+      SQ_youngest.erase(found);
+    }
+  });
   SQ.erase(complete_begin, complete_end);
 
   champsim::bandwidth load_bw{LQ_WIDTH};
@@ -582,6 +704,8 @@ long O3_CPU::operate_lsq()
       if (success) {
         load_bw.consume();
         lq_entry->fetch_issued = true;
+        LQ_issued_slots.emplace(champsim::block_number{lq_entry->virtual_address}.to<uint64_t>(),
+                                static_cast<std::size_t>(std::distance(LQ.data(), &lq_entry)));
       }
     }
   }
@@ -603,10 +727,17 @@ void O3_CPU::do_finish_store(const LSQ_ENTRY& sq_entry)
     assert(dependent->producer_id == sq_entry.instr_id);
 
     dependent->finish(std::begin(ROB), std::end(ROB));
-    dependent.reset();
+    release_lq_entry(dependent);
   }
 }
 
+void O3_CPU::release_lq_entry(std::optional<LSQ_ENTRY>& lq_entry)
+{
+  assert(lq_entry.has_value());
+  lq_entry.reset();
+  LQ_free_slots.push(static_cast<std::size_t>(std::distance(LQ.data(), &lq_entry)));
+}
+
 bool O3_CPU::do_complete_store(const LSQ_ENTRY& sq_entry)
 {
   CacheBus::request_type data_packet;
@@ -652,8 +783,14 @@ bool O3_CPU::execute_load(const LSQ_ENTRY& lq_entry)
 void O3_CPU::do_complete_execution(ooo_model_instr& instr)
 {
   for (auto dreg : instr.destination_registers) {
-    // mark physical register's data as valid
-    reg_allocator.complete_dest_register(dreg);
+    // mark physical register's data as valid, and wake the instructions that were waiting on it
+    reg_allocator.complete_dest_register(dreg, woken_instrs);
+    for (ooo_model_instr& waiting : woken_instrs) {
+      assert(waiting.num_reg_dependent > 0);
+      if (--waiting.num_reg_dependent == 0) {
+        do_wakeup(waiting);
+      }
+    }
   }
 
   instr.completed = true;
@@ -685,8 +822,9 @@ long O3_CPU::handle_memory_return()
        fetch_bw.has_remaining() && l1i_bw.has_remaining() && !L1I_bus.lower_level->returned.empty(); l1i_bw.consume()) {
     auto& l1i_entry = L1I_bus.lower_level->returned.front();
 
-    while (fetch_bw.has_remaining() && !l1i_entry.instr_depend_on_me.empty()) {
-      auto fetched = std::find_if(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), ooo_model_instr::matches_id(l1i_entry.instr_depend_on_me.front()));
+    auto serviced_end = std::begin(l1i_entry.instr_depend_on_me);
+    for (; fetch_bw.has_remaining() && serviced_end != std::end(l1i_entry.instr_depend_on_me); ++serviced_end) {
+      auto fetched = ooo_model_instr::find_id(std::begin(IFETCH_BUFFER), std::end(IFETCH_BUFFER), *serviced_end);
       if (fetched != std::end(IFETCH_BUFFER) && champsim::block_number{fetched->ip} == champsim::block_number{l1i_entry.v_address} && fetched->fetch_issued) {
         fetched->fetch_completed = true;
         fetch_bw.consume();
@@ -696,9 +834,8 @@ long O3_CPU::handle_memory_return()
           fmt::print("[IFETCH] {} instr_id: {} fetch completed\n", __func__, fetched->instr_id);
         }
       }
-
-      l1i_entry.instr_depend_on_me.erase(std::begin(l1i_entry.instr_depend_on_me));
     }
+    l1i_entry.instr_depend_on_me.erase(std::begin(l1i_entry.instr_depend_on_me), serviced_end);
 
     // remove this entry if we have serviced all of its instructions
     if (l1i_entry.instr_depend_on_me.empty()) {
@@ -709,13 +846,16 @@ long O3_CPU::handle_memory_return()
 
   auto l1d_it = std::begin(L1D_bus.lower_level->returned);
   for (champsim::bandwidth l1d_bw{L1D_BANDWIDTH}; l1d_bw.has_remaining() && l1d_it != std::end(L1D_bus.lower_level->returned); l1d_bw.consume(), ++l1d_it) {
-    for (auto& lq_entry : LQ) {
-      if (lq_entry.has_value() && lq_entry->fetch_issued && champsim::block_number{lq_entry->virtual_address} == champsim::block_number{l1d_it->v_address}) {
-        lq_entry->finish(std::begin(ROB), std::end(ROB));
-        lq_entry.reset();
-        ++progress;
-      }
+    // Only the issued loads can be waiting on a response, and store forwarding releases loads before they are issued
+    auto [lq_begin, lq_end] = LQ_issued_slots.equal_range(champsim::block_number{l1d_it->v_address}.to<uint64_t>());
+    for (auto slot_it = lq_begin; slot_it != lq_end; ++slot_it) {
+      auto& lq_entry = LQ.at(slot_it->second);
+      assert(lq_entry.has_value() && lq_entry->fetch_issued);
+      lq_entry->finish(std::begin(ROB), std::end(ROB));
+      release_lq_entry(lq_entry);
+      ++progress;
     }
+    LQ_issued_slots.erase(lq_begin, lq_end);
     ++progress;
   }
   L1D_bus.lower_level->returned.erase(std::begin(L1D_bus.lower_level->returned), l1d_it);
@@ -761,6 +901,10 @@ bool O3_CPU::impl_predict_branch(champsim::address ip, champsim::address predict
   return branch_module_pimpl->impl_predict_branch(ip, predicted_target, always_taken, branch_type);
 }
 
+void O3_CPU::impl_branch_predictor_save_state(champsim::checkpoint_writer& out) const { branch_module_pimpl->impl_branch_predictor_save_state(out); }
+
+void O3_CPU::impl_branch_predictor_load_state(champsim::checkpoint_reader& in) const { branch_module_pimpl->impl_branch_predictor_load_state(in); }
+
 void O3_CPU::impl_initialize_btb() const { btb_module_pimpl->impl_initialize_btb(); }
 
 void O3_CPU::impl_update_btb(champsim::address ip, champsim::address predicted_target, bool taken, uint8_t branch_type) const
@@ -773,6 +917,10 @@ std::pair<champsim::address, bool> O3_CPU::impl_btb_prediction(champsim::address
   return btb_module_pimpl->impl_btb_prediction(ip, branch_type);
 }
 
+void O3_CPU::impl_btb_save_state(champsim::checkpoint_writer& out) const { btb_module_pimpl->impl_btb_save_state(out); }
+
+void O3_CPU::impl_btb_load_state(champsim::checkpoint_reader& in) const { btb_module_pimpl->impl_btb_load_state(in); }
+
 // LCOV_EXCL_START Exclude the following function from LCOV
 void O3_CPU::print_deadlock()
 {
@@ -835,9 +983,9 @@ LSQ_ENTRY::LSQ_ENTRY(champsim::address addr, champsim::program_ordered<LSQ_ENTRY
 }
 
 
-void LSQ_ENTRY::finish(std::deque<ooo_model_instr>::iterator begin, std::deque<ooo_model_instr>::iterator end) const
+void LSQ_ENTRY::finish(champsim::circular_buffer<ooo_model_instr>::iterator begin, champsim::circular_buffer<ooo_model_instr>::iterator end) const
 {
-  auto rob_entry = std::partition_point(begin, end, ooo_model_instr::precedes(this->instr_id));
+  auto rob_entry = ooo_model_instr::find_id(begin, end, this->instr_id);
   assert(rob_entry != end);
   finish(*rob_entry);
 }
@@ -855,17 +1003,17 @@ void LSQ_ENTRY::finish(ooo_model_instr& rob_entry) const
   }
 }
 
-bool CacheBus::issue_read(request_type data_packet)
+auto CacheBus::read_packet(request_type data_packet) const -> request_type
 {
   data_packet.address = data_packet.v_address;
   data_packet.is_translated = false;
   data_packet.cpu = cpu;
   data_packet.type = access_type::LOAD;
 
-  return lower_level->add_rq(data_packet);
+  return data_packet;
 }
 
-bool CacheBus::issue_write(request_type data_packet)
+auto CacheBus::write_packet(request_type data_packet) const -> request_type
 {
   data_packet.address = data_packet.v_address;
   data_packet.is_translated = false;
@@ -873,6 +1021,19 @@ bool CacheBus::issue_write(request_type data_packet)
   data_packet.type = access_type::WRITE;
   data_packet.response_requested = false;
 
+  return data_packet;
+}
 
-  return lower_level->add_wq(data_packet);
+bool CacheBus::issue_read(request_type data_packet) { return lower_level->add_rq(read_packet(data_packet)); }
+
+bool CacheBus::issue_write(request_type data_packet) { return lower_level->add_wq(write_packet(data_packet)); }
+
+auto CacheBus::warm_read(request_type data_packet, champsim::functional_warmer& warmer) const -> response_type
+{
+  return warmer.access(lower_level, read_packet(data_packet));
+}
+
+void CacheBus::warm_write(request_type data_packet, champsim::functional_warmer& warmer) const
+{
+  warmer.access(lower_level, write_packet(data_packet));
 }
@@ -16,6 +16,8 @@
 
 #include "operable.h"
 
+#include "scheduler.h"
+
 champsim::operable::operable() : operable(champsim::chrono::picoseconds{1}) {}
 
 champsim::operable::operable(champsim::chrono::picoseconds clock_period_) : clock_period(clock_period_) {}
@@ -33,7 +35,24 @@ long champsim::operable::operate_on(const champsim::chrono::clock& clock)
 long champsim::operable::_operate()
 {
   current_time += clock_period;
+  if (is_idle()) {
+    operate_idle(1);
+    return 0;
+  }
   return operate();
 }
 
+void champsim::operable::skip_idle(long cycles)
+{
+  current_time += cycles * clock_period;
+  operate_idle(cycles);
+}
+
+void champsim::operable::wake()
+{
+  if (sleeping_in != nullptr) {
+    sleeping_in->wake(sleeping_order);
+  }
+}
+
 uint64_t champsim::operable::current_cycle() const { return static_cast<uint64_t>(current_time.time_since_epoch() / clock_period); }
@@ -0,0 +1,75 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "page_permutation.h"
+
+#include <cassert>
+#include <random>
+
+#include "util/bits.h"
+
+namespace
+{
+// The finalizer of splitmix64, which spreads every input bit over the output
+uint64_t mix(uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+} // namespace
+
+champsim::page_permutation::page_permutation(uint64_t size, std::optional<uint64_t> seed) : num_indices(size)
+{
+  const auto index_bits = num_indices > 1 ? champsim::lg2(num_indices - 1) + 1 : 0;
+  half_bits = static_cast<unsigned>((index_bits + 1) / 2);
+
+  if (seed.has_value()) {
+    std::mt19937_64 rng{seed.value()};
+    std::array<uint64_t, rounds> round_keys{};
+    for (auto& key : round_keys) {
+      key = rng();
+    }
+    keys = round_keys;
+  }
+}
+
+uint64_t champsim::page_permutation::encrypt(uint64_t index) const
+{
+  const auto mask = champsim::bitmask(champsim::data::bits{half_bits});
+  auto left = (index >> half_bits) & mask;
+  auto right = index & mask;
+  for (auto key : keys.value()) {
+    auto next_right = left ^ (mix(right ^ key) & mask);
+    left = right;
+    right = next_right;
+  }
+  return (left << half_bits) | right;
+}
+
+uint64_t champsim::page_permutation::operator()(uint64_t index) const
+{
+  assert(index < num_indices);
+  if (!keys.has_value()) {
+    return index;
+  }
+
+  // The network permutes fewer than four times as many indices as the range, so few steps are expected
+  do {
+    index = encrypt(index);
+  } while (index >= num_indices);
+  return index;
+}
@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
 #include <numeric>
 #include <ratio>
 #include <string_view> // for string_view
@@ -36,6 +38,33 @@ auto print_ratio(N num, D denom)
   }
   return std::string{"-"};
 }
+
+// Print the miss ratio curve of each column side by side, up to the largest size at which the first column changes
+std::vector<std::string> format_miss_ratio_curves(std::string_view title, const std::vector<std::pair<std::string_view, std::vector<double>>>& columns)
+{
+  const auto& total = columns.front().second;
+  auto last_change = std::adjacent_find(std::rbegin(total), std::rend(total), std::not_equal_to<>{});
+  auto rows = (last_change == std::rend(total)) ? std::size_t{1} : static_cast<std::size_t>(std::distance(last_change, std::rend(total)));
+
+  std::vector<std::string> lines{};
+  lines.emplace_back("");
+  lines.emplace_back(title);
+
+  std::string header = fmt::format("  {:>10s}", "Blocks");
+  for (const auto& [name, curve] : columns) {
+    header += fmt::format(" {:>11s}", name);
+  }
+  lines.push_back(header);
+
+  for (std::size_t k = 0; k < rows; ++k) {
+    std::string line = fmt::format("  {:10d}", uint64_t{1} << k);
+    for (const auto& [name, curve] : columns) {
+      line += std::empty(curve) ? fmt::format(" {:>11s}", "-") : fmt::format(" {:11.4f}", curve.at(k));
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
 } // namespace
 
 std::vector<std::string> champsim::plain_printer::format(O3_CPU::stats_type stats)
@@ -118,6 +147,10 @@ std::vector<std::string> champsim::plain_printer::format(CACHE::stats_type stats
 
     lines.push_back(fmt::format("cpu{}->{} PREFETCH REQUESTED: {:10} ISSUED: {:10} USEFUL: {:10} USELESS: {:10}", cpu, stats.name, stats.pf_requested,
                                 stats.pf_issued, stats.pf_useful, stats.pf_useless));
+    if (stats.pf_dropped_resident + stats.pf_dropped_inflight + stats.pf_dropped_recent > 0) {
+      lines.push_back(fmt::format("cpu{}->{} PREFETCH DROPPED RESIDENT: {:10} INFLIGHT: {:10} RECENT: {:10}", cpu, stats.name, stats.pf_dropped_resident,
+                                  stats.pf_dropped_inflight, stats.pf_dropped_recent));
+    }
 
 
     // CHERI capability distributions — only for data-path caches/TLBs
@@ -311,6 +344,29 @@ std::vector<std::string> champsim::plain_printer::format(CACHE::stats_type stats
       lines.emplace_back("");
     }
 
+    if (auto total_curve = miss_ratio_curve(stats.reuse_distances, cpu, [](auto, auto) { return true; }); !std::empty(total_curve)) {
+      std::vector<std::pair<std::string_view, std::vector<double>>> by_type{{"TOTAL", total_curve}};
+      for (const auto type : {access_type::LOAD, access_type::RFO, access_type::PREFETCH, access_type::WRITE, access_type::TRANSLATION}) {
+        by_type.emplace_back(access_type_names.at(champsim::to_underlying(type)),
+                             miss_ratio_curve(stats.reuse_distances, cpu, [type](auto, auto x) { return x == type; }));
+      }
+
+      std::vector<std::pair<std::string_view, std::vector<double>>> by_size{{"TOTAL", total_curve}};
+      for (auto b : cap_size_coverage_events_with_untagged) {
+        by_size.emplace_back(cap_size_coverage_events_names.at(static_cast<std::size_t>(b)),
+                             miss_ratio_curve(stats.reuse_distances, cpu, [b](auto x, auto) { return x == b; }));
+      }
+
+      auto title = fmt::format("cpu{}->{} MISS RATIO CURVE (fully-associative LRU)", cpu, stats.name);
+      auto type_lines = format_miss_ratio_curves(title, by_type);
+      std::move(std::begin(type_lines), std::end(type_lines), std::back_inserter(lines));
+
+      auto size_title = fmt::format("cpu{}->{} MISS RATIO CURVE BY AUTHORITY CAPABILITY SIZE", cpu, stats.name);
+      auto size_lines = format_miss_ratio_curves(size_title, by_size);
+      std::move(std::begin(size_lines), std::end(size_lines), std::back_inserter(lines));
+      lines.emplace_back("");
+    }
+
     uint64_t total_downstream_demands = total_mshr_return - stats.mshr_return.value_or(std::pair{access_type::PREFETCH, cpu}, mshr_return_value_type{});
     lines.push_back(
         fmt::format("cpu{}->{} AVERAGE MISS LATENCY: {} cycles", cpu, stats.name, ::print_ratio(stats.total_miss_latency_cycles, total_downstream_demands)));
@@ -369,6 +425,16 @@ std::vector<std::string> champsim::plain_printer::format(champsim::phase_stats&
     }
   }
 
+  if (!std::empty(stats.sample_cpu_stats)) {
+    lines.emplace_back("");
+    lines.emplace_back("Sampled Statistics (summed over the detailed windows)");
+    for (std::size_t cpu = 0; cpu < std::size(stats.sample_cpu_stats); ++cpu) {
+      auto estimate = estimate_ipc(stats.sample_cpu_stats.at(cpu));
+      lines.push_back(fmt::format("CPU {} sampled IPC: {:.4g} ({:.4g} to {:.4g} with 95% confidence) windows: {}", cpu, estimate.ipc,
+                                  estimate.lower, estimate.upper, estimate.windows));
+    }
+  }
+
   lines.emplace_back("");
   lines.emplace_back("Region of Interest Statistics");
 
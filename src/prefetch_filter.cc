@@ -0,0 +1,73 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "prefetch_filter.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <fmt/core.h>
+
+#include "util/find_equal.h"
+
+champsim::prefetch_filter::prefetch_filter(std::size_t entries)
+    : num_ways(std::min(entries, max_ways)), num_sets(num_ways == 0 ? 0 : entries / num_ways), blocks(num_sets * num_ways, invalid_block),
+      next_victim(num_sets, 0)
+{
+  if (num_sets * num_ways != entries) {
+    throw std::invalid_argument{fmt::format("A prefetch filter of {} entries does not fill a whole number of {}-way sets", entries, num_ways)};
+  }
+}
+
+std::size_t champsim::prefetch_filter::set_offset(uint64_t block) const { return static_cast<std::size_t>(block % num_sets) * num_ways; }
+
+bool champsim::prefetch_filter::contains(uint64_t block) const
+{
+  if (std::empty(blocks) || block == invalid_block) {
+    return false;
+  }
+  return champsim::find_first_equal(std::data(blocks) + set_offset(block), num_ways, block) != num_ways;
+}
+
+void champsim::prefetch_filter::insert(uint64_t block)
+{
+  if (std::empty(blocks) || block == invalid_block || contains(block)) {
+    return;
+  }
+
+  const auto offset = set_offset(block);
+  auto* set_begin = std::data(blocks) + offset;
+
+  // Fill an empty way before replacing the oldest block
+  auto way = champsim::find_first_equal(set_begin, num_ways, invalid_block);
+  if (way == num_ways) {
+    auto& victim = next_victim.at(offset / num_ways);
+    way = victim;
+    victim = (victim + 1) % num_ways;
+  }
+  set_begin[way] = block;
+}
+
+void champsim::prefetch_filter::erase(uint64_t block)
+{
+  if (std::empty(blocks) || block == invalid_block) {
+    return;
+  }
+
+  auto* set_begin = std::data(blocks) + set_offset(block);
+  if (auto way = champsim::find_first_equal(set_begin, num_ways, block); way != num_ways) {
+    set_begin[way] = invalid_block;
+  }
+}
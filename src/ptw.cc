@@ -23,6 +23,7 @@
 
 #include "champsim.h"
 #include "deadlock.h"
+#include "functional_warmer.h"
 #include "instruction.h"
 #include "ptw_builder.h" // for ptw_builder
 #include "util/bits.h"   // for bitmask, lg2, splice_bits
@@ -54,7 +55,7 @@ PageTableWalker::mshr_type::mshr_type(const request_type& req, std::size_t level
   cap = req.cap;
 }
 
-auto PageTableWalker::handle_read(const request_type& handle_pkt, channel_type* ul) -> std::optional<mshr_type>
+auto PageTableWalker::begin_walk(const request_type& handle_pkt) -> mshr_type
 {
   pscl_entry walk_init = {handle_pkt.v_address, CR3_addr, std::size(pscl)};
   std::vector<std::optional<pscl_entry>> pscl_hits;
@@ -69,15 +70,22 @@ auto PageTableWalker::handle_read(const request_type& handle_pkt, channel_type*
   mshr_type fwd_mshr{handle_pkt, walk_init.level};
   fwd_mshr.address = champsim::address{champsim::splice(champsim::page_number{walk_init.ptw_addr}, champsim::page_offset{walk_offset})};
   fwd_mshr.v_address = handle_pkt.address;
-  if (handle_pkt.response_requested) {
-    fwd_mshr.to_return = {&ul->returned};
-  }
 
   if constexpr (champsim::debug_print) {
     fmt::print("[{}] {} address: {} v_address: {} pt_page_offset: {} translation_level: {} cycle: {}\n", NAME, __func__, fwd_mshr.address, handle_pkt.v_address,
                walk_offset.to<int>(), walk_init.level, current_time.time_since_epoch() / clock_period);
   }
 
+  return fwd_mshr;
+}
+
+auto PageTableWalker::handle_read(const request_type& handle_pkt, channel_type* ul) -> std::optional<mshr_type>
+{
+  mshr_type fwd_mshr = begin_walk(handle_pkt);
+  if (handle_pkt.response_requested) {
+    fwd_mshr.to_return = {&ul->returned};
+  }
+
   return step_translation(fwd_mshr);
 }
 
@@ -100,7 +108,7 @@ auto PageTableWalker::handle_fill(const mshr_type& fill_mshr) -> std::optional<m
   return step_translation(fwd_mshr);
 }
 
-auto PageTableWalker::step_translation(const mshr_type& source) -> std::optional<mshr_type>
+auto PageTableWalker::step_request(const mshr_type& source) -> request_type
 {
   request_type packet;
   packet.address = source.address;
@@ -113,7 +121,12 @@ auto PageTableWalker::step_translation(const mshr_type& source) -> std::optional
   packet.type = access_type::TRANSLATION;
   packet.cap = source.cap;
 
-  bool success = lower_level->add_rq(packet);
+  return packet;
+}
+
+auto PageTableWalker::step_translation(const mshr_type& source) -> std::optional<mshr_type>
+{
+  bool success = lower_level->add_rq(step_request(source));
   if (success) {
     return source;
   }
@@ -121,6 +134,58 @@ auto PageTableWalker::step_translation(const mshr_type& source) -> std::optional
   return std::nullopt;
 }
 
+auto PageTableWalker::warm_access(const request_type& pkt, champsim::functional_warmer& warmer) -> response_type
+{
+  mshr_type walk = begin_walk(pkt);
+  warmer.access(lower_level, step_request(walk));
+
+  while (walk.translation_level > 0) {
+    auto [ppage, penalty] = vmem->get_pte_pa(walk.cpu, champsim::page_number{walk.v_address}, walk.translation_level);
+    pscl.at(std::size(pscl) - walk.translation_level).fill({walk.v_address, ppage, walk.translation_level});
+
+    walk.address = ppage;
+    walk.translation_level -= 1;
+    warmer.access(lower_level, step_request(walk));
+  }
+
+  auto [ppage, penalty] = vmem->va_to_pa(walk.cpu, champsim::page_number{walk.v_address});
+  return response_type{walk.v_address, walk.v_address, champsim::address{ppage}, walk.pf_metadata, walk.cap, walk.instr_depend_on_me};
+}
+
+void PageTableWalker::save_state(champsim::checkpoint_writer& out) const
+{
+  out.write(std::size(pscl));
+  for (const auto& table : pscl) {
+    // The entries are written field by field, so that the padding of their addresses never reaches the checkpoint
+    table.save_state(out, [](auto& writer, const pscl_entry& entry) {
+      writer.write(entry.vaddr.to<uint64_t>());
+      writer.write(entry.ptw_addr.to<uint64_t>());
+      writer.write(entry.level);
+    });
+  }
+}
+
+void PageTableWalker::load_state(champsim::checkpoint_reader& in)
+{
+  std::size_t saved_levels{};
+  in.read(saved_levels);
+  if (saved_levels != std::size(pscl)) {
+    throw std::runtime_error{fmt::format("{} has {} PSCLs, but the checkpoint has {}", NAME, std::size(pscl), saved_levels)};
+  }
+
+  for (auto& table : pscl) {
+    table.load_state(in, [](auto& reader, pscl_entry& entry) {
+      uint64_t vaddr{};
+      uint64_t ptw_addr{};
+      reader.read(vaddr);
+      reader.read(ptw_addr);
+      reader.read(entry.level);
+      entry.vaddr = champsim::address{vaddr};
+      entry.ptw_addr = champsim::address{ptw_addr};
+    });
+  }
+}
+
 long PageTableWalker::operate()
 {
   long progress{0};
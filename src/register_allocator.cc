@@ -9,6 +9,7 @@ RegisterAllocator::RegisterAllocator(size_t num_physical_registers)
     free_registers.push(static_cast<PHYSICAL_REGISTER_ID>(i));
   }
   physical_register_file = std::vector<physical_register>(num_physical_registers, {0, 0, false, false});
+  waiting_instrs.resize(num_physical_registers);
   frontend_RAT.fill(-1); // default value for no mapping
   backend_RAT.fill(-1);
 }
@@ -42,10 +43,20 @@ PHYSICAL_REGISTER_ID RegisterAllocator::rename_src_register(int16_t reg)
   return phys;
 }
 
-void RegisterAllocator::complete_dest_register(PHYSICAL_REGISTER_ID physreg)
+void RegisterAllocator::add_waiting_instr(PHYSICAL_REGISTER_ID physreg, ooo_model_instr& instr)
+{
+  assert(!isValid(physreg));
+  waiting_instrs.at(physreg).emplace_back(instr);
+}
+
+void RegisterAllocator::complete_dest_register(PHYSICAL_REGISTER_ID physreg, std::vector<std::reference_wrapper<ooo_model_instr>>& woken)
 {
   // mark the physical register as valid
   physical_register_file.at(physreg).valid = true;
+
+  // hand the waiting instructions back to the core, and keep the caller's storage for the next waiters
+  woken.clear();
+  std::swap(woken, waiting_instrs.at(physreg));
 }
 
 void RegisterAllocator::retire_dest_register(PHYSICAL_REGISTER_ID physreg)
@@ -0,0 +1,119 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reuse_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+constexpr uint64_t hash_modulus = uint64_t{1} << 24;
+constexpr std::size_t initial_capacity = std::size_t{1} << 16;
+
+// The finalizer of splitmix64, which spreads nearby block numbers across the hash space
+uint64_t mix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+std::size_t bucket_of(double distance)
+{
+  if (distance < 1) {
+    return 0;
+  }
+  auto bucket = static_cast<std::size_t>(std::floor(std::log2(distance))) + 1;
+  return std::min(bucket, champsim::reuse_profiler::cold_bucket - 1);
+}
+} // namespace
+
+champsim::reuse_profiler::reuse_profiler(double sample_rate)
+    : rate(sample_rate), threshold(static_cast<uint64_t>(std::ceil(sample_rate * static_cast<double>(hash_modulus)))), marks(initial_capacity)
+{
+  if (!(sample_rate > 0 && sample_rate <= 1)) {
+    throw std::invalid_argument{"The sampling rate of a reuse profiler must be in (0, 1]"};
+  }
+}
+
+std::optional<std::size_t> champsim::reuse_profiler::access(uint64_t block)
+{
+  if (mix(block) % hash_modulus >= threshold) {
+    return std::nullopt;
+  }
+
+  if (now == std::size(marks)) {
+    compact();
+  }
+
+  auto bucket = cold_bucket;
+  auto [found, inserted] = last_access.try_emplace(block, now);
+  if (!inserted) {
+    auto distinct = count_before(now) - count_before(found->second + 1);
+    mark(found->second, -1);
+    found->second = now;
+    bucket = bucket_of(static_cast<double>(distinct) / rate);
+  }
+
+  mark(now, 1);
+  ++now;
+  return bucket;
+}
+
+void champsim::reuse_profiler::mark(uint64_t time, long delta)
+{
+  for (auto i = time + 1; i <= std::size(marks); i += i & (~i + 1)) {
+    marks[i - 1] += delta;
+  }
+}
+
+long champsim::reuse_profiler::count_before(uint64_t time) const
+{
+  long count = 0;
+  for (auto i = time; i > 0; i -= i & (~i + 1)) {
+    count += marks[i - 1];
+  }
+  return count;
+}
+
+void champsim::reuse_profiler::compact()
+{
+  // Renumber the last accesses consecutively, keeping their order, and grow the tree if they would fill most of it
+  std::vector<std::pair<uint64_t, uint64_t>> by_time;
+  by_time.reserve(std::size(last_access));
+  std::transform(std::begin(last_access), std::end(last_access), std::back_inserter(by_time), [](const auto& x) { return std::pair{x.second, x.first}; });
+  std::sort(std::begin(by_time), std::end(by_time));
+
+  auto capacity = std::size(marks);
+  while (2 * std::size(by_time) > capacity) {
+    capacity *= 2;
+  }
+  marks.assign(capacity, 0);
+
+  now = 0;
+  for (auto [time, block] : by_time) {
+    last_access[block] = now;
+    mark(now, 1);
+    ++now;
+  }
+}
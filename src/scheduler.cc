@@ -0,0 +1,401 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+struct champsim::scheduler::worker_pool {
+  std::vector<std::function<long()>> jobs;
+  std::vector<long> results;
+
+  std::mutex mtx;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+  unsigned long generation = 0;
+  std::size_t pending = 0;
+  bool stopping = false;
+
+  std::vector<std::thread> threads;
+
+  explicit worker_pool(std::size_t size);
+  ~worker_pool();
+
+  worker_pool(const worker_pool&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+
+  void loop(std::size_t idx);
+  long run();
+};
+
+champsim::scheduler::worker_pool::worker_pool(std::size_t size) : jobs(size), results(size)
+{
+  for (std::size_t i = 0; i < size; ++i) {
+    threads.emplace_back([this, i] { this->loop(i); });
+  }
+}
+
+champsim::scheduler::worker_pool::~worker_pool()
+{
+  {
+    std::lock_guard lock{mtx};
+    stopping = true;
+  }
+  start_cv.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void champsim::scheduler::worker_pool::loop(std::size_t idx)
+{
+  unsigned long seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock lock{mtx};
+      start_cv.wait(lock, [&] { return stopping || generation != seen_generation; });
+      if (stopping) {
+        return;
+      }
+      seen_generation = generation;
+    }
+
+    auto result = jobs[idx] ? jobs[idx]() : 0;
+
+    {
+      std::lock_guard lock{mtx};
+      results[idx] = result;
+      if (--pending == 0) {
+        done_cv.notify_one();
+      }
+    }
+  }
+}
+
+long champsim::scheduler::worker_pool::run()
+{
+  {
+    std::lock_guard lock{mtx};
+    pending = std::size(threads);
+    ++generation;
+  }
+  start_cv.notify_all();
+
+  std::unique_lock lock{mtx};
+  done_cv.wait(lock, [&] { return pending == 0; });
+
+  return std::accumulate(std::begin(results), std::end(results), long{0});
+}
+
+champsim::scheduler::scheduler(std::vector<std::reference_wrapper<operable>> ops)
+    : scheduler(ops, std::vector<std::size_t>(std::size(ops), shared_domain))
+{
+}
+
+champsim::scheduler::scheduler(std::vector<std::reference_wrapper<operable>> ops, std::vector<std::size_t> op_domains)
+    : operables(std::move(ops)), domains(std::move(op_domains)),
+      tick(std::accumulate(std::cbegin(operables), std::cend(operables), champsim::chrono::clock::duration::max(),
+                           [](const auto acc, const operable& y) { return std::min(acc, y.clock_period); }))
+{
+  assert(std::size(domains) == std::size(operables));
+  generations.resize(std::size(operables));
+  reset();
+}
+
+// The pool is an incomplete type in the header
+champsim::scheduler::~scheduler() = default;
+
+bool champsim::scheduler::later(const event& lhs, const event& rhs)
+{
+  return (lhs.wakeup == rhs.wakeup) ? lhs.order > rhs.order : lhs.wakeup > rhs.wakeup;
+}
+
+bool champsim::scheduler::is_stale(const event& ev) const { return ev.generation != generations[ev.order]; }
+
+void champsim::scheduler::parallelize(long ticks)
+{
+  assert(ticks >= 0);
+  quantum = ticks;
+
+  std::size_t num_domains = 0;
+  for (auto dom : domains) {
+    if (dom != shared_domain) {
+      num_domains = std::max(num_domains, dom + 1);
+    }
+  }
+
+  pool.reset();
+  if (quantum > 0 && num_domains > 0) {
+    pool = std::make_unique<worker_pool>(num_domains);
+  }
+  domain_calendars.resize(num_domains);
+  domain_work.resize(num_domains);
+  woken.reserve(std::size(operables));
+
+  // The jobs are installed once, and read the work for each call from the scheduler
+  for (std::size_t dom = 0; pool && dom < num_domains; ++dom) {
+    if (quantum == 1) {
+      pool->jobs[dom] = [this, dom] {
+        long dom_progress{0};
+        for (auto idx : domain_work[dom]) {
+          dom_progress += operables[idx].get().operate_on(*lockstep_clock);
+        }
+        domain_work[dom].clear();
+        return dom_progress;
+      };
+    } else {
+      pool->jobs[dom] = [this, dom] {
+        return operate_window(domain_calendars[dom], window_end);
+      };
+    }
+  }
+
+  reset();
+}
+
+long champsim::scheduler::ticks_per_call() const { return (pool && quantum > 1) ? quantum : 1; }
+
+void champsim::scheduler::reset()
+{
+  const bool relaxed = (pool && quantum > 1);
+
+  // Sleeping operables pass over the cycles before the last clock, which they would have operated
+  for (std::size_t i = 0; i < std::size(operables); ++i) {
+    if (operables[i].get().sleeping_in != nullptr) {
+      catch_up(i, last_now);
+    }
+  }
+
+  calendar.clear();
+  for (auto& dom_calendar : domain_calendars) {
+    dom_calendar.clear();
+  }
+
+  for (std::size_t i = 0; i < std::size(operables); ++i) {
+    auto& dest = (relaxed && domains[i] != shared_domain) ? domain_calendars.at(domains[i]) : calendar;
+    dest.push_back({operables[i].get().current_time, i, generations[i]});
+  }
+
+  std::make_heap(std::begin(calendar), std::end(calendar), later);
+  for (auto& dom_calendar : domain_calendars) {
+    std::make_heap(std::begin(dom_calendar), std::end(dom_calendar), later);
+  }
+}
+
+long champsim::scheduler::operate_on(const champsim::chrono::clock& clock)
+{
+  long progress{0};
+  if (!pool) {
+    progress = operate_serial(clock);
+  } else if (quantum == 1) {
+    progress = operate_lockstep(clock);
+  } else {
+    progress = operate_relaxed(clock);
+  }
+
+  last_now = clock.now();
+  return progress;
+}
+
+long champsim::scheduler::operate_serial(const champsim::chrono::clock& clock)
+{
+  long progress{0};
+  while (!std::empty(calendar) && calendar.front().wakeup < clock.now()) {
+    std::pop_heap(std::begin(calendar), std::end(calendar), later);
+    auto next = calendar.back();
+    calendar.pop_back();
+    if (is_stale(next)) {
+      continue;
+    }
+
+    operable& op = operables[next.order];
+    if (op.sleeping_in != nullptr) {
+      catch_up(next.order, next.wakeup);
+    }
+    assert(op.current_time == next.wakeup);
+
+    operating = next.order;
+    progress += op.operate_on(clock);
+    operating = none_operating;
+
+    schedule(next.order);
+  }
+
+  // Keep the earliest event live, so that it gives the next wakeup
+  while (!std::empty(calendar) && is_stale(calendar.front())) {
+    std::pop_heap(std::begin(calendar), std::end(calendar), later);
+    calendar.pop_back();
+  }
+
+  return progress;
+}
+
+void champsim::scheduler::schedule(std::size_t order)
+{
+  operable& op = operables[order];
+  auto wakeup = op.current_time;
+
+  // Every cycle that ends before the operable's next wakeup is idle, so it sleeps through them
+  if (auto idle_until = op.next_wakeup(); idle_until > op.current_time + op.clock_period) {
+    const auto idle_cycles = (idle_until - op.current_time - champsim::chrono::clock::duration{1}) / op.clock_period;
+    wakeup += idle_cycles * op.clock_period;
+    op.sleeping_in = this;
+    op.sleeping_order = order;
+  }
+
+  calendar.push_back({wakeup, order, generations[order]});
+  std::push_heap(std::begin(calendar), std::end(calendar), later);
+}
+
+void champsim::scheduler::catch_up(std::size_t order, champsim::chrono::clock::time_point until)
+{
+  operable& op = operables[order];
+  if (until > op.current_time) {
+    op.skip_idle((until - op.current_time + op.clock_period - champsim::chrono::clock::duration{1}) / op.clock_period);
+  }
+  op.sleeping_in = nullptr;
+}
+
+void champsim::scheduler::wake(std::size_t order)
+{
+  // Outside of a call to operate_on(), the sleeper has passed every cycle before the last clock
+  auto until = last_now;
+  if (operating != none_operating) {
+    // The sleeper has passed its cycles that come before the waker's cycle in progress, with ties going to the earlier operable
+    const operable& waker = operables[operating];
+    until = waker.current_time - waker.clock_period;
+    if (order < operating) {
+      until += champsim::chrono::clock::duration{1};
+    }
+  }
+
+  catch_up(order, until);
+
+  ++generations[order];
+  calendar.push_back({operables[order].get().current_time, order, generations[order]});
+  std::push_heap(std::begin(calendar), std::end(calendar), later);
+
+  // A stale event may lie far in the future, so they are discarded once they outnumber the operables
+  if (std::size(calendar) > 2 * std::size(operables)) {
+    calendar.erase(std::remove_if(std::begin(calendar), std::end(calendar), [this](const event& ev) { return is_stale(ev); }), std::end(calendar));
+    std::make_heap(std::begin(calendar), std::end(calendar), later);
+  }
+}
+
+long champsim::scheduler::operate_lockstep(const champsim::chrono::clock& clock)
+{
+  // Everything woken in this tick, in the serial order. Operating one operable never changes the time of another,
+  // so the order can be fixed before any of them are operated.
+  woken.clear();
+  while (!std::empty(calendar) && calendar.front().wakeup < clock.now()) {
+    std::pop_heap(std::begin(calendar), std::end(calendar), later);
+    woken.push_back(calendar.back());
+    calendar.pop_back();
+  }
+
+  auto is_shared = [this](const event& ev) {
+    return domains[ev.order] == shared_domain;
+  };
+
+  long progress{0};
+  lockstep_clock = &clock;
+  for (auto seg_begin = std::begin(woken); seg_begin != std::end(woken);) {
+    // Private operables between two shared operables can run concurrently, as long as each domain keeps its own order
+    auto seg_end = std::find_if(seg_begin, std::end(woken), is_shared);
+    const bool single_domain = std::all_of(seg_begin, seg_end, [dom = domains[seg_begin->order], this](const event& ev) { return domains[ev.order] == dom; });
+    if (single_domain) {
+      for (auto it = seg_begin; it != seg_end; ++it) {
+        progress += operables[it->order].get().operate_on(clock);
+      }
+    } else {
+      for (auto it = seg_begin; it != seg_end; ++it) {
+        domain_work[domains[it->order]].push_back(it->order);
+      }
+      progress += pool->run();
+    }
+
+    // Shared operables synchronize with all domains
+    if (seg_end != std::end(woken)) {
+      progress += operables[seg_end->order].get().operate_on(clock);
+      ++seg_end;
+    }
+    seg_begin = seg_end;
+  }
+
+  for (auto ev : woken) {
+    ev.wakeup = operables[ev.order].get().current_time;
+    calendar.push_back(ev);
+    std::push_heap(std::begin(calendar), std::end(calendar), later);
+  }
+
+  return progress;
+}
+
+long champsim::scheduler::operate_relaxed(const champsim::chrono::clock& clock)
+{
+  // Each domain runs through the whole window, then the shared operables catch up
+  window_end = clock.now();
+  auto progress = pool->run();
+  return progress + operate_window(calendar, clock.now());
+}
+
+long champsim::scheduler::operate_window(std::vector<event>& events, champsim::chrono::clock::time_point now)
+{
+  long progress{0};
+  auto tick_time = last_now;
+  while (!std::empty(events) && events.front().wakeup < now) {
+    // Jump to the first global tick that wakes the earliest operable
+    assert(events.front().wakeup >= tick_time);
+    tick_time += ((events.front().wakeup - tick_time) / tick + 1) * tick;
+    assert(tick_time <= now);
+
+    champsim::chrono::clock tick_clock{};
+    tick_clock.tick(tick_time.time_since_epoch());
+
+    while (!std::empty(events) && events.front().wakeup < tick_time) {
+      std::pop_heap(std::begin(events), std::end(events), later);
+      auto& next = events.back();
+      operable& op = operables[next.order];
+
+      progress += op.operate_on(tick_clock);
+
+      next.wakeup = op.current_time;
+      std::push_heap(std::begin(events), std::end(events), later);
+    }
+  }
+
+  return progress;
+}
+
+champsim::chrono::clock::time_point champsim::scheduler::next_wakeup() const
+{
+  auto retval = champsim::chrono::clock::time_point::max();
+  if (!std::empty(calendar)) {
+    retval = calendar.front().wakeup;
+  }
+  for (const auto& dom_calendar : domain_calendars) {
+    if (!std::empty(dom_calendar)) {
+      retval = std::min(retval, dom_calendar.front().wakeup);
+    }
+  }
+  return retval;
+}
@@ -19,7 +19,9 @@
 #include <fstream>
 #include <string>
 
+#include "async_stream.h"
 #include "inf_stream.h"
+#include "mmap_stream.h"
 #include "repeatable.h"
 
 namespace champsim
@@ -32,50 +34,86 @@ ooo_model_instr apply_branch_target(ooo_model_instr branch, const ooo_model_inst
   return branch;
 }
 
-template <template <class, class> typename R, typename T>
-champsim::tracereader get_tracereader_for_type(std::string fname, uint8_t cpu)
+template <typename T, typename S, typename... Args>
+champsim::tracereader make_tracereader(bool repeat, uint8_t cpu, std::string fname, Args... args)
+{
+  if (repeat) {
+    return champsim::tracereader{champsim::repeatable<champsim::bulk_tracereader<T, S>, uint8_t, std::string, Args...>(cpu, fname, args...)};
+  }
+  return champsim::tracereader{champsim::bulk_tracereader<T, S>(cpu, fname, args...)};
+}
+
+template <typename T, typename S>
+champsim::tracereader make_decompressing_tracereader(bool repeat, uint8_t cpu, std::string fname, std::size_t depth)
+{
+  // The producer thread hands over whole blocks of records
+  constexpr std::size_t records_per_block = 1024;
+  if (depth > 0) {
+    return make_tracereader<T, champsim::async_istream<S>>(repeat, cpu, fname, records_per_block * sizeof(T), depth);
+  }
+  return make_tracereader<T, S>(repeat, cpu, fname);
+}
+
+template <typename T>
+champsim::tracereader get_tracereader_for_type(std::string fname, uint8_t cpu, bool repeat, std::size_t depth, bool use_mmap)
 {
   if (bool is_gzip_compressed = (fname.substr(std::size(fname) - 2) == "gz"); is_gzip_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>(cpu, fname)};
+    return make_decompressing_tracereader<T, champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>(repeat, cpu, fname, depth);
   }
 
   if (bool is_lzma_compressed = (fname.substr(std::size(fname) - 2) == "xz"); is_lzma_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>(cpu, fname)};
+    return make_decompressing_tracereader<T, champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>(repeat, cpu, fname, depth);
   }
 
   if (bool is_bzip2_compressed = (fname.substr(std::size(fname) - 3) == "bz2"); is_bzip2_compressed) {
-    return champsim::tracereader{R<T, champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>(cpu, fname)};
+    return make_decompressing_tracereader<T, champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>(repeat, cpu, fname, depth);
   }
 
-  return champsim::tracereader{R<T, std::ifstream>(cpu, fname)};
+  if (bool is_raw = (std::size(fname) > 4 && fname.substr(std::size(fname) - 4) == ".raw"); use_mmap || is_raw) {
+    return make_tracereader<T, champsim::mmap_istream>(repeat, cpu, fname);
+  }
+
+  return make_tracereader<T, std::ifstream>(repeat, cpu, fname);
 }
-} // namespace champsim
 
-template <typename T, typename S>
-using repeatable_reader_t = champsim::repeatable<champsim::bulk_tracereader<T, S>, uint8_t, std::string>;
+template <typename S>
+std::function<std::size_t(char*, std::size_t)> make_trace_bytes(std::string fname)
+{
+  auto trace_file = std::make_shared<S>(fname);
+  return [trace_file](char* buf, std::size_t count) {
+    trace_file->read(buf, static_cast<std::streamsize>(count));
+    return static_cast<std::size_t>(trace_file->gcount());
+  };
+}
+} // namespace champsim
 
-champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool is_cheri, bool repeat)
+champsim::tracereader get_tracereader(const std::string& fname, uint8_t cpu, bool is_cloudsuite, bool is_cheri, bool repeat, std::size_t decompress_depth,
+                                      bool use_mmap)
 {
-  if (is_cloudsuite && repeat) {
-    return champsim::get_tracereader_for_type<repeatable_reader_t, cloudsuite_instr>(fname, cpu);
+  if (is_cloudsuite) {
+    return champsim::get_tracereader_for_type<cloudsuite_instr>(fname, cpu, repeat, decompress_depth, use_mmap);
   }
 
-  if (is_cloudsuite && !repeat) {
-    return champsim::get_tracereader_for_type<champsim::bulk_tracereader, cloudsuite_instr>(fname, cpu);
+  if (is_cheri) {
+    return champsim::get_tracereader_for_type<cheri_instr>(fname, cpu, repeat, decompress_depth, use_mmap);
   }
 
-  if (is_cheri && repeat) {
-    return champsim::get_tracereader_for_type<repeatable_reader_t, cheri_instr>(fname, cpu);
-  }
-  
-  if (is_cheri && !repeat) {
-    return champsim::get_tracereader_for_type<champsim::bulk_tracereader, cheri_instr>(fname, cpu);
+  return champsim::get_tracereader_for_type<input_instr>(fname, cpu, repeat, decompress_depth, use_mmap);
+}
+
+std::function<std::size_t(char*, std::size_t)> get_trace_bytes(const std::string& fname)
+{
+  if (bool is_gzip_compressed = (fname.substr(std::size(fname) - 2) == "gz"); is_gzip_compressed) {
+    return champsim::make_trace_bytes<champsim::inf_istream<champsim::decomp_tags::gzip_tag_t<>>>(fname);
   }
 
-  if (repeat) {
-    return champsim::get_tracereader_for_type<repeatable_reader_t, input_instr>(fname, cpu);
+  if (bool is_lzma_compressed = (fname.substr(std::size(fname) - 2) == "xz"); is_lzma_compressed) {
+    return champsim::make_trace_bytes<champsim::inf_istream<champsim::decomp_tags::lzma_tag_t<>>>(fname);
   }
 
+  if (bool is_bzip2_compressed = (fname.substr(std::size(fname) - 3) == "bz2"); is_bzip2_compressed) {
+    return champsim::make_trace_bytes<champsim::inf_istream<champsim::decomp_tags::bzip2_tag_t>>(fname);
+  }
 
-  return champsim::get_tracereader_for_type<champsim::bulk_tracereader, input_instr>(fname, cpu);
+  return champsim::make_trace_bytes<std::ifstream>(fname);
 }
@@ -0,0 +1,344 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "variants.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fmt/core.h>
+
+#include "tracereader.h"
+
+namespace
+{
+constexpr std::size_t chunk_size = std::size_t{1} << 20;
+constexpr int stall_timeout_ms = 100;
+
+/**
+ * A trace, read once and written to the pipe of every variant. Each chunk is kept until it has been written to every pipe.
+ */
+struct trace_stream {
+  struct reader {
+    int fd;
+    std::size_t chunk = 0; // The index of the chunk being written, counted from the beginning of the trace
+    std::size_t offset = 0;
+  };
+
+  std::string name;
+  bool repeat;
+  std::size_t max_chunks;
+  std::function<std::size_t(char*, std::size_t)> source = get_trace_bytes(name);
+  std::deque<std::vector<char>> chunks{};
+  std::size_t first_chunk = 0;
+  std::size_t extra_chunks = 0; // Allowed beyond max_chunks to break a stall
+  bool ended = false;
+  std::vector<reader> readers{};
+
+  [[nodiscard]] bool caught_up(const reader& r) const { return r.chunk == first_chunk + std::size(chunks); }
+  [[nodiscard]] bool full() const { return std::size(chunks) >= max_chunks + extra_chunks; }
+
+  /**
+   * Read the next chunk of the trace. Returns false if the trace has ended.
+   */
+  bool read_chunk()
+  {
+    if (ended) {
+      return false;
+    }
+
+    std::vector<char> buf(chunk_size);
+    auto bytes_read = source(std::data(buf), std::size(buf));
+    if (bytes_read == 0 && repeat) {
+      source = get_trace_bytes(name);
+      bytes_read = source(std::data(buf), std::size(buf));
+    }
+
+    if (bytes_read == 0) {
+      ended = true;
+      return false;
+    }
+
+    buf.resize(bytes_read);
+    chunks.push_back(std::move(buf));
+    return true;
+  }
+
+  /**
+   * Release the chunks that have been written to every open pipe.
+   */
+  void release()
+  {
+    auto keep_from = first_chunk + std::size(chunks);
+    for (const auto& r : readers) {
+      if (r.fd >= 0) {
+        keep_from = std::min(keep_from, r.chunk);
+      }
+    }
+    while (first_chunk < keep_from) {
+      chunks.pop_front();
+      ++first_chunk;
+    }
+    if (std::size(chunks) < max_chunks) {
+      extra_chunks = 0;
+    }
+  }
+};
+
+void close_reader(trace_stream::reader& r)
+{
+  ::close(r.fd);
+  r.fd = -1;
+}
+
+/**
+ * Whether the variant has read everything that was written to its pipe
+ */
+bool drained(const trace_stream::reader& r)
+{
+  int pending = 0;
+  return ::ioctl(r.fd, FIONREAD, &pending) == 0 && pending == 0;
+}
+
+/**
+ * A variant that is held back on one trace can be the slowest reader of another. If every variant has drained a pipe that is held back,
+ * none of them can make progress, so let each such trace hold one more chunk.
+ */
+void relieve_stall(std::vector<trace_stream>& traces)
+{
+  const auto num_variants = std::empty(traces) ? std::size_t{0} : std::size(traces.front().readers);
+  auto starved = [](const trace_stream& trace, const trace_stream::reader& r) {
+    return r.fd >= 0 && trace.caught_up(r) && drained(r);
+  };
+
+  for (std::size_t i = 0; i < num_variants; ++i) {
+    bool reading = std::any_of(std::cbegin(traces), std::cend(traces), [i](const trace_stream& trace) { return trace.readers[i].fd >= 0; });
+    bool waiting = std::any_of(std::cbegin(traces), std::cend(traces), [i, starved](const trace_stream& trace) { return starved(trace, trace.readers[i]); });
+    if (reading && !waiting) {
+      return; // This variant is still simulating, and will eventually release a chunk
+    }
+  }
+
+  for (auto& trace : traces) {
+    if (std::any_of(std::cbegin(trace.readers), std::cend(trace.readers), [&trace, starved](const auto& r) { return starved(trace, r); })) {
+      ++trace.extra_chunks;
+    }
+  }
+}
+
+void stream_traces(std::vector<trace_stream>& traces)
+{
+  std::vector<pollfd> pollfds;
+  std::vector<std::pair<trace_stream*, trace_stream::reader*>> polled;
+  for (;;) {
+    pollfds.clear();
+    polled.clear();
+    bool held_back = false;
+    for (auto& trace : traces) {
+      for (auto& r : trace.readers) {
+        if (r.fd >= 0 && trace.caught_up(r) && (trace.ended || !trace.full()) && !trace.read_chunk()) {
+          close_reader(r); // The variant reads the end of the trace
+        }
+        if (r.fd >= 0) {
+          // A variant that is too far ahead waits for the slowest one, but is still polled to learn if it stops reading
+          bool wait = trace.caught_up(r);
+          held_back = held_back || wait;
+          pollfds.push_back({r.fd, static_cast<short>(wait ? 0 : POLLOUT), 0});
+          polled.emplace_back(&trace, &r);
+        }
+      }
+    }
+
+    if (std::empty(pollfds)) {
+      return;
+    }
+
+    auto ready = ::poll(std::data(pollfds), std::size(pollfds), held_back ? stall_timeout_ms : -1);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error{fmt::format("Could not poll the variants' trace streams: {}", std::strerror(errno))};
+    }
+
+    if (ready == 0) {
+      relieve_stall(traces);
+      continue;
+    }
+
+    for (std::size_t i = 0; i < std::size(pollfds); ++i) {
+      if (pollfds[i].revents == 0) {
+        continue;
+      }
+
+      auto [trace, r] = polled[i];
+      if (trace->caught_up(*r)) {
+        close_reader(*r); // The variant has stopped reading the trace
+        continue;
+      }
+
+      const auto& chunk = trace->chunks.at(r->chunk - trace->first_chunk);
+      auto written = ::write(r->fd, std::next(std::data(chunk), static_cast<std::ptrdiff_t>(r->offset)), std::size(chunk) - r->offset);
+      if (written < 0) {
+        if (errno != EAGAIN && errno != EINTR) {
+          close_reader(*r); // The variant has stopped reading the trace
+        }
+        continue;
+      }
+
+      r->offset += static_cast<std::size_t>(written);
+      if (r->offset == std::size(chunk)) {
+        ++r->chunk;
+        r->offset = 0;
+      }
+    }
+
+    for (auto& trace : traces) {
+      trace.release();
+    }
+  }
+}
+} // namespace
+
+int champsim::run_variants(const std::vector<std::string>& variant_names, const std::vector<std::string>& trace_names, bool repeat,
+                           const std::function<int(std::size_t, std::vector<std::string>)>& simulate, std::size_t max_buffered)
+{
+  fmt::print("Simulating variants:");
+  for (const auto& name : variant_names) {
+    fmt::print(" {}", name);
+  }
+  fmt::print("\n");
+
+  std::vector<std::FILE*> outputs;
+  std::vector<std::vector<std::array<int, 2>>> pipes;
+  for (std::size_t i = 0; i < std::size(variant_names); ++i) {
+    outputs.push_back(std::tmpfile());
+    if (outputs.back() == nullptr) {
+      throw std::runtime_error{fmt::format("Could not create the output file of variant {}: {}", variant_names[i], std::strerror(errno))};
+    }
+
+    auto& variant_pipes = pipes.emplace_back(std::size(trace_names));
+    for (auto& fds : variant_pipes) {
+      if (::pipe(std::data(fds)) < 0) {
+        throw std::runtime_error{fmt::format("Could not create a trace stream for variant {}: {}", variant_names[i], std::strerror(errno))};
+      }
+    }
+  }
+
+  // Buffered output would otherwise be written again by each child
+  std::cout.flush();
+  std::fflush(stdout);
+
+  std::vector<pid_t> children;
+  for (std::size_t i = 0; i < std::size(variant_names); ++i) {
+    auto pid = ::fork();
+    if (pid < 0) {
+      throw std::runtime_error{fmt::format("Could not start variant {}: {}", variant_names[i], std::strerror(errno))};
+    }
+
+    if (pid == 0) {
+      // Keep only the read ends of this variant's own pipes, so that each stream ends when the parent closes it
+      std::vector<std::string> stream_names;
+      for (std::size_t j = 0; j < std::size(pipes); ++j) {
+        for (auto [read_fd, write_fd] : pipes[j]) {
+          ::close(write_fd);
+          if (j == i) {
+            stream_names.push_back(fmt::format("/dev/fd/{}", read_fd));
+          } else {
+            ::close(read_fd);
+          }
+        }
+      }
+      ::dup2(::fileno(outputs[i]), STDOUT_FILENO);
+
+      int status = EXIT_FAILURE;
+      try {
+        status = simulate(i, stream_names);
+      } catch (const std::exception& e) {
+        fmt::print(stderr, "Variant {} failed: {}\n", variant_names[i], e.what());
+      }
+      std::cout.flush();
+      std::fflush(stdout);
+      std::_Exit(status);
+    }
+
+    children.push_back(pid);
+  }
+
+  // Keep only the write ends, which do not block, so that one variant waiting on a trace cannot stall the others
+  std::signal(SIGPIPE, SIG_IGN);
+  std::vector<trace_stream> traces;
+  for (std::size_t j = 0; j < std::size(trace_names); ++j) {
+    auto& trace = traces.emplace_back(trace_stream{trace_names[j], repeat, std::max<std::size_t>(1, max_buffered / chunk_size)});
+    for (auto& variant_pipes : pipes) {
+      auto [read_fd, write_fd] = variant_pipes[j];
+      ::close(read_fd);
+      ::fcntl(write_fd, F_SETFL, ::fcntl(write_fd, F_GETFL) | O_NONBLOCK);
+      trace.readers.push_back({write_fd});
+    }
+  }
+
+  stream_traces(traces);
+
+  int result = 0;
+  for (std::size_t i = 0; i < std::size(children); ++i) {
+    int status = 0;
+    while (::waitpid(children[i], &status, 0) < 0 && errno == EINTR) {
+    }
+
+    fmt::print("\n=== Variant {} ===\n", variant_names[i]);
+    std::fflush(stdout);
+    std::rewind(outputs[i]);
+    std::array<char, BUFSIZ> buf{};
+    for (auto count = std::fread(std::data(buf), 1, std::size(buf), outputs[i]); count > 0; count = std::fread(std::data(buf), 1, std::size(buf), outputs[i])) {
+      std::fwrite(std::data(buf), 1, count, stdout);
+    }
+    std::fclose(outputs[i]);
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      fmt::print(stderr, "Variant {} did not complete\n", variant_names[i]);
+      result = EXIT_FAILURE;
+    }
+  }
+  std::fflush(stdout);
+
+  return result;
+}
+
+std::string champsim::variant_file_name(const std::string& fname, std::string_view variant)
+{
+  std::filesystem::path path{fname};
+  auto extension = path.extension();
+  path.replace_extension();
+  path += ".";
+  path += variant;
+  path += extension;
+  return path.string();
+}
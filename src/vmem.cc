@@ -16,7 +16,11 @@
 
 #include "vmem.h"
 
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
 #include <fmt/core.h>
 
 #include "champsim.h"
@@ -45,7 +49,6 @@ VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::si
     fmt::print("[VMEM] WARNING: physical memory size is smaller than virtual memory size.\n"); // LCOV_EXCL_LINE
   }
   populate_pages();
-  shuffle_pages();
 }
 
 VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::size_t page_table_levels, champsim::chrono::clock::duration minor_penalty,
@@ -57,20 +60,10 @@ VirtualMemory::VirtualMemory(champsim::data::bytes page_table_page_size, std::si
 void VirtualMemory::populate_pages()
 {
   assert(dram.size() > 1_MiB);
-  ppage_free_list.resize(((dram.size() - 1_MiB) / PAGE_SIZE).count());
-  assert(ppage_free_list.size() != 0);
-  champsim::page_number base_address =
-      champsim::page_number{champsim::lowest_address_for_size(std::max<champsim::data::mebibytes>(champsim::data::bytes{PAGE_SIZE}, 1_MiB))};
-  for (auto it = ppage_free_list.begin(); it != ppage_free_list.end(); it++) {
-    *it = base_address;
-    base_address++;
-  }
-}
-
-void VirtualMemory::shuffle_pages()
-{
-  if (randomization_seed.has_value())
-    std::shuffle(ppage_free_list.begin(), ppage_free_list.end(), std::mt19937_64{randomization_seed.value()});
+  ppage_base = champsim::page_number{champsim::lowest_address_for_size(std::max<champsim::data::mebibytes>(champsim::data::bytes{PAGE_SIZE}, 1_MiB))};
+  ppage_order = champsim::page_permutation{static_cast<uint64_t>(((dram.size() - 1_MiB) / PAGE_SIZE).count()), randomization_seed};
+  ppages_allocated = 0;
+  assert(ppage_order.size() != 0);
 }
 
 champsim::dynamic_extent VirtualMemory::extent(std::size_t level) const
@@ -89,24 +82,23 @@ uint64_t VirtualMemory::get_offset(champsim::page_number vaddr, std::size_t leve
 champsim::page_number VirtualMemory::ppage_front() const
 {
   assert(available_ppages() > 0);
-  return ppage_free_list.front();
+  return ppage_base + static_cast<champsim::page_number::difference_type>(ppage_order(ppages_allocated));
 }
 
 void VirtualMemory::ppage_pop()
 {
-  ppage_free_list.pop_front();
+  ++ppages_allocated;
   if (available_ppages() == 0) {
     fmt::print("[VMEM] WARNING: Out of physical memory, freeing ppages\n");
-    populate_pages();
-    shuffle_pages();
+    ppages_allocated = 0;
   }
 }
 
-std::size_t VirtualMemory::available_ppages() const { return (ppage_free_list.size()); }
+std::size_t VirtualMemory::available_ppages() const { return static_cast<std::size_t>(ppage_order.size() - ppages_allocated); }
 
 std::pair<champsim::page_number, champsim::chrono::clock::duration> VirtualMemory::va_to_pa(uint32_t cpu_num, champsim::page_number vaddr)
 {
-  auto [ppage, fault] = vpage_to_ppage_map.try_emplace({cpu_num, champsim::page_number{vaddr}}, ppage_front());
+  auto [ppage, fault] = vpage_to_ppage_map.try_emplace({cpu_num, 0, champsim::page_number{vaddr}.to<uint64_t>()}, ppage_front());
 
   // this vpage doesn't yet have a ppage mapping
   if (fault) {
@@ -116,17 +108,17 @@ std::pair<champsim::page_number, champsim::chrono::clock::duration> VirtualMemor
   auto penalty = fault ? minor_fault_penalty : champsim::chrono::clock::duration::zero();
 
   if constexpr (champsim::debug_print) {
-    fmt::print("[VMEM] {} paddr: {} vpage: {} fault: {}\n", __func__, ppage->second, champsim::page_number{vaddr}, fault);
+    fmt::print("[VMEM] {} paddr: {} vpage: {} fault: {}\n", __func__, *ppage, champsim::page_number{vaddr}, fault);
   }
 
-  return std::pair{ppage->second, penalty};
+  return std::pair{*ppage, penalty};
 }
 
 std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::get_pte_pa(uint32_t cpu_num, champsim::page_number vaddr, std::size_t level)
 {
   champsim::dynamic_extent pte_table_entry_extent{champsim::address::bits, shamt(level + 1)};
-  auto [ppage, fault] =
-      page_table.try_emplace({cpu_num, level, champsim::address_slice{pte_table_entry_extent, vaddr}}, champsim::splice(active_pte_page, next_pte_page));
+  auto [ppage, fault] = page_table.try_emplace({cpu_num, static_cast<uint32_t>(level), champsim::address_slice{pte_table_entry_extent, vaddr}.to<uint64_t>()},
+                                               champsim::address{champsim::splice(active_pte_page, next_pte_page)});
 
   // this PTE doesn't yet have a mapping
   if (fault) {
@@ -139,9 +131,9 @@ std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::g
 
   auto offset = get_offset(vaddr, level);
   champsim::address paddr{
-      champsim::splice(ppage->second, champsim::address_slice{champsim::dynamic_extent{champsim::data::bits{champsim::lg2(pte_entry::byte_multiple)},
-                                                                                       static_cast<std::size_t>(champsim::lg2(pte_page_size.count()))},
-                                                              offset})};
+      champsim::splice(*ppage, champsim::address_slice{champsim::dynamic_extent{champsim::data::bits{champsim::lg2(pte_entry::byte_multiple)},
+                                                                                static_cast<std::size_t>(champsim::lg2(pte_page_size.count()))},
+                                                       offset})};
   if constexpr (champsim::debug_print) {
     fmt::print("[VMEM] {} paddr: {} vaddr: {} pt_page_offset: {} translation_level: {} fault: {}\n", __func__, paddr, vaddr, offset, level, fault);
   }
@@ -153,3 +145,94 @@ std::pair<champsim::address, champsim::chrono::clock::duration> VirtualMemory::g
 
   return {paddr, penalty};
 }
+
+namespace
+{
+struct saved_page {
+  uint32_t cpu;
+  uint64_t vpage;
+  uint64_t ppage;
+};
+
+struct saved_pte_page {
+  uint32_t cpu;
+  uint32_t level;
+  uint64_t upper;
+  uint64_t lower;
+  uint64_t vaddr;
+  uint64_t paddr;
+};
+} // namespace
+
+void VirtualMemory::save_state(champsim::checkpoint_writer& out) const
+{
+  std::vector<saved_page> pages;
+  vpage_to_ppage_map.for_each(
+      [&pages](const auto& key, const auto& ppage) { pages.push_back({key.cpu, key.vaddr, ppage.template to<uint64_t>()}); });
+
+  std::vector<saved_pte_page> pte_pages;
+  page_table.for_each([this, &pte_pages](const auto& key, const auto& paddr) {
+    pte_pages.push_back({key.cpu, key.level, champsim::to_underlying(champsim::address::bits), champsim::to_underlying(shamt(key.level + 1)), key.vaddr,
+                         paddr.template to<uint64_t>()});
+  });
+
+  // The tables are unordered, so the translations are sorted to make the checkpoint the same for the same state
+  std::sort(std::begin(pages), std::end(pages), [](const auto& x, const auto& y) { return std::tie(x.cpu, x.vpage) < std::tie(y.cpu, y.vpage); });
+  std::sort(std::begin(pte_pages), std::end(pte_pages),
+            [](const auto& x, const auto& y) { return std::tie(x.cpu, x.level, x.vaddr) < std::tie(y.cpu, y.level, y.vaddr); });
+
+  // The translations are written field by field, so that the padding of a saved_page never reaches the checkpoint
+  out.write(std::size(pages));
+  for (const auto& page : pages) {
+    out.write(page.cpu);
+    out.write(page.vpage);
+    out.write(page.ppage);
+  }
+  out.write(pte_pages);
+  out.write(available_ppages());
+  out.write(active_pte_page.to<uint64_t>());
+  out.write(next_pte_page.to<uint64_t>());
+}
+
+void VirtualMemory::load_state(champsim::checkpoint_reader& in)
+{
+  std::vector<saved_page> pages;
+  std::vector<saved_pte_page> pte_pages;
+  std::size_t saved_available{};
+  uint64_t saved_active_pte_page{};
+  uint64_t saved_next_pte_page{};
+  std::size_t saved_pages{};
+  in.read(saved_pages);
+  for (std::size_t i = 0; i < saved_pages; ++i) {
+    auto& page = pages.emplace_back();
+    in.read(page.cpu);
+    in.read(page.vpage);
+    in.read(page.ppage);
+  }
+  in.read(pte_pages);
+  in.read(saved_available);
+  in.read(saved_active_pte_page);
+  in.read(saved_next_pte_page);
+
+  vpage_to_ppage_map.clear();
+  for (const auto& page : pages) {
+    vpage_to_ppage_map.try_emplace({page.cpu, 0, page.vpage}, champsim::page_number{page.ppage});
+  }
+
+  // The extent of each entry's virtual address is determined by its level
+  page_table.clear();
+  for (const auto& pte_page : pte_pages) {
+    page_table.try_emplace({pte_page.cpu, pte_page.level, pte_page.vaddr}, champsim::address{pte_page.paddr});
+  }
+
+  // The pages are handed out in the same order every time, so the allocated pages are those at the front of the order
+  populate_pages();
+  if (saved_available > available_ppages()) {
+    throw std::runtime_error{fmt::format("The checkpoint has {} unallocated physical pages, but the physical memory has only {}", saved_available,
+                                         available_ppages())};
+  }
+  ppages_allocated = ppage_order.size() - saved_available;
+
+  active_pte_page = champsim::page_number{saved_active_pte_page};
+  next_pte_page = champsim::address_slice{champsim::dynamic_extent{next_pte_page.upper_extent(), next_pte_page.lower_extent()}, saved_next_pte_page};
+}
@@ -0,0 +1,279 @@
+#include <catch.hpp>
+#include "channel.h"
+#include "scheduler.h"
+
+#include <algorithm>
+#include <deque>
+#include <type_traits>
+#include <vector>
+
+namespace {
+struct mock_operable : champsim::operable {
+  using operable::operable;
+  int count = 0;
+  bool idle = false;
+  int id = 0;
+  std::vector<int>* log = nullptr;
+  champsim::chrono::clock::time_point idle_until{};
+  long idle_cycles = 0;
+  int idle_calls = 0;
+  mock_operable* wakes = nullptr;
+  int wake_at = 0;
+  champsim::chrono::clock::time_point wake_to{};
+  long operate() {
+    ++count;
+    if (log != nullptr)
+      log->push_back(id);
+    if (wakes != nullptr && count >= wake_at) {
+      wakes->wake();
+      wakes->idle_until = wake_to;
+    }
+    return 1;
+  }
+  bool is_idle() const { return idle || current_time < idle_until; }
+  void operate_idle(long cycles) {
+    idle_cycles += cycles;
+    ++idle_calls;
+  }
+  champsim::chrono::clock::time_point next_wakeup() const { return std::max(current_time, idle_until); }
+};
+}
+
+TEST_CASE("The scheduler operates each operable once per cycle") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  constexpr int num_cycles = 100;
+  mock_operable first{period};
+  mock_operable second{period};
+  champsim::scheduler uut{{first, second}};
+
+  for (int i = 0; i < num_cycles; ++i) {
+    global_clock.tick(period);
+    uut.operate_on(global_clock);
+  }
+
+  REQUIRE(first.count == num_cycles);
+  REQUIRE(second.count == num_cycles);
+}
+
+TEST_CASE("The scheduler operates the operable that is furthest behind first") {
+  champsim::chrono::clock global_clock{};
+  std::vector<int> log{};
+  mock_operable fast{champsim::chrono::picoseconds{100}};
+  mock_operable slow{champsim::chrono::picoseconds{150}};
+  mock_operable tied{champsim::chrono::picoseconds{150}};
+  fast.id = 0;
+  slow.id = 1;
+  tied.id = 2;
+  fast.log = slow.log = tied.log = &log;
+  fast.current_time += champsim::chrono::picoseconds{50};
+  champsim::scheduler uut{{fast, slow, tied}};
+
+  global_clock.tick(champsim::chrono::picoseconds{100});
+  uut.operate_on(global_clock);
+
+  REQUIRE(log == std::vector<int>{1, 2, 0});
+}
+
+TEST_CASE("The scheduler reports the earliest wakeup") {
+  mock_operable fast{champsim::chrono::picoseconds{100}};
+  mock_operable slow{champsim::chrono::picoseconds{150}};
+  fast.current_time += champsim::chrono::picoseconds{300};
+  slow.current_time += champsim::chrono::picoseconds{200};
+  champsim::scheduler uut{{fast, slow}};
+
+  REQUIRE(uut.next_wakeup() == slow.current_time);
+}
+
+TEST_CASE("An idle operable advances its time without operating") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  constexpr int num_cycles = 100;
+  mock_operable uut{period};
+  uut.idle = true;
+  champsim::scheduler sched{{uut}};
+
+  long progress{0};
+  for (int i = 0; i < num_cycles; ++i) {
+    global_clock.tick(period);
+    progress += sched.operate_on(global_clock);
+  }
+
+  REQUIRE(uut.count == 0);
+  REQUIRE(progress == 0);
+  REQUIRE(uut.current_time == global_clock.now());
+}
+
+TEST_CASE("An operable sleeps until its next wakeup") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  constexpr int num_cycles = 20;
+  mock_operable uut{period};
+  uut.idle_until = champsim::chrono::clock::time_point{} + 10 * period;
+  champsim::scheduler sched{{uut}};
+
+  for (int i = 0; i < num_cycles; ++i) {
+    global_clock.tick(period);
+    sched.operate_on(global_clock);
+  }
+
+  REQUIRE(uut.count == num_cycles - 9);
+  REQUIRE(uut.idle_cycles == 9);
+  REQUIRE(uut.idle_calls < 9);
+  REQUIRE(uut.current_time == global_clock.now());
+}
+
+TEST_CASE("The scheduler reports the wakeup of a sleeping operable") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  mock_operable uut{period};
+  uut.idle_until = champsim::chrono::clock::time_point{} + 10 * period;
+  champsim::scheduler sched{{uut}};
+
+  global_clock.tick(period);
+  sched.operate_on(global_clock);
+
+  REQUIRE(sched.next_wakeup() == uut.idle_until - period);
+
+  sched.reset();
+
+  REQUIRE(uut.current_time == global_clock.now());
+}
+
+TEST_CASE("A sleeping operable that is woken catches up to the serial order") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  constexpr int num_cycles = 10;
+  constexpr int wake_at = 5;
+  auto forever = champsim::chrono::clock::time_point{} + 1000 * num_cycles * period;
+
+  // The sleeper has already passed the waker's cycle if it comes first, and has not yet if it comes second
+  auto sleeper_first = GENERATE(true, false);
+
+  mock_operable sleeper{period};
+  mock_operable waker{period};
+  sleeper.idle_until = forever;
+  waker.wakes = &sleeper;
+  waker.wake_at = wake_at;
+  std::vector<std::reference_wrapper<champsim::operable>> ops{sleeper, waker};
+  if (!sleeper_first) {
+    std::reverse(std::begin(ops), std::end(ops));
+  }
+  champsim::scheduler sched{ops};
+
+  for (int i = 0; i < num_cycles; ++i) {
+    global_clock.tick(period);
+    sched.operate_on(global_clock);
+  }
+
+  REQUIRE(waker.count == num_cycles);
+  REQUIRE(sleeper.count == num_cycles - wake_at + (sleeper_first ? 0 : 1));
+  REQUIRE(sleeper.idle_cycles + sleeper.count == num_cycles);
+  REQUIRE(sleeper.current_time == global_clock.now());
+}
+
+TEST_CASE("An operable that is woken every cycle may go back to sleep") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  constexpr int num_cycles = 100;
+  auto forever = champsim::chrono::clock::time_point{} + 1000 * num_cycles * period;
+
+  mock_operable sleeper{period};
+  mock_operable waker{period};
+  sleeper.idle_until = forever;
+  waker.wakes = &sleeper;
+  waker.wake_at = 1;
+  waker.wake_to = forever;
+  champsim::scheduler sched{{sleeper, waker}};
+
+  for (int i = 0; i < num_cycles; ++i) {
+    global_clock.tick(period);
+    sched.operate_on(global_clock);
+  }
+  sched.reset();
+
+  REQUIRE(waker.count == num_cycles);
+  REQUIRE(sleeper.count == 0);
+  REQUIRE(sleeper.idle_cycles == num_cycles);
+  REQUIRE(sleeper.current_time == global_clock.now());
+}
+
+TEST_CASE("A response returned through a channel wakes its sleeping consumer") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  constexpr int num_cycles = 10;
+  constexpr int return_at = 5;
+  auto forever = champsim::chrono::clock::time_point{} + 1000 * num_cycles * period;
+  auto use_emplace = GENERATE(true, false);
+
+  mock_operable consumer{period};
+  consumer.idle_until = forever;
+  champsim::channel::response_queue returned{};
+  returned.consumer = &consumer;
+  champsim::scheduler sched{{consumer}};
+
+  for (int i = 0; i < num_cycles; ++i) {
+    global_clock.tick(period);
+    if (i == return_at) {
+      consumer.idle_until = {};
+      if (use_emplace) {
+        returned.emplace_back(champsim::channel::request_type{});
+      } else {
+        returned.push_back(champsim::channel::response_type{champsim::channel::request_type{}});
+      }
+    }
+    sched.operate_on(global_clock);
+  }
+
+  REQUIRE(std::size(returned) == 1);
+  REQUIRE(consumer.count == num_cycles - return_at);
+  REQUIRE(consumer.current_time == global_clock.now());
+}
+
+TEST_CASE("A channel's responses cannot be added to without waking the consumer") {
+  STATIC_REQUIRE_FALSE(std::is_convertible_v<champsim::channel::response_queue&, std::deque<champsim::channel::response_type>&>);
+}
+
+TEST_CASE("A parallel scheduler with a quantum of 1 operates each operable once per cycle") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  constexpr int num_cycles = 100;
+  mock_operable shared{period};
+  std::vector<mock_operable> privates(4, mock_operable{period});
+  champsim::scheduler uut{{privates[0], privates[1], shared, privates[2], privates[3]}, {0, 1, champsim::scheduler::shared_domain, 0, 1}};
+  uut.parallelize(1);
+
+  REQUIRE(uut.ticks_per_call() == 1);
+
+  for (int i = 0; i < num_cycles; ++i) {
+    global_clock.tick(period);
+    uut.operate_on(global_clock);
+  }
+
+  for (const auto& op : privates) {
+    REQUIRE(op.count == num_cycles);
+    REQUIRE(op.current_time == global_clock.now());
+  }
+  REQUIRE(shared.count == num_cycles);
+}
+
+TEST_CASE("A parallel scheduler with a larger quantum operates a whole window per call") {
+  champsim::chrono::clock global_clock{};
+  champsim::chrono::clock::duration period{100};
+  constexpr long quantum = 8;
+  mock_operable shared{period};
+  mock_operable first{period};
+  mock_operable second{period};
+  champsim::scheduler uut{{first, shared, second}, {0, champsim::scheduler::shared_domain, 1}};
+  uut.parallelize(quantum);
+
+  REQUIRE(uut.ticks_per_call() == quantum);
+
+  global_clock.tick(period * uut.ticks_per_call());
+  uut.operate_on(global_clock);
+
+  REQUIRE(first.count == quantum);
+  REQUIRE(second.count == quantum);
+  REQUIRE(shared.count == quantum);
+  REQUIRE(uut.next_wakeup() == global_clock.now());
+}
@@ -0,0 +1,240 @@
+#include <catch.hpp>
+#include "defaults.hpp"
+
+#include <deque>
+#include <memory>
+
+#include "capability_memory.h"
+#include "environment.h"
+#include "phase_info.h"
+#include "stats_printer.h"
+#include "tracereader.h"
+#include "vmem.h"
+
+namespace champsim
+{
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces);
+}
+
+namespace
+{
+constexpr std::size_t num_cpus = 2;
+
+/**
+ * Two cores, each with private L1s, TLBs, an L2, and a page table walker, sharing an LLC and DRAM.
+ * The operables are viewed and assigned to domains in the same way as a generated environment.
+ */
+struct multicore_environment final : champsim::environment {
+  champsim::chrono::picoseconds period{250};
+  std::deque<champsim::channel> channels;
+  MEMORY_CONTROLLER dram;
+  VirtualMemory vmem;
+  std::deque<PageTableWalker> ptws;
+  std::deque<CACHE> caches;
+  std::vector<std::size_t> cache_domains;
+  std::deque<O3_CPU> cores;
+  std::unique_ptr<champsim::scheduler> schedule;
+
+  multicore_environment()
+      : channels(1, champsim::channel{64, 64, 64, champsim::data::bits{LOG2_BLOCK_SIZE}, false}),
+        dram{champsim::chrono::picoseconds{312}, champsim::chrono::picoseconds{625}, std::size_t{24}, std::size_t{24}, std::size_t{24}, std::size_t{52}, champsim::chrono::microseconds{32000}, {&channels.front()}, 64, 64, 1, champsim::data::bytes{8}, 65536, 1024, 1, 8, 4, 8192},
+        vmem{champsim::data::bytes{1 << 12}, 5, period * 200, dram}
+  {
+    // The queue sizes and offsets follow those of a generated environment
+    auto add_channel = [this](std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset, bool match_offset) -> champsim::channel* {
+      return &channels.emplace_back(std::size_t{32}, pq_size, wq_size, offset, match_offset);
+    };
+    const champsim::data::bits block_offset{LOG2_BLOCK_SIZE};
+    const champsim::data::bits page_offset{LOG2_PAGE_SIZE};
+
+    std::vector<champsim::channel*> l2c_llc{};
+    for (std::size_t cpu = 0; cpu < num_cpus; ++cpu) {
+      l2c_llc.push_back(add_channel(32, 32, block_offset, false));
+    }
+    caches.emplace_back(champsim::cache_builder{champsim::defaults::default_llc}
+        .upper_levels(std::vector{l2c_llc})
+        .lower_level(&channels.front())
+        .clock_period(period));
+    cache_domains.push_back(champsim::scheduler::shared_domain);
+
+    for (std::size_t cpu = 0; cpu < num_cpus; ++cpu) {
+      auto* fetch = add_channel(32, 32, block_offset, true);
+      auto* data = add_channel(32, 32, block_offset, true);
+      auto* walks = add_channel(32, 32, block_offset, false);
+      auto* l1i_l2c = add_channel(32, 32, block_offset, false);
+      auto* l1d_l2c = add_channel(32, 32, block_offset, false);
+      auto* l1i_itlb = add_channel(0, 16, page_offset, true);
+      auto* l1d_dtlb = add_channel(0, 16, page_offset, true);
+      auto* itlb_ptw = add_channel(0, 0, page_offset, false);
+      auto* dtlb_ptw = add_channel(0, 0, page_offset, false);
+
+      auto& l1i = caches.emplace_back(champsim::cache_builder{champsim::defaults::default_l1i}
+          .name("cpu" + std::to_string(cpu) + "_L1I")
+          .upper_levels({fetch})
+          .lower_level(l1i_l2c)
+          .lower_translate(l1i_itlb)
+          .clock_period(period));
+      auto& l1d = caches.emplace_back(champsim::cache_builder{champsim::defaults::default_l1d}
+          .name("cpu" + std::to_string(cpu) + "_L1D")
+          .upper_levels({{walks, data}})
+          .lower_level(l1d_l2c)
+          .lower_translate(l1d_dtlb)
+          .clock_period(period));
+      caches.emplace_back(champsim::cache_builder{champsim::defaults::default_l2c}
+          .name("cpu" + std::to_string(cpu) + "_L2C")
+          .upper_levels({{l1i_l2c, l1d_l2c}})
+          .lower_level(l2c_llc.at(cpu))
+          .clock_period(period));
+      caches.emplace_back(champsim::cache_builder{champsim::defaults::default_itlb}
+          .name("cpu" + std::to_string(cpu) + "_ITLB")
+          .upper_levels({l1i_itlb})
+          .lower_level(itlb_ptw)
+          .clock_period(period));
+      caches.emplace_back(champsim::cache_builder{champsim::defaults::default_dtlb}
+          .name("cpu" + std::to_string(cpu) + "_DTLB")
+          .upper_levels({l1d_dtlb})
+          .lower_level(dtlb_ptw)
+          .clock_period(period));
+      cache_domains.insert(std::end(cache_domains), 5, cpu);
+
+      ptws.emplace_back(champsim::ptw_builder{champsim::defaults::default_ptw}
+          .name("cpu" + std::to_string(cpu) + "_PTW")
+          .cpu(static_cast<uint32_t>(cpu))
+          .upper_levels({{itlb_ptw, dtlb_ptw}})
+          .lower_level(walks)
+          .virtual_memory(&vmem)
+          .clock_period(period));
+
+      cores.emplace_back(champsim::core_builder{champsim::defaults::default_core}
+          .index(static_cast<uint32_t>(cpu))
+          .fetch_queues(fetch)
+          .data_queues(data)
+          .l1i(&l1i)
+          .l1i_bandwidth(l1i.MAX_TAG)
+          .l1d_bandwidth(l1d.MAX_TAG)
+          .clock_period(period));
+    }
+
+    // The page table walkers share the virtual memory, so they are in the shared domain
+    std::vector<std::size_t> domains{};
+    for (std::size_t cpu = 0; cpu < num_cpus; ++cpu) {
+      domains.push_back(cpu);
+    }
+    domains.insert(std::end(domains), std::begin(cache_domains), std::end(cache_domains));
+    domains.insert(std::end(domains), std::size(ptws) + 1, champsim::scheduler::shared_domain);
+    schedule = std::make_unique<champsim::scheduler>(operable_view(), domains);
+  }
+
+  std::vector<std::reference_wrapper<O3_CPU>> cpu_view() final { return {std::begin(cores), std::end(cores)}; }
+  std::vector<std::reference_wrapper<CACHE>> cache_view() final { return {std::begin(caches), std::end(caches)}; }
+  std::vector<std::reference_wrapper<PageTableWalker>> ptw_view() final { return {std::begin(ptws), std::end(ptws)}; }
+  MEMORY_CONTROLLER& dram_view() final { return dram; }
+  champsim::scheduler& scheduler_view() final { return *schedule; }
+
+  std::vector<std::reference_wrapper<champsim::operable>> operable_view() final
+  {
+    std::vector<std::reference_wrapper<champsim::operable>> retval{};
+    retval.insert(std::end(retval), std::begin(cores), std::end(cores));
+    retval.insert(std::end(retval), std::begin(caches), std::end(caches));
+    retval.insert(std::end(retval), std::begin(ptws), std::end(ptws));
+    retval.push_back(dram);
+    return retval;
+  }
+};
+
+/**
+ * A repeating mix of dependent loads, streaming stores, branches, and arithmetic, over a footprint larger than the L2s.
+ */
+struct synthetic_trace {
+  uint8_t cpu;
+  uint64_t count = 0;
+
+  ooo_model_instr operator()()
+  {
+    constexpr uint64_t region_size = 1 << 20;
+    const uint64_t region_base = 0x1000'0000 * (cpu + uint64_t{1});
+
+    cheri_instr instr{};
+    instr.ip = 0x40'0000 + 4 * (count % 512);
+    switch (count % 6) {
+    case 0:
+      instr.source_memory[0] = region_base + (count * 64 * 7) % region_size;
+      instr.destination_registers[0] = 3;
+      instr.source_registers[0] = 3;
+      break;
+    case 1:
+      instr.source_memory[0] = region_base + (count * 4096 + 24) % region_size;
+      instr.destination_registers[0] = 4;
+      break;
+    case 2:
+      instr.destination_memory[0] = region_base + (count * 8) % region_size;
+      instr.source_registers[0] = 4;
+      break;
+    case 5:
+      instr.is_branch = true;
+      instr.branch_taken = (count % 4) != 1;
+      instr.destination_registers[0] = champsim::REG_INSTRUCTION_POINTER;
+      instr.source_registers[0] = champsim::REG_INSTRUCTION_POINTER;
+      instr.source_registers[1] = champsim::REG_FLAGS;
+      break;
+    default:
+      instr.destination_registers[0] = champsim::REG_FLAGS;
+      instr.source_registers[0] = 3;
+      break;
+    }
+
+    if (instr.source_memory[0] != 0 || instr.destination_memory[0] != 0) {
+      instr.auth_base = region_base;
+      instr.auth_length = region_size;
+      instr.auth_offset = std::max(instr.source_memory[0], instr.destination_memory[0]) - region_base;
+      instr.auth_perms = ~0u;
+      instr.auth_tag = 1;
+      instr.cap_op = static_cast<unsigned char>(champsim::cap_op_type::AUTH);
+    }
+
+    ++count;
+    return ooo_model_instr{cpu, instr};
+  }
+};
+
+std::vector<std::string> simulate(long parallel_quantum)
+{
+  champsim::initialize_capability_memory(num_cpus);
+  multicore_environment env;
+  env.scheduler_view().parallelize(parallel_quantum);
+
+  std::vector<champsim::tracereader> traces{};
+  for (uint8_t cpu = 0; cpu < num_cpus; ++cpu) {
+    traces.emplace_back(synthetic_trace{cpu});
+  }
+
+  std::vector<champsim::phase_info> phases{{"Warmup", true, 2000, {0, 1}, {"synthetic0", "synthetic1"}},
+                                           {"Simulation", false, 5000, {0, 1}, {"synthetic0", "synthetic1"}}};
+  auto results = champsim::main(env, phases, traces);
+
+  // Everything that the simulator reports about the phase, and the time each operable finished at
+  std::vector<std::string> report{};
+  auto append = [&report](const std::vector<std::string>& lines) { report.insert(std::end(report), std::begin(lines), std::end(lines)); };
+  for (const auto& stats : results.back().sim_cpu_stats) {
+    append(champsim::plain_printer::format(stats));
+  }
+  for (const auto& stats : results.back().sim_cache_stats) {
+    append(champsim::plain_printer::format(stats));
+  }
+  for (const auto& stats : results.back().sim_dram_stats) {
+    append(champsim::plain_printer::format(stats));
+  }
+  for (const champsim::operable& op : env.operable_view()) {
+    report.push_back(std::to_string(op.current_time.time_since_epoch().count()));
+  }
+  return report;
+}
+} // namespace
+
+TEST_CASE("A multicore simulation gives identical results serially and with a parallel quantum of 1") {
+  auto serial = simulate(0);
+  auto parallel = simulate(1);
+
+  REQUIRE_FALSE(std::empty(serial));
+  REQUIRE(serial == parallel);
+}
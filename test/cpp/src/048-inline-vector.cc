@@ -0,0 +1,40 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "util/inline_vector.h"
+
+TEST_CASE("An inline_vector is trivially copyable if its elements are") {
+  STATIC_REQUIRE(std::is_trivially_copyable_v<champsim::inline_vector<int, 4>>);
+}
+
+TEST_CASE("An inline_vector holds elements up to its capacity") {
+  champsim::inline_vector<int, 4> uut{};
+  REQUIRE(uut.empty());
+  REQUIRE(uut.capacity() == 4);
+
+  uut.push_back(1);
+  uut.push_back(2);
+  uut.emplace_back(3);
+  REQUIRE(std::size(uut) == 3);
+  REQUIRE(uut.front() == 1);
+  REQUIRE(uut.back() == 3);
+  REQUIRE(uut == champsim::inline_vector<int, 4>{1, 2, 3});
+
+  uut.push_back(4);
+  REQUIRE_THROWS_AS(uut.push_back(5), std::length_error);
+  REQUIRE_THROWS_AS(uut.at(4), std::out_of_range);
+}
+
+TEST_CASE("An inline_vector can erase a range of its elements") {
+  champsim::inline_vector<int, 4> uut{1, 2, 1, 3};
+  uut.erase(std::remove(std::begin(uut), std::end(uut), 1), std::end(uut));
+  REQUIRE(uut == champsim::inline_vector<int, 4>{2, 3});
+
+  uut.erase(std::begin(uut));
+  REQUIRE(uut == champsim::inline_vector<int, 4>{3});
+
+  uut.clear();
+  REQUIRE(uut.empty());
+}
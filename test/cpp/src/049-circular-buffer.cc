@@ -0,0 +1,77 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "util/circular_buffer.h"
+
+TEST_CASE("A circular_buffer rounds its capacity up to a power of two") {
+  champsim::circular_buffer<int> uut{5};
+  REQUIRE(uut.empty());
+  REQUIRE(uut.capacity() == 8);
+}
+
+TEST_CASE("A circular_buffer is first-in, first-out") {
+  champsim::circular_buffer<int> uut{4};
+  for (int i = 0; i < 4; ++i) {
+    uut.push_back(i);
+  }
+  REQUIRE(uut.full());
+  REQUIRE(uut.front() == 0);
+  REQUIRE(uut.back() == 3);
+
+  uut.pop_front();
+  uut.push_back(4);
+  REQUIRE(std::size(uut) == 4);
+  REQUIRE(std::equal(std::begin(uut), std::end(uut), std::begin({1, 2, 3, 4})));
+  REQUIRE(uut[0] == 1);
+  REQUIRE_THROWS_AS(uut.at(4), std::out_of_range);
+}
+
+TEST_CASE("Elements of a circular_buffer do not move while it is within its capacity") {
+  champsim::circular_buffer<std::string> uut{4};
+  uut.push_back("a");
+  uut.push_back("b");
+  auto* second = &uut[1];
+
+  for (int i = 0; i < 10; ++i) {
+    uut.pop_front();
+    uut.push_back(std::to_string(i));
+    if (i == 0) {
+      REQUIRE(&uut.front() == second);
+    }
+  }
+  REQUIRE(uut.capacity() == 4);
+  REQUIRE(uut.front() == "8");
+  REQUIRE(uut.back() == "9");
+}
+
+TEST_CASE("A circular_buffer refuses to append past its capacity") {
+  champsim::circular_buffer<int> uut{2};
+  uut.push_back(0);
+  uut.pop_front();
+  uut.push_back(1);
+  uut.push_back(2);
+  REQUIRE_THROWS_AS(uut.push_back(3), std::length_error);
+  REQUIRE(uut.capacity() == 2);
+  REQUIRE(std::equal(std::begin(uut), std::end(uut), std::begin({1, 2})));
+}
+
+TEST_CASE("A circular_buffer can erase from its front or its middle") {
+  champsim::circular_buffer<int> uut{8};
+  std::vector<int> values{1, 2, 3, 4, 5, 6};
+  uut.insert(std::cend(uut), std::begin(values), std::end(values));
+
+  uut.erase(std::cbegin(uut), std::next(std::cbegin(uut), 2));
+  REQUIRE(std::equal(std::begin(uut), std::end(uut), std::begin({3, 4, 5, 6})));
+
+  uut.erase(std::next(std::cbegin(uut)), std::next(std::cbegin(uut), 3));
+  REQUIRE(std::equal(std::begin(uut), std::end(uut), std::begin({3, 6})));
+
+  uut.clear();
+  REQUIRE(uut.empty());
+}
@@ -0,0 +1,236 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fmt/core.h>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "capability_memory.h"
+
+namespace
+{
+champsim::capability make_cap(uint64_t offset, uint64_t base, uint64_t length, uint32_t perms = 0x3f)
+{
+  return champsim::capability{champsim::address{offset}, champsim::address{base}, champsim::address{length}, perms, true};
+}
+
+bool same_cap(const champsim::capability& lhs, const champsim::capability& rhs)
+{
+  return lhs.offset == rhs.offset && lhs.base == rhs.base && lhs.length == rhs.length && lhs.permissions == rhs.permissions && lhs.tag == rhs.tag;
+}
+} // namespace
+
+SCENARIO("Capability memory keeps its contents across finalization") {
+  GIVEN("A capability memory with presimpoint contents") {
+    champsim::capability_memory uut;
+    uut.store_capability(champsim::address{0x1000}, make_cap(0x10, 0x8000, 0x100));
+    uut.store_capability(champsim::address{0x1010}, make_cap(0x20, 0x8000, 0x100));
+    uut.store_capability(champsim::address{0x2000}, make_cap(0x30, 0x9000, 0x40, 0x7));
+    uut.store_capability(champsim::address{0x3000}, make_cap(0x40, 0xa000, 0x40));
+    uut.invalidate_tag(champsim::address{0x3000});
+
+    WHEN("It is finalized") {
+      uut.finalize();
+
+      THEN("Every tagged granule can be loaded") {
+        REQUIRE(uut.is_finalized());
+        REQUIRE(uut.size() == 3);
+        REQUIRE(uut.unique_capabilities() == 2);
+        auto loaded = uut.load_capability(champsim::address{0x1018});
+        REQUIRE(loaded.has_value());
+        REQUIRE(same_cap(*loaded, make_cap(0x20, 0x8000, 0x100)));
+        REQUIRE(uut.has_capability(champsim::address{0x2000}));
+        REQUIRE_FALSE(uut.has_capability(champsim::address{0x3000}));
+        REQUIRE_FALSE(uut.load_capability(champsim::address{0x4000}).has_value());
+      }
+
+      AND_WHEN("Granules are overwritten, invalidated, and added") {
+        uut.store_capability(champsim::address{0x1000}, make_cap(0x50, 0xb000, 0x80));
+        uut.invalidate_tag(champsim::address{0x1010});
+        uut.store_capability(champsim::address{0x2000}, champsim::capability{});
+        uut.store_capability(champsim::address{0x5000}, make_cap(0x60, 0x9000, 0x40, 0x7));
+
+        THEN("Loads observe the simpoint region writes") {
+          REQUIRE(uut.size() == 2);
+          auto loaded = uut.load_capability(champsim::address{0x1000});
+          REQUIRE(loaded.has_value());
+          REQUIRE(same_cap(*loaded, make_cap(0x50, 0xb000, 0x80)));
+          REQUIRE_FALSE(uut.has_capability(champsim::address{0x1010}));
+          REQUIRE_FALSE(uut.has_capability(champsim::address{0x2000}));
+          REQUIRE(uut.has_capability(champsim::address{0x5000}));
+        }
+
+        THEN("A store reuses the descriptor of an existing capability") {
+          REQUIRE(uut.unique_capabilities() == 3);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Capability memory answers whole-line queries") {
+  auto finalized = GENERATE(false, true);
+
+  GIVEN("A line with tagged capabilities in its first and third granules") {
+    champsim::capability_memory uut;
+    uut.store_capability(champsim::address{0x1040}, make_cap(0x10, 0x8000, 0x100));
+    uut.store_capability(champsim::address{0x1060}, make_cap(0x20, 0x9000, 0x40));
+    uut.store_capability(champsim::address{0x1080}, make_cap(0x30, 0xa000, 0x40));
+    if (finalized) {
+      uut.finalize();
+    }
+
+    THEN("The line reports both granules") {
+      auto line = uut.load_line(champsim::address{0x1070});
+      REQUIRE(line.tag_mask == 0b0101);
+      REQUIRE(line.count() == 2);
+      REQUIRE(uut.line_tag_mask(champsim::address{0x1040}) == 0b0101);
+      REQUIRE(same_cap(line.caps[2], make_cap(0x20, 0x9000, 0x40)));
+      REQUIRE(line.at(champsim::address{0x1060}).has_value());
+      REQUIRE_FALSE(line.at(champsim::address{0x1050}).has_value());
+    }
+
+    WHEN("Both granules are invalidated") {
+      uut.invalidate_tag(champsim::address{0x1040});
+      uut.invalidate_tag(champsim::address{0x1060});
+
+      THEN("The line is empty, but its neighbour is not") {
+        REQUIRE(uut.line_tag_mask(champsim::address{0x1040}) == 0);
+        REQUIRE(uut.load_line(champsim::address{0x1040}).count() == 0);
+        REQUIRE(uut.line_tag_mask(champsim::address{0x1080}) == 0b0001);
+        REQUIRE(uut.size() == 1);
+      }
+    }
+  }
+}
+
+TEST_CASE("Capability memory agrees with a reference map under random traffic") {
+  champsim::capability_memory uut;
+  std::unordered_map<uint64_t, champsim::capability> reference;
+  std::mt19937_64 rng{42};
+  std::uniform_int_distribution<uint64_t> granule{0, 4095};
+  std::uniform_int_distribution<int> action{0, 3};
+
+  auto step = [&] {
+    auto addr = granule(rng) << 4;
+    if (action(rng) == 0) {
+      uut.invalidate_tag(champsim::address{addr});
+      reference.erase(addr);
+    } else {
+      auto cap = make_cap(addr & 0xff, addr & ~0xfffULL, 0x1000, static_cast<uint32_t>(addr >> 12) & 0x3);
+      uut.store_capability(champsim::address{addr}, cap);
+      reference.insert_or_assign(addr, cap);
+    }
+  };
+
+  for (int i = 0; i < 4000; ++i) {
+    step();
+  }
+  uut.finalize();
+  for (int i = 0; i < 20000; ++i) {
+    step();
+  }
+
+  REQUIRE(uut.size() == std::size(reference));
+  for (uint64_t addr = 0; addr < (4096 << 4); addr += 16) {
+    auto loaded = uut.load_capability(champsim::address{addr});
+    auto expected = reference.find(addr);
+    REQUIRE(loaded.has_value() == (expected != std::end(reference)));
+    if (loaded.has_value()) {
+      REQUIRE(same_cap(*loaded, expected->second));
+    }
+    REQUIRE(uut.load_line(champsim::address{addr}).at(champsim::address{addr}).has_value() == loaded.has_value());
+  }
+}
+
+TEST_CASE("Finalized capability lookups are faster than the layered search", "[.][benchmark]") {
+  constexpr std::size_t num_caps = 1'000'000;
+  constexpr std::size_t num_lookups = 20'000'000;
+
+  // A pointer-dense heap: objects of 64 bytes, each holding capabilities to its neighbours
+  champsim::capability_memory uut;
+  std::vector<uint64_t> presimpoint_keys;
+  for (std::size_t i = 0; i < num_caps; ++i) {
+    uint64_t addr = 0x4000'0000 + (i / 2) * 64 + (i % 2) * 16;
+    uut.store_capability(champsim::address{addr}, make_cap(0, 0x4000'0000 + (i / 2 + 1) * 64, 64));
+    presimpoint_keys.push_back(addr >> 4);
+  }
+  uut.finalize();
+
+  // The layered design that this replaces: region writes, invalidations, then a sorted search
+  std::unordered_map<uint64_t, champsim::capability> region_map;
+  std::unordered_set<uint64_t> invalidated;
+  std::sort(std::begin(presimpoint_keys), std::end(presimpoint_keys));
+  for (std::size_t i = 0; i < 1000; ++i) {
+    uint64_t addr = 0x4000'0000 + i * 6400;
+    uut.invalidate_tag(champsim::address{addr});
+    invalidated.insert(addr >> 4);
+  }
+
+  std::mt19937_64 rng{7};
+  std::uniform_int_distribution<uint64_t> dist{0x4000'0000, 0x4000'0000 + num_caps * 32};
+  std::vector<uint64_t> probes(4096);
+  std::generate(std::begin(probes), std::end(probes), [&] { return dist(rng) & ~0xfULL; });
+
+  auto time = [&](auto&& lookup) {
+    std::size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < num_lookups; ++i) {
+      hits += lookup(probes[i % std::size(probes)] + (i << 4) % 0x10000);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return std::pair{hits, static_cast<double>(num_lookups) / elapsed.count()};
+  };
+
+  auto [flat_hits, flat_rate] = time([&](uint64_t addr) { return uut.has_capability(champsim::address{addr}); });
+  auto [layered_hits, layered_rate] = time([&](uint64_t addr) {
+    auto key = addr >> 4;
+    if (auto it = region_map.find(key); it != std::end(region_map)) {
+      return it->second.tag;
+    }
+    if (!invalidated.empty() && invalidated.count(key) > 0) {
+      return false;
+    }
+    return std::binary_search(std::begin(presimpoint_keys), std::end(presimpoint_keys), key);
+  });
+
+  fmt::print("flat table: {:.3e} lookups/second, layered search: {:.3e} lookups/second\n", flat_rate, layered_rate);
+  REQUIRE(flat_hits == layered_hits);
+}
+
+TEST_CASE("Counting a line's capabilities takes one lookup", "[.][benchmark]") {
+  constexpr std::size_t num_lines = 500'000;
+  constexpr std::size_t num_lookups = 10'000'000;
+
+  champsim::capability_memory uut;
+  for (std::size_t i = 0; i < 2 * num_lines; ++i) {
+    uint64_t addr = 0x4000'0000 + (i / 2) * 64 + (i % 2) * 16;
+    uut.store_capability(champsim::address{addr}, make_cap(0, 0x4000'0000 + (i / 2 + 1) * 64, 64));
+  }
+  uut.finalize();
+
+  auto time = [&](auto&& count_line) {
+    std::size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < num_lookups; ++i) {
+      total += count_line(0x4000'0000 + ((i * 7919) % (2 * num_lines)) * 64);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return std::pair{total, static_cast<double>(num_lookups) / elapsed.count()};
+  };
+
+  auto [line_total, line_rate] = time([&](uint64_t addr) { return uut.load_line(champsim::address{addr}).count(); });
+  auto [granule_total, granule_rate] = time([&](uint64_t addr) {
+    unsigned count = 0;
+    for (uint64_t i = 0; i < champsim::capability_memory::GRANULES_PER_LINE; ++i) {
+      count += uut.load_capability(champsim::address{addr + i * 16}).has_value() ? 1 : 0;
+    }
+    return count;
+  });
+
+  fmt::print("line query: {:.3e} lines/second, per-granule queries: {:.3e} lines/second\n", line_rate, granule_rate);
+  REQUIRE(line_total == granule_total);
+}
@@ -0,0 +1,133 @@
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "capability_memory.h"
+
+namespace
+{
+const champsim::trace_identity source{4096, 0x1234};
+
+struct temporary_snapshot {
+  std::filesystem::path path{std::filesystem::temp_directory_path() / "champsim-051-capability-snapshot.bin"};
+  ~temporary_snapshot() { std::filesystem::remove(path); }
+};
+
+champsim::capability make_cap(uint64_t offset, uint64_t base, uint64_t length)
+{
+  return champsim::capability{champsim::address{offset}, champsim::address{base}, champsim::address{length}, 0x3f, true};
+}
+
+void fill(champsim::capability_memory& uut)
+{
+  for (uint64_t i = 0; i < 1000; ++i) {
+    uut.store_capability(champsim::address{0x10000 + i * 48}, make_cap(i, 0x80000 + (i % 17) * 0x100, 0x100));
+  }
+}
+} // namespace
+
+SCENARIO("A finalized capability memory can be saved and loaded") {
+  temporary_snapshot file;
+
+  GIVEN("A snapshot of a finalized capability memory") {
+    champsim::capability_memory original;
+    fill(original);
+    original.set_snapshot_output(file.path.string(), source);
+    original.finalize();
+    REQUIRE(std::filesystem::exists(file.path));
+
+    WHEN("The snapshot is loaded") {
+      champsim::capability_memory uut;
+      uut.load_snapshot(file.path.string(), source);
+
+      THEN("The loaded memory has the same contents") {
+        REQUIRE(uut.is_finalized());
+        REQUIRE(uut.size() == original.size());
+        for (uint64_t addr = 0x10000; addr < 0x10000 + 1000 * 48; addr += 16) {
+          auto expected = original.load_capability(champsim::address{addr});
+          auto loaded = uut.load_capability(champsim::address{addr});
+          REQUIRE(loaded.has_value() == expected.has_value());
+          if (loaded.has_value()) {
+            REQUIRE(loaded->offset == expected->offset);
+            REQUIRE(loaded->base == expected->base);
+            REQUIRE(loaded->length == expected->length);
+            REQUIRE(loaded->permissions == expected->permissions);
+          }
+        }
+      }
+
+      AND_WHEN("The loaded memory is modified") {
+        uut.invalidate_tag(champsim::address{0x10000});
+        for (uint64_t i = 0; i < 5000; ++i) {
+          uut.store_capability(champsim::address{0x900000 + i * 16}, make_cap(i, 0xa0000, 0x40));
+        }
+
+        THEN("The modifications are visible, but the snapshot is unchanged") {
+          REQUIRE_FALSE(uut.has_capability(champsim::address{0x10000}));
+          REQUIRE(uut.has_capability(champsim::address{0x900000 + 4999 * 16}));
+          REQUIRE(uut.size() == original.size() - 1 + 5000);
+          REQUIRE(uut.unique_capabilities() == original.unique_capabilities() + 1);
+
+          champsim::capability_memory reloaded;
+          reloaded.load_snapshot(file.path.string(), source);
+          REQUIRE(reloaded.has_capability(champsim::address{0x10000}));
+          REQUIRE(reloaded.size() == original.size());
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("A capability memory rejects a file that is not a snapshot") {
+  temporary_snapshot file;
+  {
+    std::ofstream out{file.path, std::ios::binary};
+    out << std::string(128, 'x');
+  }
+
+  champsim::capability_memory uut;
+  REQUIRE_THROWS_AS(uut.load_snapshot(file.path.string(), source), std::runtime_error);
+  REQUIRE_FALSE(uut.is_finalized());
+}
+
+TEST_CASE("A capability memory rejects a snapshot of another trace") {
+  temporary_snapshot file;
+  champsim::capability_memory original;
+  fill(original);
+  original.set_snapshot_output(file.path.string(), source);
+  original.finalize();
+
+  champsim::capability_memory uut;
+  REQUIRE_THROWS_AS(uut.load_snapshot(file.path.string(), champsim::trace_identity{source.size, source.hash + 1}), std::runtime_error);
+  REQUIRE_THROWS_AS(uut.load_snapshot(file.path.string(), champsim::trace_identity{source.size + 1, source.hash}), std::runtime_error);
+  REQUIRE_FALSE(uut.is_finalized());
+}
+
+TEST_CASE("A trace is identified by its contents") {
+  auto write = [](const std::filesystem::path& path, const std::string& contents) {
+    std::ofstream out{path, std::ios::binary};
+    out << contents;
+  };
+  temporary_snapshot first;
+  temporary_snapshot second{std::filesystem::temp_directory_path() / "champsim-051-trace.bin"};
+
+  const std::string contents(200000, 'x');
+  write(first.path, contents);
+  write(second.path, contents);
+  REQUIRE(champsim::trace_identity::of(first.path.string()) == champsim::trace_identity::of(second.path.string()));
+
+  auto changed = contents;
+  changed.back() = 'y';
+  write(second.path, changed);
+  REQUIRE(champsim::trace_identity::of(first.path.string()) != champsim::trace_identity::of(second.path.string()));
+}
+
+TEST_CASE("A capability memory must be finalized before it is saved") {
+  temporary_snapshot file;
+  champsim::capability_memory uut;
+  fill(uut);
+  REQUIRE_THROWS_AS(uut.save_snapshot(file.path.string(), source), std::logic_error);
+}
@@ -0,0 +1,33 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "util/find_equal.h"
+
+TEST_CASE("find_first_equal finds the first matching element at any position") {
+  auto count = GENERATE(as<std::size_t>{}, 1, 2, 3, 4, 5, 8, 11, 16, 20);
+  std::vector<uint64_t> values(count);
+  std::iota(std::begin(values), std::end(values), uint64_t{0x1234'5678'0000'0000});
+
+  for (std::size_t i = 0; i < count; ++i) {
+    REQUIRE(champsim::find_first_equal(std::data(values), count, values[i]) == i);
+  }
+  REQUIRE(champsim::find_first_equal(std::data(values), count, 0xdead) == count);
+}
+
+TEST_CASE("find_first_equal requires both halves of an element to match") {
+  std::vector<uint64_t> values{0x0000'0001'0000'0002, 0x0000'0002'0000'0001, 0x0000'0002'0000'0002, std::numeric_limits<uint64_t>::max()};
+  REQUIRE(champsim::find_first_equal(std::data(values), std::size(values), 0x0000'0001'0000'0001) == std::size(values));
+  REQUIRE(champsim::find_first_equal(std::data(values), std::size(values), 0x0000'0002'0000'0002) == 2);
+  REQUIRE(champsim::find_first_equal(std::data(values), std::size(values), std::numeric_limits<uint64_t>::max()) == 3);
+}
+
+TEST_CASE("find_first_equal returns the earliest of several matches") {
+  std::vector<uint64_t> values{7, 3, 9, 3, 3, 9};
+  REQUIRE(champsim::find_first_equal(std::data(values), std::size(values), 3) == 1);
+  REQUIRE(champsim::find_first_equal(std::data(values), std::size(values), 9) == 2);
+  REQUIRE(champsim::find_first_equal(std::data(values), 0, 7) == 0);
+}
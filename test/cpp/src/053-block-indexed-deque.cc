@@ -0,0 +1,91 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+
+#include "address.h"
+#include "util/block_indexed_deque.h"
+
+namespace
+{
+struct packet {
+  champsim::address address{};
+  int id = 0;
+};
+} // namespace
+
+SCENARIO("A block-indexed deque counts its packets by block") {
+  using namespace champsim::data::data_literals;
+
+  GIVEN("A deque with two packets in one block and one in another") {
+    champsim::block_indexed_deque<packet> uut{6_b};
+    uut.push_back(packet{champsim::address{0x1000}, 1});
+    uut.emplace_back(packet{champsim::address{0x1008}, 2});
+    uut.push_back(packet{champsim::address{0x2000}, 3});
+
+    THEN("The counts and lookups see each block") {
+      REQUIRE(std::size(uut) == 3);
+      REQUIRE(uut.count(champsim::address{0x1030}) == 2);
+      REQUIRE(uut.count(champsim::address{0x2000}) == 1);
+      REQUIRE(uut.count(champsim::address{0x3000}) == 0);
+      REQUIRE(uut.find(champsim::address{0x1010})->id == 1);
+      REQUIRE(uut.find(champsim::address{0x3000}) == std::end(uut));
+    }
+
+    WHEN("The front packet is erased") {
+      uut.erase(std::cbegin(uut));
+
+      THEN("The next packet in the block is found") {
+        REQUIRE(uut.count(champsim::address{0x1000}) == 1);
+        REQUIRE(uut.find(champsim::address{0x1000})->id == 2);
+      }
+    }
+
+    WHEN("The deque is cleared") {
+      uut.clear();
+
+      THEN("No block is found") {
+        REQUIRE(std::empty(uut));
+        REQUIRE(uut.count(champsim::address{0x1000}) == 0);
+        REQUIRE(uut.count(champsim::address{0x2000}) == 0);
+      }
+    }
+  }
+}
+
+TEST_CASE("A block-indexed deque finds the same packet as a linear search") {
+  using namespace champsim::data::data_literals;
+  champsim::block_indexed_deque<packet> uut{6_b};
+  std::deque<packet> reference;
+  std::mt19937_64 rng{3};
+  std::uniform_int_distribution<uint64_t> addr_dist{0, 0x800};
+  std::uniform_int_distribution<int> action{0, 3};
+
+  for (int i = 0; i < 5000; ++i) {
+    auto act = action(rng);
+    if (act == 0 && !std::empty(reference)) {
+      uut.pop_front();
+      reference.pop_front();
+    } else if (act == 1 && std::size(reference) > 2) {
+      uut.erase(std::next(std::cbegin(uut)), std::next(std::cbegin(uut), 3));
+      reference.erase(std::next(std::cbegin(reference)), std::next(std::cbegin(reference), 3));
+    } else {
+      packet pkt{champsim::address{addr_dist(rng)}, i};
+      uut.push_back(pkt);
+      reference.push_back(pkt);
+    }
+
+    champsim::address probe{addr_dist(rng)};
+    auto expected = std::find_if(std::begin(reference), std::end(reference),
+                                 [probe](const auto& x) { return x.address.slice_upper(6_b) == probe.slice_upper(6_b); });
+    auto found = uut.find(probe);
+    REQUIRE((found == std::end(uut)) == (expected == std::end(reference)));
+    if (found != std::end(uut)) {
+      REQUIRE(found->id == expected->id);
+    }
+    REQUIRE(uut.count(probe) == static_cast<std::size_t>(std::count_if(std::begin(reference), std::end(reference), [probe](const auto& x) {
+              return x.address.slice_upper(6_b) == probe.slice_upper(6_b);
+            })));
+  }
+}
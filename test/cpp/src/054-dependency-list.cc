@@ -0,0 +1,81 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include "dependency_list.h"
+
+namespace
+{
+std::vector<uint64_t> contents(const champsim::dependency_list& list) { return std::vector<uint64_t>{std::begin(list), std::end(list)}; }
+} // namespace
+
+SCENARIO("Dependency lists share their contents until one is modified") {
+  GIVEN("A list and a copy of it") {
+    champsim::dependency_list original{1, 3, 5};
+    auto copy = original;
+
+    THEN("Both lists have the same contents") {
+      REQUIRE(contents(copy) == std::vector<uint64_t>{1, 3, 5});
+      REQUIRE(copy == original);
+    }
+
+    WHEN("The front of the copy is erased") {
+      copy.erase(std::begin(copy));
+
+      THEN("Only the copy changes") {
+        REQUIRE(contents(copy) == std::vector<uint64_t>{3, 5});
+        REQUIRE(contents(original) == std::vector<uint64_t>{1, 3, 5});
+        REQUIRE(copy != original);
+      }
+    }
+
+    WHEN("A prefix of the copy is erased") {
+      copy.erase(std::begin(copy), std::next(std::begin(copy), 2));
+
+      THEN("Only the copy changes") {
+        REQUIRE(contents(copy) == std::vector<uint64_t>{5});
+        REQUIRE(contents(original) == std::vector<uint64_t>{1, 3, 5});
+      }
+    }
+
+    WHEN("An empty range of the copy is erased") {
+      copy.erase(std::begin(copy), std::begin(copy));
+
+      THEN("The lists still share their contents") {
+        REQUIRE(copy == original);
+      }
+    }
+
+    WHEN("An id is appended to the original") {
+      original.push_back(7);
+
+      THEN("Only the original changes") {
+        REQUIRE(contents(original) == std::vector<uint64_t>{1, 3, 5, 7});
+        REQUIRE(contents(copy) == std::vector<uint64_t>{1, 3, 5});
+      }
+    }
+  }
+}
+
+TEST_CASE("Merging dependency lists takes their sorted union") {
+  champsim::dependency_list lhs{1, 4, 6};
+  champsim::dependency_list rhs{2, 4, 8};
+  champsim::dependency_list empty{};
+
+  REQUIRE(contents(champsim::dependency_list::merge(lhs, rhs)) == std::vector<uint64_t>{1, 2, 4, 6, 8});
+  REQUIRE(contents(champsim::dependency_list::merge(lhs, lhs)) == std::vector<uint64_t>{1, 4, 6});
+  REQUIRE(champsim::dependency_list::merge(empty, rhs) == rhs);
+  REQUIRE(champsim::dependency_list::merge(lhs, empty) == lhs);
+  REQUIRE(champsim::dependency_list::merge(empty, empty).empty());
+}
+
+TEST_CASE("An empty dependency list has an empty range") {
+  champsim::dependency_list uut{};
+  REQUIRE(uut.empty());
+  REQUIRE(std::size(uut) == 0);
+  REQUIRE(std::begin(uut) == std::end(uut));
+
+  uut.push_back(9);
+  REQUIRE(std::size(uut) == 1);
+  REQUIRE(uut.front() == 9);
+}
@@ -0,0 +1,120 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+#include "capability_memory.h"
+#include "checkpoint.h"
+#include "functional_warmer.h"
+
+SCENARIO("A checkpoint reads back the values that were written") {
+  GIVEN("A checkpoint with values and sections") {
+    champsim::checkpoint_writer out;
+    out.write(uint64_t{0xdeadbeef});
+    out.write(std::vector<int>{1, 2, 3});
+    out.write_section("second", [](auto& section) { section.write(long{2}); });
+    out.write_section("first", [](auto& section) { section.write_string("one"); });
+
+    WHEN("It is read") {
+      champsim::checkpoint_reader in{out.data()};
+      uint64_t value{};
+      std::vector<int> values{};
+      in.read(value);
+      in.read(values);
+      auto sections = in.read_sections();
+
+      THEN("The values are the same") {
+        CHECK(value == 0xdeadbeef);
+        CHECK(values == std::vector<int>{1, 2, 3});
+        CHECK(in.empty());
+      }
+
+      THEN("The sections can be read in any order") {
+        REQUIRE(sections.size() == 2);
+        CHECK(sections.at("first").read_string() == "one");
+        long second{};
+        sections.at("second").read(second);
+        CHECK(second == 2);
+      }
+    }
+
+    WHEN("A truncated checkpoint is read") {
+      auto truncated = std::string_view{out.data()}.substr(0, 12);
+      champsim::checkpoint_reader in{truncated};
+      uint64_t value{};
+      std::vector<int> values{};
+      in.read(value);
+
+      THEN("Reading past the end throws") {
+        CHECK_THROWS_AS(in.read(values), std::runtime_error);
+      }
+    }
+  }
+}
+
+SCENARIO("A restored cache holds the blocks that were saved") {
+  GIVEN("A cache with a warmed block") {
+    champsim::initialize_capability_memory(1);
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("055-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+
+    do_nothing_MRC restored_ll;
+    to_rq_MRP restored_ul;
+    CACHE restored{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("055-restored")
+      .upper_levels({&restored_ul.queues})
+      .lower_level(&restored_ll.queues)
+    };
+
+    std::array<champsim::operable*, 2> elements{{&uut, &restored}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = true;
+      elem->begin_phase();
+    }
+
+    decltype(mock_ul)::request_type test;
+    test.address = champsim::address{0xdeadbeef};
+    test.cpu = 0;
+    test.type = access_type::LOAD;
+
+    champsim::functional_warmer{{uut}, {}}.access(&mock_ul.queues, test);
+
+    WHEN("Its state is loaded into another cache of the same size") {
+      champsim::checkpoint_writer out;
+      uut.save_state(out);
+      champsim::checkpoint_reader in{out.data()};
+      restored.load_state(in);
+
+      champsim::functional_warmer{{restored}, {}}.access(&restored_ul.queues, test);
+
+      THEN("The block hits in the restored cache") {
+        CHECK(restored.sim_stats.hits.value_or(std::pair{access_type::LOAD, std::size_t{0}}, 0) == 1);
+        CHECK(restored.sim_stats.misses.value_or(std::pair{access_type::LOAD, std::size_t{0}}, 0) == 0);
+      }
+    }
+
+    WHEN("Its state is loaded into a cache of another size") {
+      do_nothing_MRC small_ll;
+      to_rq_MRP small_ul;
+      CACHE small{champsim::cache_builder{champsim::defaults::default_l1d}
+        .name("055-small")
+        .sets(1)
+        .upper_levels({&small_ul.queues})
+        .lower_level(&small_ll.queues)
+      };
+
+      champsim::checkpoint_writer out;
+      uut.save_state(out);
+      champsim::checkpoint_reader in{out.data()};
+
+      THEN("Loading throws") {
+        CHECK_THROWS_AS(small.load_state(in), std::runtime_error);
+      }
+    }
+  }
+}
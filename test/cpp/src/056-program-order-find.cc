@@ -0,0 +1,46 @@
+#include <catch.hpp>
+
+#include <deque>
+
+#include "instruction.h"
+
+namespace
+{
+struct entry : champsim::program_ordered<entry> {
+};
+
+std::deque<entry> with_ids(std::initializer_list<uint64_t> ids)
+{
+  std::deque<entry> retval{};
+  for (auto id : ids) {
+    retval.emplace_back().instr_id = id;
+  }
+  return retval;
+}
+} // namespace
+
+TEST_CASE("An instruction is found among consecutive IDs") {
+  auto uut = with_ids({10, 11, 12, 13});
+  auto found = entry::find_id(std::begin(uut), std::end(uut), 12);
+  REQUIRE(found != std::end(uut));
+  REQUIRE(found->instr_id == 12);
+}
+
+TEST_CASE("An instruction is found among IDs with gaps") {
+  auto uut = with_ids({10, 14, 15, 20});
+  auto id = GENERATE(as<uint64_t>{}, 10, 14, 15, 20);
+  auto found = entry::find_id(std::begin(uut), std::end(uut), id);
+  REQUIRE(found != std::end(uut));
+  REQUIRE(found->instr_id == id);
+}
+
+TEST_CASE("A missing instruction is not found") {
+  auto uut = with_ids({10, 14, 15, 20});
+  auto id = GENERATE(as<uint64_t>{}, 0, 11, 16, 21);
+  REQUIRE(entry::find_id(std::begin(uut), std::end(uut), id) == std::end(uut));
+}
+
+TEST_CASE("Nothing is found in an empty range") {
+  std::deque<entry> uut{};
+  REQUIRE(entry::find_id(std::begin(uut), std::end(uut), 0) == std::end(uut));
+}
@@ -52,6 +52,17 @@ TEST_CASE("Two event counters can be added") {
   REQUIRE((lhs + rhs).at(key) == lhs_value + rhs_value);
 }
 
+TEST_CASE("Merging an event counter allocates the keys only it has seen") {
+  champsim::stats::event_counter<int> lhs{};
+  champsim::stats::event_counter<int> rhs{};
+  lhs.set(2016, 100);
+  rhs.set(2016, 20);
+  rhs.set(2024, 5);
+  lhs.merge(rhs);
+  REQUIRE(lhs.at(2016) == 120);
+  REQUIRE(lhs.at(2024) == 5);
+}
+
 TEST_CASE("Two event counters can be subtracted") {
   champsim::stats::event_counter<int> lhs{};
   champsim::stats::event_counter<int> rhs{};
@@ -0,0 +1,107 @@
+#include <catch.hpp>
+
+#include <tuple>
+#include <utility>
+
+#include "access_type.h"
+#include "event_counter.h"
+
+namespace
+{
+using counter_type = champsim::stats::dense_event_counter<std::pair<access_type, std::size_t>, static_cast<std::size_t>(access_type::NUM_TYPES)>;
+}
+
+TEST_CASE("A dense event counter can allocate") {
+  counter_type uut{};
+  constexpr typename decltype(uut)::key_type key{access_type::RFO, 2};
+  uut.allocate(key);
+  REQUIRE(uut.at(key) == 0);
+  REQUIRE(uut.value_or(key, 3) == 0);
+}
+
+TEST_CASE("A dense event counter can increment") {
+  counter_type uut{};
+  constexpr typename decltype(uut)::key_type key{access_type::WRITE, 0};
+  uut.increment(key);
+  REQUIRE(uut.at(key) == 1);
+  uut.increment(key);
+  REQUIRE(uut.at(key) == 2);
+  REQUIRE(uut.value_or(typename decltype(uut)::key_type{access_type::LOAD, 0}, 3) == 3);
+}
+
+TEST_CASE("A dense event counter can give a substitute value in the case of missing data") {
+  counter_type uut{};
+  REQUIRE(uut.value_or(std::pair{access_type::LOAD, std::size_t{7}}, 3) == 3);
+}
+
+TEST_CASE("A dense event counter can deallocate after allocation") {
+  counter_type uut{};
+  constexpr typename decltype(uut)::key_type key{access_type::PREFETCH, 1};
+  uut.set(key, 100);
+  uut.deallocate(key);
+  REQUIRE(uut.value_or(key, 3) == 3);
+  REQUIRE(uut.total() == 0);
+}
+
+TEST_CASE("A dense event counter lists its allocated keys in order") {
+  counter_type uut{};
+  uut.increment({access_type::WRITE, 4});
+  uut.increment({access_type::LOAD, 4});
+  uut.increment({access_type::RFO, 0});
+  uut.increment({access_type::LOAD, 4});
+
+  using key_type = typename decltype(uut)::key_type;
+  REQUIRE(uut.get_keys() == std::vector<key_type>{{access_type::LOAD, 4}, {access_type::RFO, 0}, {access_type::WRITE, 4}});
+  REQUIRE(uut.total() == 4);
+}
+
+TEST_CASE("A dense event counter indexes every element of a tuple key") {
+  using key_type = std::tuple<unsigned, access_type, std::size_t>;
+  champsim::stats::dense_event_counter<key_type, 5, static_cast<std::size_t>(access_type::NUM_TYPES)> uut{};
+  uut.increment({4, access_type::TRANSLATION, 1});
+  uut.increment({0, access_type::LOAD, 1});
+  uut.increment({4, access_type::LOAD, 1});
+
+  REQUIRE(uut.at({4, access_type::TRANSLATION, 1}) == 1);
+  REQUIRE(uut.at({4, access_type::LOAD, 1}) == 1);
+  REQUIRE(uut.value_or({0, access_type::TRANSLATION, 1}, -1) == -1);
+  REQUIRE(uut.get_keys() == std::vector<key_type>{{0, access_type::LOAD, 1}, {4, access_type::LOAD, 1}, {4, access_type::TRANSLATION, 1}});
+}
+
+TEST_CASE("Two dense event counters can be added") {
+  counter_type lhs{};
+  counter_type rhs{};
+  constexpr typename decltype(lhs)::key_type key{access_type::LOAD, 0};
+  lhs.set(key, 100);
+  rhs.set(key, 20);
+  REQUIRE((lhs + rhs).at(key) == 120);
+}
+
+TEST_CASE("Merging a dense event counter allocates the keys and rows only it has seen") {
+  counter_type lhs{};
+  counter_type rhs{};
+  constexpr typename decltype(lhs)::key_type key{access_type::LOAD, 0};
+  constexpr typename decltype(lhs)::key_type other_key{access_type::RFO, 0};
+  constexpr typename decltype(lhs)::key_type other_row{access_type::LOAD, 1};
+  lhs.set(key, 100);
+  rhs.set(key, 20);
+  rhs.set(other_key, 5);
+  rhs.set(other_row, 7);
+  lhs.merge(rhs);
+  REQUIRE(lhs.at(key) == 120);
+  REQUIRE(lhs.at(other_key) == 5);
+  REQUIRE(lhs.at(other_row) == 7);
+}
+
+TEST_CASE("Two dense event counters can be subtracted") {
+  counter_type lhs{};
+  counter_type rhs{};
+  constexpr typename decltype(lhs)::key_type key{access_type::LOAD, 0};
+  constexpr typename decltype(lhs)::key_type other_key{access_type::RFO, 0};
+  lhs.set(key, 100);
+  rhs.set(key, 20);
+  rhs.set(other_key, 5);
+  auto result = lhs - rhs;
+  REQUIRE(result.at(key) == 80);
+  REQUIRE(result.value_or(other_key, 3) == 3);
+}
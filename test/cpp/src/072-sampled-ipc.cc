@@ -0,0 +1,97 @@
+#include <catch.hpp>
+
+#include <cmath>
+
+#include "cache_stats.h"
+#include "core_stats.h"
+
+namespace
+{
+cpu_stats window(long long instrs, long long cycles)
+{
+  cpu_stats stats;
+  stats.begin_instrs = 100;
+  stats.end_instrs = 100 + instrs;
+  stats.begin_cycles = 1000;
+  stats.end_cycles = 1000 + cycles;
+  return stats;
+}
+} // namespace
+
+TEST_CASE("The statistics of windows sum to the instructions and cycles of all windows") {
+  auto uut = window(10, 20) + window(30, 40);
+  REQUIRE(uut.instrs() == 40);
+  REQUIRE(uut.cycles() == 60);
+}
+
+TEST_CASE("The statistics of windows sum the events first seen in a later window") {
+  auto first = window(10, 20);
+  first.total_branch_types.set(BRANCH_CONDITIONAL, 3);
+  auto second = window(30, 40);
+  second.total_branch_types.set(BRANCH_CONDITIONAL, 2);
+  second.total_branch_types.set(BRANCH_RETURN, 4);
+  second.branch_type_misses.set(BRANCH_RETURN, 1);
+
+  auto uut = first + second;
+  REQUIRE(uut.total_branch_types.at(BRANCH_CONDITIONAL) == 5);
+  REQUIRE(uut.total_branch_types.at(BRANCH_RETURN) == 4);
+  REQUIRE(uut.branch_type_misses.at(BRANCH_RETURN) == 1);
+}
+
+TEST_CASE("The cache statistics of windows sum the accesses first seen in a later window") {
+  cache_stats first;
+  first.hits.set({access_type::LOAD, 0}, 3);
+  cache_stats second;
+  second.hits.set({access_type::LOAD, 0}, 1);
+  second.hits.set({access_type::WRITE, 1}, 4);
+  second.misses.set({access_type::WRITE, 1}, 2);
+
+  auto uut = first + second;
+  REQUIRE(uut.hits.at({access_type::LOAD, 0}) == 4);
+  REQUIRE(uut.hits.at({access_type::WRITE, 1}) == 4);
+  REQUIRE(uut.misses.at({access_type::WRITE, 1}) == 2);
+}
+
+TEST_CASE("The IPC estimate of no windows is empty") {
+  auto uut = estimate_ipc({});
+  REQUIRE(uut.windows == 0);
+  REQUIRE(uut.ipc == 0);
+}
+
+TEST_CASE("The IPC estimate of one window has no confidence interval") {
+  auto uut = estimate_ipc({window(10, 20)});
+  REQUIRE(uut.windows == 1);
+  REQUIRE(uut.ipc == Approx(0.5));
+  REQUIRE(uut.lower == Approx(0.5));
+  REQUIRE(uut.upper == Approx(0.5));
+}
+
+TEST_CASE("The IPC estimate is the reciprocal of the mean of the windows' CPIs") {
+  auto uut = estimate_ipc({window(20, 10), window(20, 30), window(20, 20)});
+  REQUIRE(uut.windows == 3);
+
+  // The mean of the IPCs would be about 1.06
+  REQUIRE(uut.ipc == Approx(1.0));
+
+  // The sample standard deviation of the CPIs is 0.5
+  auto half_width = 1.96 * 0.5 / std::sqrt(3.0);
+  REQUIRE(uut.lower == Approx(1.0 / (1.0 + half_width)));
+  REQUIRE(uut.upper == Approx(1.0 / (1.0 - half_width)));
+}
+
+TEST_CASE("The IPC estimate of identical windows has no spread") {
+  auto uut = estimate_ipc({window(10, 20), window(10, 20)});
+  REQUIRE(uut.ipc == Approx(0.5));
+  REQUIRE(uut.lower == Approx(0.5));
+  REQUIRE(uut.upper == Approx(0.5));
+}
+
+TEST_CASE("The IPC estimate is unbounded above if the CPI interval reaches zero") {
+  auto uut = estimate_ipc({window(10, 1), window(10, 100)});
+  REQUIRE(std::isinf(uut.upper));
+}
+
+TEST_CASE("The IPC estimate skips windows without cycles") {
+  auto uut = estimate_ipc({window(10, 20), window(0, 0)});
+  REQUIRE(uut.windows == 1);
+}
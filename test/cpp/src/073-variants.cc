@@ -0,0 +1,82 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "variants.h"
+
+namespace
+{
+std::vector<char> read_stream(const std::string& name, std::size_t count)
+{
+  std::ifstream stream{name};
+  std::vector<char> retval(count);
+  stream.read(std::data(retval), static_cast<std::streamsize>(count));
+  retval.resize(static_cast<std::size_t>(stream.gcount()));
+  return retval;
+}
+} // namespace
+
+TEST_CASE("A variant's file name has the variant's name before the extension") {
+  CHECK(champsim::variant_file_name("out.json", "nl") == "out.nl.json");
+  CHECK(champsim::variant_file_name("dir.d/out", "nl") == "dir.d/out.nl");
+}
+
+SCENARIO("Every variant reads the whole of each trace") {
+  GIVEN("Two traces") {
+    std::vector<std::vector<char>> contents{std::vector<char>(3 << 20), std::vector<char>(2 << 20)};
+    std::vector<std::string> trace_names;
+    for (auto& content : contents) {
+      std::iota(std::begin(content), std::end(content), static_cast<char>(std::size(trace_names)));
+      auto& name = trace_names.emplace_back(std::filesystem::temp_directory_path() / ("073-variants-trace" + std::to_string(std::size(trace_names))));
+      std::ofstream{name}.write(std::data(content), static_cast<std::streamsize>(std::size(content)));
+    }
+
+    WHEN("Three variants read them") {
+      auto result = champsim::run_variants({"a", "b", "c"}, trace_names, false, [&](std::size_t, std::vector<std::string> stream_names) {
+        // Read the traces in the opposite order, so that the streams must make progress independently
+        bool same = read_stream(stream_names.at(1), std::size(contents.at(1)) + 1) == contents.at(1);
+        same = same && read_stream(stream_names.at(0), std::size(contents.at(0)) + 1) == contents.at(0);
+        return same ? 0 : 1;
+      });
+
+      THEN("Each variant reads the traces' contents") { REQUIRE(result == 0); }
+    }
+
+    WHEN("The variants read the traces in different orders, and may buffer only one chunk") {
+      auto result = champsim::run_variants({"a", "b"}, trace_names, false, [&](std::size_t i, std::vector<std::string> stream_names) {
+        // Each variant is the slowest reader of the trace that the other reads first
+        bool same = read_stream(stream_names.at(i), std::size(contents.at(i)) + 1) == contents.at(i);
+        same = same && read_stream(stream_names.at(1 - i), std::size(contents.at(1 - i)) + 1) == contents.at(1 - i);
+        return same ? 0 : 1;
+      }, std::size_t{1} << 20);
+
+      THEN("Neither variant waits on the other forever") { REQUIRE(result == 0); }
+    }
+
+    WHEN("The traces repeat") {
+      auto result = champsim::run_variants({"a", "b"}, trace_names, true, [&](std::size_t, std::vector<std::string> stream_names) {
+        auto repeated = contents.at(1);
+        repeated.insert(std::end(repeated), std::begin(contents.at(1)), std::end(contents.at(1)));
+        return read_stream(stream_names.at(1), std::size(repeated)) == repeated ? 0 : 1;
+      });
+
+      THEN("Each variant reads them from the beginning again") { REQUIRE(result == 0); }
+    }
+
+    WHEN("A variant fails") {
+      auto result = champsim::run_variants({"a", "b"}, trace_names, false, [&](std::size_t i, std::vector<std::string>) { return static_cast<int>(i); });
+
+      THEN("The run fails") { REQUIRE(result != 0); }
+    }
+
+    for (const auto& name : trace_names) {
+      std::remove(name.c_str());
+    }
+  }
+}
@@ -0,0 +1,123 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+#include "capability_memory.h"
+#include "functional_warmer.h"
+#include "reuse_profiler.h"
+
+TEST_CASE("The first access to a block is cold") {
+  champsim::reuse_profiler uut{1};
+  REQUIRE(uut.access(0xdead) == champsim::reuse_profiler::cold_bucket);
+}
+
+TEST_CASE("An immediate reuse has a distance of zero") {
+  champsim::reuse_profiler uut{1};
+  uut.access(0xdead);
+  REQUIRE(uut.access(0xdead) == 0);
+}
+
+TEST_CASE("The distance counts distinct blocks") {
+  champsim::reuse_profiler uut{1};
+  uut.access(1);
+  uut.access(2);
+  uut.access(3);
+  uut.access(2);
+  uut.access(3);
+
+  // Blocks 2 and 3 were accessed since block 1, so the distance is 2, which is in [2, 4)
+  REQUIRE(uut.access(1) == 2);
+}
+
+TEST_CASE("The distance is kept over many accesses") {
+  champsim::reuse_profiler uut{1};
+
+  // Cycling through 100 blocks gives each reuse a distance of 99, which is in [64, 128)
+  constexpr uint64_t working_set = 100;
+  constexpr uint64_t accesses = 300000;
+  std::size_t wrong = 0;
+  for (uint64_t i = working_set; i < accesses; ++i) {
+    auto bucket = uut.access(i % working_set);
+    if (i >= 2 * working_set && bucket != 7) {
+      ++wrong;
+    }
+  }
+  REQUIRE(wrong == 0);
+}
+
+TEST_CASE("A sampled distance estimates the distance among all blocks") {
+  champsim::reuse_profiler uut{0.1};
+
+  // Cycling through 10000 blocks gives each reuse a distance of 9999, which is in [8192, 16384)
+  constexpr uint64_t working_set = 10000;
+  std::size_t sampled = 0;
+  std::size_t in_bucket = 0;
+  for (uint64_t i = 0; i < 5 * working_set; ++i) {
+    auto bucket = uut.access(i % working_set);
+    if (i >= working_set && bucket.has_value()) {
+      ++sampled;
+      in_bucket += (bucket == 14) ? 1 : 0;
+    }
+  }
+
+  CHECK(sampled > 3000);
+  CHECK(sampled < 5000);
+  REQUIRE(in_bucket > 9 * sampled / 10);
+}
+
+TEST_CASE("A sampling rate must be a fraction") {
+  REQUIRE_THROWS_AS(champsim::reuse_profiler{0}, std::invalid_argument);
+  REQUIRE_THROWS_AS(champsim::reuse_profiler{1.5}, std::invalid_argument);
+}
+
+TEST_CASE("The miss ratio curve counts the accesses beyond each size") {
+  cache_stats::reuse_counter distances;
+  distances.set(reuse_key{0, cap_size_coverage_events::UNTAGGED, access_type::LOAD, 0}, 2);
+  distances.set(reuse_key{2, cap_size_coverage_events::UNTAGGED, access_type::LOAD, 0}, 1);
+  distances.set(reuse_key{champsim::reuse_profiler::cold_bucket, cap_size_coverage_events::UNTAGGED, access_type::LOAD, 0}, 1);
+  distances.set(reuse_key{0, cap_size_coverage_events::UNTAGGED, access_type::RFO, 0}, 4);
+
+  auto loads = miss_ratio_curve(distances, 0, [](auto, auto type) { return type == access_type::LOAD; });
+  REQUIRE(std::size(loads) == champsim::reuse_profiler::cold_bucket);
+  CHECK(loads.at(0) == Approx(0.5));
+  CHECK(loads.at(1) == Approx(0.5));
+  CHECK(loads.at(2) == Approx(0.25));
+  CHECK(loads.back() == Approx(0.25));
+
+  CHECK(std::empty(miss_ratio_curve(distances, 1, [](auto, auto) { return true; })));
+}
+
+SCENARIO("A cache with a reuse profile records the distance of each access") {
+  GIVEN("A cache that profiles every block") {
+    champsim::initialize_capability_memory(1);
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("074-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+
+    uut.initialize();
+    uut.warmup = false;
+    uut.begin_phase();
+    uut.profile_reuse(1);
+
+    WHEN("A block is accessed twice") {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xdeadbeef};
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+
+      champsim::functional_warmer warmer{{uut}, {}};
+      warmer.access(&mock_ul.queues, test);
+      warmer.access(&mock_ul.queues, test);
+
+      THEN("The first access is cold and the second has a distance of zero") {
+        auto key = [](unsigned bucket) { return reuse_key{bucket, cap_size_coverage_events::UNTAGGED, access_type::LOAD, 0}; };
+        CHECK(uut.sim_stats.reuse_distances.value_or(key(champsim::reuse_profiler::cold_bucket), 0) == 1);
+        CHECK(uut.sim_stats.reuse_distances.value_or(key(0), 0) == 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,76 @@
+#include <catch.hpp>
+
+#include <numeric>
+#include <sstream>
+#include <string>
+
+#include "async_stream.h"
+#include "tracereader.h"
+
+namespace {
+std::string make_text(std::size_t size)
+{
+  std::string text(size, '\0');
+  std::iota(std::begin(text), std::end(text), 'a');
+  return text;
+}
+}
+
+TEST_CASE("An async_istream reads the same bytes as its underlying stream") {
+  auto block_size = GENERATE(as<std::size_t>{}, 1, 7, 64, 1000);
+  auto depth = GENERATE(as<std::size_t>{}, 1, 4);
+  const auto text = make_text(500);
+  champsim::async_istream<std::istringstream> uut{std::istringstream{text}, block_size, depth};
+
+  STATIC_REQUIRE(std::is_move_constructible<decltype(uut)>::value);
+  STATIC_REQUIRE(std::is_move_assignable<decltype(uut)>::value);
+
+  std::string result(std::size(text), '\0');
+  uut.read(std::data(result), 100);
+  REQUIRE(uut.gcount() == 100);
+  REQUIRE_FALSE(uut.eof());
+  uut.read(std::next(std::data(result), 100), 400);
+  REQUIRE(uut.gcount() == 400);
+  REQUIRE(result == text);
+}
+
+TEST_CASE("An async_istream reports the end of its stream") {
+  const auto text = make_text(100);
+  champsim::async_istream<std::istringstream> uut{std::istringstream{text}, 64, 2};
+
+  std::string result(200, '\0');
+  uut.read(std::data(result), 200);
+  REQUIRE(uut.gcount() == 100);
+  REQUIRE(uut.eof());
+
+  uut.read(std::data(result), 200);
+  REQUIRE(uut.gcount() == 0);
+  REQUIRE(uut.eof());
+}
+
+TEST_CASE("An async_istream can be replaced while its producer is running") {
+  const auto text = make_text(1000);
+  champsim::async_istream<std::istringstream> uut{std::istringstream{make_text(100000)}, 16, 2};
+  uut = champsim::async_istream<std::istringstream>{std::istringstream{text}, 16, 2};
+
+  std::string result(std::size(text), '\0');
+  uut.read(std::data(result), static_cast<std::streamsize>(std::size(result)));
+  REQUIRE(result == text);
+}
+
+TEST_CASE("A tracereader can read from an async_istream") {
+  input_instr record{};
+  std::string trace{};
+  for (unsigned long long ip = 1; ip <= 300; ++ip) {
+    record.ip = ip;
+    trace.append(reinterpret_cast<const char*>(&record), sizeof(record));
+  }
+
+  champsim::bulk_tracereader<input_instr, champsim::async_istream<std::istringstream>> uut{
+      0, champsim::async_istream<std::istringstream>{std::istringstream{trace}, 10 * sizeof(input_instr), 3}};
+
+  for (unsigned long long ip = 1; ip <= 300; ++ip) {
+    REQUIRE(uut().ip == champsim::address{ip});
+  }
+  REQUIRE(uut.eof());
+}
@@ -0,0 +1,59 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "mmap_stream.h"
+#include "tracereader.h"
+
+namespace {
+struct temporary_trace {
+  std::filesystem::path path;
+
+  explicit temporary_trace(const std::string& contents) : path(std::filesystem::temp_directory_path() / "champsim-087-mmap-stream.raw")
+  {
+    std::ofstream file{path, std::ios::binary};
+    file.write(std::data(contents), static_cast<std::streamsize>(std::size(contents)));
+  }
+
+  ~temporary_trace() { std::filesystem::remove(path); }
+};
+}
+
+TEST_CASE("An mmap_istream reads the contents of a file") {
+  const std::string text{"Lorem ipsum dolor sit amet, consectetur adipiscing elit"};
+  temporary_trace file{text};
+  champsim::mmap_istream uut{file.path.string()};
+
+  STATIC_REQUIRE(std::is_move_constructible<decltype(uut)>::value);
+  STATIC_REQUIRE(std::is_move_assignable<decltype(uut)>::value);
+
+  std::string result(std::size(text), '\0');
+  uut.read(std::data(result), 11);
+  REQUIRE(uut.gcount() == 11);
+  REQUIRE_FALSE(uut.eof());
+
+  auto [first, last] = uut.read_in_place(1000);
+  REQUIRE(uut.gcount() == static_cast<std::streamsize>(std::size(text) - 11));
+  REQUIRE(uut.eof());
+  std::copy(first, last, std::next(std::begin(result), 11));
+  REQUIRE(result == text);
+}
+
+TEST_CASE("A tracereader can read records in place from an mmap_istream") {
+  input_instr record{};
+  std::string trace{};
+  for (unsigned long long ip = 1; ip <= 300; ++ip) {
+    record.ip = ip;
+    trace.append(reinterpret_cast<const char*>(&record), sizeof(record));
+  }
+  temporary_trace file{trace};
+
+  champsim::bulk_tracereader<input_instr, champsim::mmap_istream> uut{0, file.path.string()};
+  for (unsigned long long ip = 1; ip <= 300; ++ip) {
+    REQUIRE(uut().ip == champsim::address{ip});
+  }
+  REQUIRE(uut.eof());
+}
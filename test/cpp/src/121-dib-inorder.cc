@@ -57,6 +57,7 @@ SCENARIO("Instructions that hit the DIB do not reorder ahead of instructions tha
       .fetch_queues(&mock_L1I.queues)
         .data_queues(&mock_L1D.queues)
         .decode_latency(10)
+        .ifetch_buffer_size(256)
 
     };
     uut.warmup = false;
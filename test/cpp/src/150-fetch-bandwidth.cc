@@ -15,6 +15,7 @@ SCENARIO("The fetch bandwidth limits the number of packets issued each cycle") {
       .fetch_queues(&mock_L1I.queues)
       .data_queues(&mock_L1D.queues)
       .l1i_bandwidth(champsim::bandwidth::maximum_type{bandwidth})
+      .ifetch_buffer_size(std::size(addrs))
     };
 
     std::array<champsim::operable*,3> elements = {&uut, &mock_L1I, &mock_L1D};
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+
+#include "checkpoint.h"
+#include "ooo_cpu.h"
+
+#include "../../../branch/bimodal/bimodal.h"
+#include "../../../branch/hashed_perceptron/hashed_perceptron.h"
+#include "../../../branch/tage_sc/tage_sc.h"
+
+namespace
+{
+// Train on a pattern that depends on the global history, so that the restored history matters as much as the tables
+template <typename P>
+void train(P& uut)
+{
+  for (uint64_t i = 0; i < 20000; ++i) {
+    champsim::address ip{0x400000 + ((i % 7) << 4)};
+    uut.predict_branch(ip);
+    uut.last_branch_result(ip, champsim::address{}, (i % 3) != 0, BRANCH_CONDITIONAL);
+  }
+}
+
+template <typename P>
+std::vector<bool> predictions(P& uut)
+{
+  std::vector<bool> retval;
+  for (uint64_t i = 0; i < 100; ++i) {
+    champsim::address ip{0x400000 + ((i % 7) << 4)};
+    retval.push_back(uut.predict_branch(ip));
+    uut.last_branch_result(ip, champsim::address{}, (i % 3) != 0, BRANCH_CONDITIONAL);
+  }
+  return retval;
+}
+
+template <typename P>
+void restore(const P& from, P& to)
+{
+  champsim::checkpoint_writer out;
+  from.branch_predictor_save_state(out);
+  champsim::checkpoint_reader in{out.data()};
+  to.branch_predictor_load_state(in);
+  REQUIRE(in.empty());
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("A restored branch predictor predicts like the one that was saved", "", hashed_perceptron, tage_sc) {
+  auto trained = std::make_unique<TestType>(nullptr);
+  auto restored = std::make_unique<TestType>(nullptr);
+  train(*trained);
+  restore(*trained, *restored);
+
+  REQUIRE(predictions(*restored) == predictions(*trained));
+}
+
+SCENARIO("A core keeps each branch predictor's state under its configured name") {
+  GIVEN("A core with a named branch predictor") {
+    do_nothing_MRC mock_L1I, mock_L1D;
+    O3_CPU uut{champsim::core_builder{}
+      .fetch_queues(&mock_L1I.queues)
+      .data_queues(&mock_L1D.queues)
+      .branch_predictor<bimodal>({"configured_bimodal"})
+    };
+
+    WHEN("Its branch predictor state is saved") {
+      champsim::checkpoint_writer out;
+      uut.impl_branch_predictor_save_state(out);
+      champsim::checkpoint_reader in{out.data()};
+      auto sections = in.read_sections();
+
+      THEN("The section is named for the module's configuration") {
+        REQUIRE(sections.size() == 1);
+        REQUIRE(sections.count("configured_bimodal") == 1);
+      }
+    }
+  }
+}
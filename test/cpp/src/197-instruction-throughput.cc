@@ -0,0 +1,50 @@
+#include <catch.hpp>
+
+#include <chrono>
+#include <deque>
+#include <fmt/core.h>
+
+#include "instruction.h"
+#include "util/circular_buffer.h"
+
+TEST_CASE("Instructions can be decoded and passed through the pipeline buffers", "[.][benchmark]") {
+  constexpr long num_instrs = 2'000'000;
+  constexpr std::size_t buffer_size = 64;
+
+  cheri_instr record{};
+  record.destination_registers[0] = 10;
+  record.source_registers[0] = 11;
+  record.source_registers[1] = 12;
+  record.source_memory[0] = 0xdeadbeef;
+
+  std::deque<ooo_model_instr> input_queue;
+  champsim::circular_buffer<ooo_model_instr> ifetch_buffer{buffer_size + 1};
+  champsim::circular_buffer<ooo_model_instr> decode_buffer{buffer_size + 1};
+  champsim::circular_buffer<ooo_model_instr> rob{buffer_size + 1};
+  std::size_t checksum = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < num_instrs; ++i) {
+    record.ip = static_cast<unsigned long long>(i) << 2;
+    input_queue.push_back(ooo_model_instr{0, record});
+
+    ifetch_buffer.push_back(input_queue.front());
+    input_queue.pop_front();
+    if (std::size(ifetch_buffer) > buffer_size) {
+      decode_buffer.push_back(std::move(ifetch_buffer.front()));
+      ifetch_buffer.pop_front();
+    }
+    if (std::size(decode_buffer) > buffer_size) {
+      rob.push_back(std::move(decode_buffer.front()));
+      decode_buffer.pop_front();
+    }
+    if (std::size(rob) > buffer_size) {
+      checksum += std::size(rob.front().source_registers) + std::size(rob.front().source_memory);
+      rob.pop_front();
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  fmt::print("{} instructions in {:.3f} s: {:.3e} instructions/second\n", num_instrs, elapsed.count(), static_cast<double>(num_instrs) / elapsed.count());
+  REQUIRE(checksum > 0);
+}
@@ -12,6 +12,7 @@ SCENARIO("The scheduler can detect RAW hazards") {
     O3_CPU uut{champsim::core_builder{}
       .schedule_width(champsim::bandwidth::maximum_type{schedule_width})
       .register_file_size(128)
+      .rob_size(8)
       .schedule_latency(schedule_latency)
       .fetch_queues(&mock_L1I.queues)
       .data_queues(&mock_L1D.queues)
@@ -44,6 +45,7 @@ SCENARIO("The scheduler can detect RAW hazards") {
     O3_CPU uut{champsim::core_builder{}
       .schedule_width(champsim::bandwidth::maximum_type{schedule_width})
       .register_file_size(128)
+      .rob_size(8)
       .schedule_latency(schedule_latency)
       .fetch_queues(&mock_L1I.queues)
       .data_queues(&mock_L1D.queues)
@@ -83,6 +85,7 @@ SCENARIO("The scheduler can detect RAW hazards") {
     O3_CPU uut{champsim::core_builder{}
       .schedule_width(champsim::bandwidth::maximum_type{schedule_width})
       .register_file_size(128)
+      .rob_size(8)
       .schedule_latency(schedule_latency)
       .fetch_queues(&mock_L1I.queues)
       .data_queues(&mock_L1D.queues)
@@ -144,6 +147,7 @@ SCENARIO("The scheduler handles WAW hazards") {
     O3_CPU uut{champsim::core_builder{}
       .schedule_width(champsim::bandwidth::maximum_type{schedule_width})
       .register_file_size(128)
+      .rob_size(8)
       .schedule_latency(schedule_latency)
       .execute_latency(execute_latency)
       .execute_width(champsim::bandwidth::maximum_type{execute_width})
@@ -219,6 +223,7 @@ SCENARIO("The scheduler handles WAW hazards") {
       .schedule_latency(schedule_latency)
       .execute_latency(execute_latency)
       .register_file_size(128)
+      .rob_size(8)
       .execute_width(champsim::bandwidth::maximum_type{execute_width})
       .retire_width(champsim::bandwidth::maximum_type{execute_width})
       .fetch_queues(&mock_L1I.queues)
@@ -288,6 +293,7 @@ TEST_CASE("ooo_cpu Benchmarks") {
       .schedule_latency(schedule_latency)
       .execute_latency(execute_latency)
       .register_file_size(128)
+      .rob_size(8)
       .execute_width(champsim::bandwidth::maximum_type{execute_width})
       .retire_width(champsim::bandwidth::maximum_type{execute_width})
       .fetch_queues(&mock_L1I.queues)
@@ -8,6 +8,7 @@ SCENARIO("The register allocation logic correctly reassigns physical register na
   GIVEN("An empty RAT"){    
     constexpr int PHYSICALREGS = 128;
     RegisterAllocator ra{PHYSICALREGS};
+    std::vector<std::reference_wrapper<ooo_model_instr>> woken{};
     
     WHEN("A write and then a read occurs to the same logical register"){
       auto write1 = champsim::test::instruction_with_ip(0);
@@ -88,7 +89,7 @@ SCENARIO("The register allocation logic correctly reassigns physical register na
         }
       
       AND_WHEN("The write is completed and retires"){
-        ra.complete_dest_register(write1.destination_registers[0]);
+        ra.complete_dest_register(write1.destination_registers[0], woken);
         ra.retire_dest_register(write1.destination_registers[0]);
         THEN("The read is no longer waiting on any registers to become valid."){
           REQUIRE(ra.count_reg_dependencies(read2) == 0);
@@ -194,6 +195,7 @@ SCENARIO("The register allocator correctly recycles physical registers when no l
 
     constexpr int PHYSICALREGS = 128;
     RegisterAllocator ra{PHYSICALREGS};
+    std::vector<std::reference_wrapper<ooo_model_instr>> woken{};
 
     WHEN("A write and then a read on the same logical register are scheduled, but only the write executes"){
       auto write1 = champsim::test::instruction_with_ip(1);
@@ -206,11 +208,11 @@ SCENARIO("The register allocator correctly recycles physical registers when no l
       read1.instr_id = 2;
       read1.source_registers[0] = ra.rename_src_register(read1.source_registers[0]);
       
-      ra.complete_dest_register(write1.destination_registers[0]);
+      ra.complete_dest_register(write1.destination_registers[0], woken);
 
       AND_WHEN("write1 retires"){
         write1.completed = true;
-        ra.complete_dest_register(write1.destination_registers[0]);
+        ra.complete_dest_register(write1.destination_registers[0], woken);
         ra.retire_dest_register(write1.destination_registers[0]);
         THEN("No registers should have been recycled since no new writes to that arch reg"){
           REQUIRE(ra.count_free_registers() == PHYSICALREGS-1);
@@ -229,7 +231,7 @@ SCENARIO("The register allocator correctly recycles physical registers when no l
               REQUIRE(ra.count_free_registers() == PHYSICALREGS-2);
             }
             AND_WHEN("The second write completes execution"){
-              ra.complete_dest_register(write2.destination_registers[0]);
+              ra.complete_dest_register(write2.destination_registers[0], woken);
               THEN("There should be PHYSICALREGS-2 free registers because the instruction has not retired"){
                 REQUIRE(ra.count_free_registers() == PHYSICALREGS-2);
               }
@@ -307,3 +309,38 @@ SCENARIO("The register allocator correctly recycles physical registers when no l
     }
   }
 }
+
+SCENARIO("The register allocator wakes instructions that wait on a register") {
+  GIVEN("A read that waits on a write"){
+    constexpr int PHYSICALREGS = 128;
+    RegisterAllocator ra{PHYSICALREGS};
+
+    auto write1 = champsim::test::instruction_with_ip(0);
+    write1.destination_registers.push_back(5);
+    write1.destination_registers[0] = ra.rename_dest_register(write1.destination_registers[0], write1.instr_id);
+
+    auto read1 = champsim::test::instruction_with_ip(1);
+    read1.source_registers.push_back(5);
+    read1.source_registers[0] = ra.rename_src_register(read1.source_registers[0]);
+    ra.add_waiting_instr(read1.source_registers[0], read1);
+
+    WHEN("The write completes"){
+      std::vector<std::reference_wrapper<ooo_model_instr>> woken{};
+      ra.complete_dest_register(write1.destination_registers[0], woken);
+
+      THEN("The read is woken"){
+        REQUIRE(std::size(woken) == 1);
+        REQUIRE(&woken.front().get() == &read1);
+        REQUIRE(ra.count_reg_dependencies(read1) == 0);
+      }
+
+      AND_WHEN("The register completes again"){
+        ra.complete_dest_register(write1.destination_registers[0], woken);
+
+        THEN("No instruction is woken twice"){
+          REQUIRE(woken.empty());
+        }
+      }
+    }
+  }
+}
@@ -11,6 +11,7 @@ SCENARIO("The core issues loads only after its registers are finished") {
       .data_queues(&mock_L1D.queues)
       .dispatch_width(champsim::bandwidth::maximum_type{2})
       .rob_size(2)
+      .dispatch_buffer_size(2)
       .lq_size(1)
     };
 
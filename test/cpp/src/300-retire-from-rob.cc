@@ -73,6 +73,7 @@ SCENARIO("Completed instructions are retired in order") {
     constexpr long retire_bandwidth = 2;
     O3_CPU uut{champsim::core_builder{}
       .retire_width(champsim::bandwidth::maximum_type{retire_bandwidth})
+      .rob_size(retire_bandwidth)
       .fetch_queues(&mock_L1I.queues)
       .data_queues(&mock_L1D.queues)
     };
@@ -119,6 +120,7 @@ SCENARIO("The retire bandwidth limits the number of retirements per cycle") {
     constexpr long num_instrs = 2 * retire_bandwidth;
     O3_CPU uut{champsim::core_builder{}
       .retire_width(champsim::bandwidth::maximum_type{retire_bandwidth})
+      .rob_size(num_instrs)
       .fetch_queues(&mock_L1I.queues)
       .data_queues(&mock_L1D.queues)
     };
@@ -0,0 +1,136 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+#include "capability_memory.h"
+#include "functional_warmer.h"
+
+SCENARIO("A functionally warmed block is present at each level") {
+  GIVEN("Two empty caches") {
+    champsim::initialize_capability_memory(1);
+    constexpr uint64_t hit_latency = 4;
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    champsim::channel middle_queues{};
+    CACHE lower{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("409a-lower")
+      .upper_levels({&middle_queues})
+      .lower_level(&mock_ll.queues)
+    };
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("409a-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&middle_queues)
+      .hit_latency(hit_latency)
+    };
+
+    std::array<champsim::operable*, 4> elements{{&uut, &lower, &mock_ll, &mock_ul}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = true;
+      elem->begin_phase();
+    }
+
+    champsim::functional_warmer warmer{{uut, lower}, {}};
+
+    WHEN("A load is warmed") {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xdeadbeef};
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+
+      auto response = warmer.access(&mock_ul.queues, test);
+
+      THEN("The response is for the load") {
+        CHECK(response.address == test.address);
+      }
+
+      THEN("Nothing waits in the queues") {
+        CHECK(mock_ll.packet_count() == 0);
+        CHECK(std::empty(middle_queues.RQ));
+        CHECK(uut.get_mshr_occupancy() == 0);
+        CHECK(lower.get_mshr_occupancy() == 0);
+      }
+
+      AND_WHEN("The load is warmed again") {
+        warmer.access(&mock_ul.queues, test);
+
+        THEN("It hits in the first cache only") {
+          CHECK(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, std::size_t{0}}, 0) == 1);
+          CHECK(lower.sim_stats.hits.value_or(std::pair{access_type::LOAD, std::size_t{0}}, 0) == 0);
+        }
+      }
+
+      AND_WHEN("The load is issued to the timed cache") {
+        for (auto elem : elements) {
+          elem->warmup = false;
+          elem->begin_phase();
+        }
+
+        auto test_result = mock_ul.issue(test);
+        REQUIRE(test_result);
+
+        for (uint64_t i = 0; i < 2 * hit_latency; ++i)
+          for (auto elem : elements)
+            elem->_operate();
+
+        THEN("It returns after the hit latency") {
+          REQUIRE_THAT(mock_ul.packets.front(), champsim::test::ReturnedMatcher(hit_latency, 1));
+          CHECK(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, std::size_t{0}}, 0) == 1);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A functionally warmed dirty block is written back when it is evicted") {
+  GIVEN("A cache with one block above an empty cache") {
+    champsim::initialize_capability_memory(1);
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    champsim::channel middle_queues{};
+    CACHE lower{champsim::cache_builder{champsim::defaults::default_l2c}
+      .name("409b-lower")
+      .upper_levels({&middle_queues})
+      .lower_level(&mock_ll.queues)
+    };
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("409b-uut")
+      .sets(1)
+      .ways(1)
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&middle_queues)
+    };
+
+    std::array<champsim::operable*, 4> elements{{&uut, &lower, &mock_ll, &mock_ul}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = true;
+      elem->begin_phase();
+    }
+
+    champsim::functional_warmer warmer{{uut, lower}, {}};
+
+    decltype(mock_ul)::request_type seed;
+    seed.address = champsim::address{0xdeadbeef};
+    seed.cpu = 0;
+    seed.type = access_type::WRITE;
+    seed.response_requested = false;
+    warmer.access(&mock_ul.queues, seed);
+
+    WHEN("A load to another block is warmed") {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xcafebabe};
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+      warmer.access(&mock_ul.queues, test);
+
+      THEN("The written block is written back to the lower cache") {
+        CHECK(std::empty(middle_queues.WQ));
+        CHECK(lower.sim_stats.hits.value_or(std::pair{access_type::WRITE, std::size_t{0}}, 0) == 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,158 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+#include "cache.h"
+#include "capability_memory.h"
+#include "prefetch_filter.h"
+
+TEST_CASE("A prefetch filter holds the blocks inserted into it") {
+  champsim::prefetch_filter uut{16};
+  uut.insert(0x1234);
+  REQUIRE(uut.contains(0x1234));
+  REQUIRE_FALSE(uut.contains(0x1235));
+
+  uut.erase(0x1234);
+  REQUIRE_FALSE(uut.contains(0x1234));
+}
+
+TEST_CASE("A prefetch filter of zero entries holds nothing") {
+  champsim::prefetch_filter uut{0};
+  uut.insert(0x1234);
+  REQUIRE_FALSE(uut.contains(0x1234));
+}
+
+TEST_CASE("A prefetch filter must fill a whole number of sets") {
+  REQUIRE_NOTHROW(champsim::prefetch_filter{6});
+  REQUIRE_NOTHROW(champsim::prefetch_filter{24});
+  REQUIRE_THROWS_AS(champsim::prefetch_filter{12}, std::invalid_argument);
+}
+
+TEST_CASE("A full prefetch filter replaces its oldest block") {
+  champsim::prefetch_filter uut{4};
+  for (uint64_t block = 0; block < 5; ++block)
+    uut.insert(block);
+
+  REQUIRE_FALSE(uut.contains(0));
+  for (uint64_t block = 1; block < 5; ++block)
+    REQUIRE(uut.contains(block));
+}
+
+SCENARIO("A cache with a prefetch filter drops redundant prefetches") {
+  GIVEN("A cache with a prefetch filter") {
+    champsim::initialize_capability_memory(1);
+    release_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("427-uut")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetch_filter_size(16)
+    };
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    auto run = [&]{
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+    };
+
+    WHEN("The same block is prefetched twice") {
+      REQUIRE(uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+      REQUIRE(uut.prefetch_line(champsim::address{0xdeadbec0}, true, 0));
+      run();
+
+      THEN("Only the first prefetch is issued") {
+        CHECK(uut.sim_stats.pf_requested == 1);
+        CHECK(uut.sim_stats.pf_issued == 1);
+        CHECK(uut.sim_stats.pf_dropped_recent == 1);
+        CHECK(mock_ll.packet_count() == 1);
+      }
+
+      AND_WHEN("The block is prefetched again while its miss is in flight") {
+        REQUIRE(uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+
+        THEN("The prefetch is dropped") {
+          CHECK(uut.sim_stats.pf_issued == 1);
+          CHECK(uut.sim_stats.pf_dropped_inflight == 1);
+        }
+      }
+
+      AND_WHEN("The block is prefetched again after it is filled") {
+        mock_ll.release_all();
+        run();
+        REQUIRE(uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+
+        THEN("The prefetch is dropped") {
+          CHECK(uut.sim_stats.pf_issued == 1);
+          CHECK(uut.sim_stats.pf_dropped_resident == 1);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("A cache's prefetch filter holds only the prefetches that fill it") {
+  GIVEN("A cache with a prefetch filter") {
+    champsim::initialize_capability_memory(1);
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("427-lower-fill")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .prefetch_filter_size(16)
+    };
+
+    for (auto elem : std::array<champsim::operable*, 3>{{&mock_ll, &mock_ul, &uut}}) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A block is prefetched into a lower level, and then into this level") {
+      REQUIRE(uut.prefetch_line(champsim::address{0xdeadbeef}, false, 0));
+      REQUIRE(uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+
+      THEN("Both prefetches are issued") {
+        CHECK(uut.sim_stats.pf_issued == 2);
+        CHECK(uut.sim_stats.pf_dropped_recent == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("A cache without a prefetch filter issues every prefetch") {
+  GIVEN("A cache without a prefetch filter") {
+    champsim::initialize_capability_memory(1);
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+      .name("427-unfiltered")
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+    };
+
+    for (auto elem : std::array<champsim::operable*, 3>{{&mock_ll, &mock_ul, &uut}}) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("The same block is prefetched twice") {
+      REQUIRE(uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+      REQUIRE(uut.prefetch_line(champsim::address{0xdeadbeef}, true, 0));
+
+      THEN("Both prefetches are issued") {
+        CHECK(uut.sim_stats.pf_issued == 2);
+        CHECK(uut.sim_stats.pf_dropped_recent == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,59 @@
+#include <catch.hpp>
+#include "mocks.hpp"
+#include "defaults.hpp"
+
+#include "dram_controller.h"
+#include "functional_warmer.h"
+#include "ptw.h"
+#include "vmem.h"
+
+SCENARIO("A functional walk returns the translation and fills the PSCLs") {
+  GIVEN("A 5-level virtual memory") {
+    constexpr std::size_t levels = 5;
+    MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{3200}, champsim::chrono::picoseconds{6400}, std::size_t{18}, std::size_t{18}, std::size_t{18}, std::size_t{38}, champsim::chrono::microseconds{64000}, {}, 64, 64, 1, champsim::data::bytes{8}, 1024, 1024, 4, 4, 4, 8192};
+    VirtualMemory vmem{champsim::data::bytes{1<<12}, levels, champsim::chrono::nanoseconds{640}, dram};
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    PageTableWalker uut{champsim::ptw_builder{champsim::defaults::default_ptw}
+      .name("604-uut")
+      .clock_period(champsim::chrono::picoseconds{3200})
+      .upper_levels({&mock_ul.queues})
+      .lower_level(&mock_ll.queues)
+      .virtual_memory(&vmem)
+      .add_pscl(5,1,1)
+      .add_pscl(4,1,1)
+      .add_pscl(3,1,1)
+      .add_pscl(2,1,1)
+    };
+
+    uut.warmup = true;
+    uut.begin_phase();
+
+    champsim::functional_warmer warmer{{}, {uut}};
+
+    WHEN("A translation is warmed") {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xffff'ffff'ffff'ffff};
+      test.v_address = test.address;
+      test.cpu = 0;
+
+      auto response = warmer.access(&mock_ul.queues, test);
+
+      THEN("The response holds the physical page") {
+        CHECK(champsim::page_number{response.data} == vmem.va_to_pa(0, champsim::page_number{test.address}).first);
+      }
+
+      THEN("No request waits in the queues") {
+        CHECK(mock_ll.packet_count() == 0);
+        CHECK(std::empty(mock_ll.queues.RQ));
+      }
+
+      THEN("The PSCLs contain the request's address") {
+        CHECK(uut.pscl.at(0).check_hit({test.address, champsim::address{}, 4}).has_value());
+        CHECK(uut.pscl.at(1).check_hit({test.address, champsim::address{}, 3}).has_value());
+        CHECK(uut.pscl.at(2).check_hit({test.address, champsim::address{}, 2}).has_value());
+        CHECK(uut.pscl.at(3).check_hit({test.address, champsim::address{}, 1}).has_value());
+      }
+    }
+  }
+}
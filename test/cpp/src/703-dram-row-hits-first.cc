@@ -0,0 +1,84 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <limits>
+
+#include "dram_controller.h"
+
+namespace
+{
+// With one rank and bankgroup and two banks, the row is above the 6 offset bits, the bank bit, and the 4 column bits.
+// The bank is swizzled with the parity of the row, so rows 1 and 2 share a bank.
+champsim::channel::request_type request_to(uint64_t row, uint64_t column)
+{
+  champsim::channel::request_type r;
+  r.type = access_type::LOAD;
+  r.address = champsim::address{(row << 11) | (column << 7)};
+  r.response_requested = false;
+  return r;
+}
+
+void enqueue(MEMORY_CONTROLLER& uut, std::size_t slot, champsim::channel::request_type pkt)
+{
+  auto& entry = uut.channels[0].RQ.at(slot);
+  entry = DRAM_CHANNEL::request_type{pkt};
+  entry->forward_checked = false;
+  entry->scheduled = false;
+  entry->ready_time = uut.current_time;
+}
+
+void operate_until_empty(MEMORY_CONTROLLER& uut)
+{
+  auto& rq = uut.channels[0].RQ;
+  for (auto i = 0; i < 1000 && std::any_of(std::begin(rq), std::end(rq), [](const auto& x) { return x.has_value(); }); ++i) {
+    uut._operate();
+  }
+}
+
+// Operate until one of the given slots is scheduled, and return it
+std::size_t first_scheduled(MEMORY_CONTROLLER& uut, std::initializer_list<std::size_t> slots)
+{
+  auto& rq = uut.channels[0].RQ;
+  for (auto i = 0; i < 1000; ++i) {
+    uut._operate();
+    for (auto slot : slots) {
+      if (!rq.at(slot).has_value() || rq.at(slot)->scheduled) {
+        return slot;
+      }
+    }
+  }
+  return std::numeric_limits<std::size_t>::max();
+}
+} // namespace
+
+SCENARIO("The DRAM scheduling policy decides whether a younger row hit passes an older row miss") {
+  auto [policy, expected_slot] = GENERATE(as<std::pair<champsim::dram_scheduling_policy, std::size_t>>{},
+      std::pair{champsim::dram_scheduling_policy{champsim::dram_scheduler::fcfs, champsim::dram_page_policy::open, 0}, std::size_t{1}},
+      std::pair{champsim::dram_scheduling_policy{champsim::dram_scheduler::frfcfs, champsim::dram_page_policy::open, 0}, std::size_t{2}},
+      std::pair{champsim::dram_scheduling_policy{champsim::dram_scheduler::frfcfs, champsim::dram_page_policy::closed, 0}, std::size_t{1}},
+      std::pair{champsim::dram_scheduling_policy{champsim::dram_scheduler::frfcfs, champsim::dram_page_policy::open, 1}, std::size_t{1}});
+
+  GIVEN("A memory controller with a bank that is serving a hit to its open row") {
+    const auto clock_period = champsim::chrono::picoseconds{3200};
+    MEMORY_CONTROLLER uut{clock_period, clock_period * 2, 2, 2, 20, 4, champsim::chrono::microseconds{64000}, {}, 8, 8, 1, champsim::data::bytes{8}, 65536,
+                          128, 1, 1, 2, 8192, policy};
+    uut.warmup = false;
+    uut.channels[0].warmup = false;
+
+    enqueue(uut, 0, request_to(1, 0));
+    operate_until_empty(uut);
+    enqueue(uut, 0, request_to(1, 1));
+    uut._operate();
+    REQUIRE(uut.channels[0].RQ.at(0)->scheduled);
+
+    WHEN("A request to another row is followed by a request to the open row") {
+      enqueue(uut, 1, request_to(2, 2));
+      uut._operate();
+      enqueue(uut, 2, request_to(1, 3));
+
+      THEN("The request chosen by the policy is scheduled first") {
+        REQUIRE(first_scheduled(uut, {1, 2}) == expected_slot);
+      }
+    }
+  }
+}
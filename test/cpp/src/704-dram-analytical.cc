@@ -0,0 +1,75 @@
+#include <catch.hpp>
+
+#include <algorithm>
+
+#include "dram_controller.h"
+
+namespace
+{
+// With one rank and bankgroup and two banks, the row is above the 6 offset bits, the bank bit, and the 4 column bits.
+// The bank is swizzled with the parity of the row.
+champsim::channel::request_type request_to(uint64_t row, uint64_t column, uint64_t bank_bit = 0)
+{
+  champsim::channel::request_type r;
+  r.type = access_type::LOAD;
+  r.address = champsim::address{(row << 11) | (column << 7) | (bank_bit << 6)};
+  r.response_requested = false;
+  return r;
+}
+
+void enqueue(MEMORY_CONTROLLER& uut, std::size_t slot, champsim::channel::request_type pkt)
+{
+  auto& entry = uut.channels[0].RQ.at(slot);
+  entry = DRAM_CHANNEL::request_type{pkt};
+  entry->forward_checked = false;
+  entry->scheduled = false;
+  entry->ready_time = uut.current_time;
+}
+
+// Operate until the read queue is empty, and return the number of cycles it took
+long operate_until_empty(MEMORY_CONTROLLER& uut)
+{
+  auto& rq = uut.channels[0].RQ;
+  long cycles = 0;
+  for (; cycles < 1000 && std::any_of(std::begin(rq), std::end(rq), [](const auto& x) { return x.has_value(); }); ++cycles) {
+    uut._operate();
+  }
+  return cycles;
+}
+} // namespace
+
+SCENARIO("An analytical memory controller returns requests after their row latency") {
+  GIVEN("An analytical memory controller") {
+    const auto clock_period = champsim::chrono::picoseconds{3200};
+    MEMORY_CONTROLLER uut{clock_period, clock_period * 2, 2, 2, 20, 4, champsim::chrono::microseconds{64000}, {}, 8, 8, 1, champsim::data::bytes{8}, 65536,
+                          128, 1, 1, 2, 8192, {}, champsim::dram_model::analytical};
+    uut.warmup = false;
+    uut.channels[0].warmup = false;
+
+    WHEN("A request misses and then another hits in the same row") {
+      enqueue(uut, 0, request_to(1, 0));
+      auto miss_cycles = operate_until_empty(uut);
+      enqueue(uut, 0, request_to(1, 1));
+      auto hit_cycles = operate_until_empty(uut);
+
+      THEN("Both return, and the hit returns sooner") {
+        REQUIRE(miss_cycles < 1000);
+        REQUIRE(hit_cycles < miss_cycles);
+        CHECK(uut.channels[0].sim_stats.RQ_ROW_BUFFER_MISS == 1);
+        CHECK(uut.channels[0].sim_stats.RQ_ROW_BUFFER_HIT == 1);
+        CHECK(uut.channels[0].sim_stats.refresh_cycles == 0);
+      }
+    }
+
+    WHEN("Two requests to different banks arrive together") {
+      enqueue(uut, 0, request_to(1, 0, 0));
+      enqueue(uut, 1, request_to(1, 0, 1));
+      operate_until_empty(uut);
+
+      THEN("The second waits for the first to leave the data bus") {
+        CHECK(uut.channels[0].sim_stats.RQ_ROW_BUFFER_MISS == 2);
+        CHECK(uut.channels[0].sim_stats.dbus_count_congested == 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,65 @@
+#include <catch.hpp>
+
+#include <algorithm>
+
+#include "dram_controller.h"
+
+namespace
+{
+// With one rank and bankgroup and two banks, the row is above the 6 offset bits, the bank bit, and the 4 column bits.
+// The bank is swizzled with the parity of the row.
+champsim::channel::request_type request_to(uint64_t row, uint64_t column)
+{
+  champsim::channel::request_type r;
+  r.type = access_type::LOAD;
+  r.address = champsim::address{(row << 11) | (column << 7)};
+  r.response_requested = false;
+  return r;
+}
+
+void enqueue(MEMORY_CONTROLLER& uut, std::size_t slot, champsim::channel::request_type pkt)
+{
+  auto& entry = uut.channels[0].RQ.at(slot);
+  entry = DRAM_CHANNEL::request_type{pkt};
+  entry->forward_checked = false;
+  entry->scheduled = false;
+  entry->ready_time = uut.current_time;
+}
+
+// Operate until the read queue is empty, and return the number of cycles it took
+long operate_until_empty(MEMORY_CONTROLLER& uut)
+{
+  auto& rq = uut.channels[0].RQ;
+  long cycles = 0;
+  for (; cycles < 1000 && std::any_of(std::begin(rq), std::end(rq), [](const auto& x) { return x.has_value(); }); ++cycles) {
+    uut._operate();
+  }
+  return cycles;
+}
+} // namespace
+
+SCENARIO("A closed-page memory controller charges each access for precharging the row before it") {
+  auto model = GENERATE(champsim::dram_model::detailed, champsim::dram_model::analytical);
+
+  GIVEN("A closed-page memory controller with a long precharge") {
+    const auto clock_period = champsim::chrono::picoseconds{3200};
+    MEMORY_CONTROLLER uut{clock_period, clock_period * 2, 20, 2, 20, 4, champsim::chrono::microseconds{64000}, {}, 8, 8, 1, champsim::data::bytes{8}, 65536,
+                          128, 1, 1, 2, 8192, champsim::dram_scheduling_policy{champsim::dram_scheduler::frfcfs, champsim::dram_page_policy::closed, 0},
+                          model};
+    uut.warmup = false;
+    uut.channels[0].warmup = false;
+
+    WHEN("A request to a bank is followed at once by another to the same bank") {
+      enqueue(uut, 0, request_to(1, 0));
+      auto first_cycles = operate_until_empty(uut);
+      enqueue(uut, 0, request_to(1, 1));
+      auto second_cycles = operate_until_empty(uut);
+
+      THEN("The second waits for the first's row to be precharged") {
+        REQUIRE(first_cycles < 1000);
+        REQUIRE(second_cycles > first_cycles);
+        CHECK(uut.channels[0].sim_stats.RQ_ROW_BUFFER_MISS == 2);
+      }
+    }
+  }
+}
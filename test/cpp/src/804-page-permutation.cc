@@ -0,0 +1,73 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "page_permutation.h"
+#include "vmem.h"
+
+#include "dram_controller.h"
+
+namespace
+{
+std::vector<uint64_t> evaluate(const champsim::page_permutation& uut)
+{
+  std::vector<uint64_t> result(uut.size());
+  std::iota(std::begin(result), std::end(result), uint64_t{0});
+  std::transform(std::begin(result), std::end(result), std::begin(result), [&uut](auto i) { return uut(i); });
+  return result;
+}
+} // namespace
+
+TEST_CASE("A seeded page permutation is a bijection") {
+  auto size = GENERATE(as<uint64_t>{}, 1, 2, 3, 17, 256, 1000);
+  champsim::page_permutation uut{size, 1};
+
+  auto permuted = evaluate(uut);
+  std::sort(std::begin(permuted), std::end(permuted));
+
+  std::vector<uint64_t> expected(size);
+  std::iota(std::begin(expected), std::end(expected), uint64_t{0});
+  REQUIRE(permuted == expected);
+}
+
+TEST_CASE("An unseeded page permutation is the identity") {
+  champsim::page_permutation uut{100, std::nullopt};
+
+  std::vector<uint64_t> expected(100);
+  std::iota(std::begin(expected), std::end(expected), uint64_t{0});
+  REQUIRE(evaluate(uut) == expected);
+}
+
+TEST_CASE("A page permutation is determined by its seed") {
+  champsim::page_permutation uut{1000, 1};
+
+  REQUIRE(evaluate(uut) == evaluate(champsim::page_permutation{1000, 1}));
+  REQUIRE(evaluate(uut) != evaluate(champsim::page_permutation{1000, 2}));
+}
+
+SCENARIO("A randomized virtual memory hands out distinct physical pages") {
+  GIVEN("A virtual memory with a randomization seed") {
+    MEMORY_CONTROLLER dram{champsim::chrono::picoseconds{3200}, champsim::chrono::picoseconds{6400}, std::size_t{18}, std::size_t{18}, std::size_t{18}, std::size_t{38}, champsim::chrono::microseconds{64000}, {}, 64, 64, 1, champsim::data::bytes{8}, 1024, 1024, 4, 4, 4, 8192};
+    VirtualMemory uut{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram, 1};
+    auto original_size = uut.available_ppages();
+
+    WHEN("Many virtual pages are translated") {
+      std::vector<champsim::page_number> ppages;
+      for (uint64_t vpage = 0; vpage < 1000; ++vpage) {
+        ppages.push_back(uut.va_to_pa(0, champsim::page_number{vpage}).first);
+      }
+
+      THEN("Every physical page is different") {
+        std::sort(std::begin(ppages), std::end(ppages));
+        REQUIRE(std::adjacent_find(std::begin(ppages), std::end(ppages)) == std::end(ppages));
+        REQUIRE(uut.available_ppages() == original_size - 1000);
+      }
+
+      THEN("The physical pages are not in order") {
+        REQUIRE_FALSE(std::is_sorted(std::begin(ppages), std::end(ppages)));
+      }
+    }
+  }
+}
@@ -0,0 +1,153 @@
+#include <catch.hpp>
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <vector>
+#include <fmt/core.h>
+
+#include "checkpoint.h"
+#include "translation_table.h"
+#include "vmem.h"
+
+#include "dram_controller.h"
+
+namespace
+{
+MEMORY_CONTROLLER make_dram()
+{
+  return MEMORY_CONTROLLER{champsim::chrono::picoseconds{3200}, champsim::chrono::picoseconds{6400}, std::size_t{18}, std::size_t{18}, std::size_t{18},
+                           std::size_t{38}, champsim::chrono::microseconds{64000}, {}, 64, 64, 1, champsim::data::bytes{8}, 1024, 1024, 4, 4, 4, 8192};
+}
+
+// A sparse heap: clusters of consecutive pages, scattered across the virtual address space
+std::vector<champsim::page_number> sparse_heap(std::size_t clusters, std::size_t pages_per_cluster)
+{
+  std::mt19937_64 rng{11};
+  std::vector<champsim::page_number> vpages;
+  for (std::size_t i = 0; i < clusters; ++i) {
+    uint64_t base = (rng() & 0xffff'ffffULL) << 12;
+    for (std::size_t j = 0; j < pages_per_cluster; ++j) {
+      vpages.emplace_back(base + j);
+    }
+  }
+  return vpages;
+}
+} // namespace
+
+TEST_CASE("A translation table finds the values inserted into it") {
+  champsim::translation_table<uint64_t> uut;
+  for (uint64_t i = 0; i < 5000; ++i) {
+    REQUIRE(uut.try_emplace({0, 0, i * 4099}, i).second);
+  }
+
+  REQUIRE(uut.size() == 5000);
+  for (uint64_t i = 0; i < 5000; ++i) {
+    auto [value, inserted] = uut.try_emplace({0, 0, i * 4099}, 0);
+    REQUIRE_FALSE(inserted);
+    REQUIRE(*value == i);
+  }
+}
+
+TEST_CASE("A translation table distinguishes address spaces and levels") {
+  champsim::translation_table<uint64_t> uut;
+  uut.try_emplace({0, 0, 0x1234}, 1);
+  uut.try_emplace({1, 0, 0x1234}, 2);
+  uut.try_emplace({0, 1, 0x1234}, 3);
+
+  REQUIRE(uut.size() == 3);
+  REQUIRE(*uut.try_emplace({1, 0, 0x1234}, 0).first == 2);
+  REQUIRE(*uut.try_emplace({0, 1, 0x1234}, 0).first == 3);
+}
+
+SCENARIO("A restored virtual memory holds the translations that were saved") {
+  GIVEN("A virtual memory with translations in two address spaces") {
+    auto dram = make_dram();
+    VirtualMemory uut{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram};
+
+    auto vpages = sparse_heap(8, 300);
+    std::vector<champsim::page_number> ppages;
+    for (auto vpage : vpages) {
+      ppages.push_back(uut.va_to_pa(0, vpage).first);
+      uut.va_to_pa(1, vpage);
+    }
+    auto [pte_paddr, pte_delay] = uut.get_pte_pa(0, vpages.front(), 2);
+
+    WHEN("Its state is loaded into another virtual memory") {
+      champsim::checkpoint_writer out;
+      uut.save_state(out);
+
+      VirtualMemory restored{champsim::data::bytes{1 << 12}, 5, std::chrono::nanoseconds{6400}, dram};
+      champsim::checkpoint_reader in{out.data()};
+      restored.load_state(in);
+
+      THEN("Every translation is the same and does not fault") {
+        for (std::size_t i = 0; i < std::size(vpages); ++i) {
+          auto [ppage, delay] = restored.va_to_pa(0, vpages[i]);
+          REQUIRE(ppage == ppages[i]);
+          REQUIRE(delay == champsim::chrono::clock::duration::zero());
+        }
+
+        auto [restored_pte_paddr, restored_pte_delay] = restored.get_pte_pa(0, vpages.front(), 2);
+        REQUIRE(restored_pte_paddr == pte_paddr);
+        REQUIRE(restored_pte_delay == champsim::chrono::clock::duration::zero());
+        REQUIRE(restored.available_ppages() == uut.available_ppages());
+      }
+
+      THEN("The translations of the other address space are restored too") {
+        for (auto vpage : vpages) {
+          REQUIRE(restored.va_to_pa(1, vpage) == uut.va_to_pa(1, vpage));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Page walks over a sparse heap are faster with a translation table", "[.][benchmark]") {
+  constexpr std::size_t num_walks = 5'000'000;
+  constexpr std::size_t levels = 5;
+
+  auto dram = make_dram();
+  VirtualMemory uut{champsim::data::bytes{1 << 12}, levels, std::chrono::nanoseconds{6400}, dram, 1};
+  auto vpages = sparse_heap(256, 256);
+
+  // The ordered maps that this replaces, keyed the same way
+  std::map<std::pair<uint32_t, uint64_t>, uint64_t> page_map;
+  std::map<std::tuple<uint32_t, uint32_t, uint64_t>, uint64_t> pte_map;
+  for (auto vpage : vpages) {
+    page_map.try_emplace({0, vpage.to<uint64_t>()}, uut.va_to_pa(0, vpage).first.to<uint64_t>());
+    for (std::size_t level = 1; level <= levels; ++level) {
+      auto vaddr = champsim::address_slice{champsim::dynamic_extent{champsim::address::bits, uut.shamt(level + 1)}, vpage}.to<uint64_t>();
+      pte_map.try_emplace({0, static_cast<uint32_t>(level), vaddr}, uut.get_pte_pa(0, vpage, level).first.to<uint64_t>());
+    }
+  }
+
+  auto time = [&](auto&& walk) {
+    uint64_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < num_walks; ++i) {
+      total += walk(vpages[(i * 7919) % std::size(vpages)]);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return std::pair{total, static_cast<double>(num_walks) / elapsed.count()};
+  };
+
+  auto [table_total, table_rate] = time([&](champsim::page_number vpage) {
+    uint64_t total = uut.va_to_pa(0, vpage).first.to<uint64_t>();
+    for (std::size_t level = 1; level <= levels; ++level) {
+      total += uut.get_pte_pa(0, vpage, level).first.slice_upper(champsim::data::bits{LOG2_PAGE_SIZE}).to<uint64_t>();
+    }
+    return total;
+  });
+  auto [map_total, map_rate] = time([&](champsim::page_number vpage) {
+    uint64_t total = page_map.at({0, vpage.to<uint64_t>()});
+    for (std::size_t level = 1; level <= levels; ++level) {
+      auto vaddr = champsim::address_slice{champsim::dynamic_extent{champsim::address::bits, uut.shamt(level + 1)}, vpage}.to<uint64_t>();
+      total += champsim::address{pte_map.at({0, static_cast<uint32_t>(level), vaddr})}.slice_upper(champsim::data::bits{LOG2_PAGE_SIZE}).to<uint64_t>();
+    }
+    return total;
+  });
+
+  fmt::print("translation table: {:.3e} walks/second, ordered maps: {:.3e} walks/second\n", table_rate, map_rate);
+  REQUIRE(table_total == map_total);
+}
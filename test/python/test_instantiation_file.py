@@ -105,12 +105,12 @@ class CpuBuilderTest(unittest.TestCase):
         self.get_element_diff(['.dib_window(1)'], DIB={ 'window_size': 1 })
 
     def test_branch_predictor(self):
-        self.get_element_diff(['.branch_predictor<class a_class>()'], _branch_predictor_data=[{ 'name': 'a', 'class': 'a_class' }])
-        self.get_element_diff(['.branch_predictor<class a_class, class b_class>()'], _branch_predictor_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
+        self.get_element_diff(['.branch_predictor<class a_class>({"a"})'], _branch_predictor_data=[{ 'name': 'a', 'class': 'a_class' }])
+        self.get_element_diff(['.branch_predictor<class a_class, class b_class>({"a", "b"})'], _branch_predictor_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
 
     def test_btb(self):
-        self.get_element_diff(['.btb<class a_class>()'], _btb_data=[{ 'name': 'a', 'class': 'a_class' }])
-        self.get_element_diff(['.btb<class a_class, class b_class>()'], _btb_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
+        self.get_element_diff(['.btb<class a_class>({"a"})'], _btb_data=[{ 'name': 'a', 'class': 'a_class' }])
+        self.get_element_diff(['.btb<class a_class, class b_class>({"a", "b"})'], _btb_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
 
 class CacheBuilderTests(unittest.TestCase):
 
@@ -142,6 +142,9 @@ class CacheBuilderTests(unittest.TestCase):
     def test_pq_size(self):
         self.get_element_diff(['.pq_size(1)'], pq_size=1)
 
+    def test_prefetch_filter_size(self):
+        self.get_element_diff(['.prefetch_filter_size(1)'], prefetch_filter_size=1)
+
     def test_mshr_size(self):
         self.get_element_diff(['.mshr_size(1)'], mshr_size=1)
 
@@ -181,12 +184,12 @@ class CacheBuilderTests(unittest.TestCase):
         self.get_element_diff(['.lower_translate(&test_cache_to_test_lt_channel)'], lower_translate='test_lt')
 
     def test_prefetcher(self):
-        self.get_element_diff(['.prefetcher<class a_class>()'], _prefetcher_data=[{ 'name': 'a', 'class': 'a_class' }])
-        self.get_element_diff(['.prefetcher<class a_class, class b_class>()'], _prefetcher_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
+        self.get_element_diff(['.prefetcher<class a_class>({"a"})'], _prefetcher_data=[{ 'name': 'a', 'class': 'a_class' }])
+        self.get_element_diff(['.prefetcher<class a_class, class b_class>({"a", "b"})'], _prefetcher_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
 
     def test_replacement(self):
-        self.get_element_diff(['.replacement<class a_class>()'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }])
-        self.get_element_diff(['.replacement<class a_class, class b_class>()'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
+        self.get_element_diff(['.replacement<class a_class>({"a"})'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }])
+        self.get_element_diff(['.replacement<class a_class, class b_class>({"a", "b"})'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
 
 class PageTableWalkerBuilderTests(unittest.TestCase):
 
@@ -304,3 +307,40 @@ class GetQueueInfoTests(unittest.TestCase):
             { 'is_good_boy': False }
         ]
         self.assertEqual(expected, evaluated)
+
+class GetVariantsTests(unittest.TestCase):
+    def test_header_names_variants(self):
+        evaluated = list(config.instantiation_file.get_variants_header('abc', ['first', 'second']))
+        self.assertIn('struct champsim::configured::variants<0xabc>', evaluated)
+        self.assertIn('  constexpr static std::array<std::string_view, 2> names{{"first", "second"}};', evaluated)
+
+    def test_variants_are_made_in_order(self):
+        evaluated = list(config.instantiation_file.get_variants_lines('abc', ['111', '222']))
+        self.assertIn('  case 0: return std::make_unique<champsim::configured::generated_environment<0x111>>();', evaluated)
+        self.assertIn('  case 1: return std::make_unique<champsim::configured::generated_environment<0x222>>();', evaluated)
+
+class GetDramSchedulingTests(unittest.TestCase):
+    def test_default_is_fcfs_with_open_pages(self):
+        evaluated = config.instantiation_file.get_dram_scheduling({})
+        self.assertEqual(evaluated, 'champsim::dram_scheduling_policy{champsim::dram_scheduler::fcfs, champsim::dram_page_policy::open, 0}')
+
+    def test_policy_is_selected(self):
+        evaluated = config.instantiation_file.get_dram_scheduling({'scheduler': 'frfcfs', 'page_policy': 'closed', 'row_hit_cap': 4})
+        self.assertEqual(evaluated, 'champsim::dram_scheduling_policy{champsim::dram_scheduler::frfcfs, champsim::dram_page_policy::closed, 4}')
+
+    def test_unknown_policies_are_rejected(self):
+        for pmem in ({'scheduler': 'lifo'}, {'page_policy': 'ajar'}, {'row_hit_cap': -1}):
+            with self.subTest(pmem=pmem):
+                with self.assertRaises(ValueError):
+                    config.instantiation_file.get_dram_scheduling(pmem)
+
+class GetDramModelTests(unittest.TestCase):
+    def test_default_is_detailed(self):
+        self.assertEqual(config.instantiation_file.get_dram_model({}), 'champsim::dram_model::detailed')
+
+    def test_analytical_is_selected(self):
+        self.assertEqual(config.instantiation_file.get_dram_model({'model': 'analytical'}), 'champsim::dram_model::analytical')
+
+    def test_unknown_models_are_rejected(self):
+        with self.assertRaises(ValueError):
+            config.instantiation_file.get_dram_model({'model': 'magic'})
@@ -714,3 +714,35 @@ class PathEndInTests(unittest.TestCase):
                 path = ({'name': x} for x in range(length))
                 result = config.parse.path_end_in(path, 'last')
                 self.assertEqual(result, {'name': length-1, 'lower_level': 'last'})
+
+class ParseVariantsTests(unittest.TestCase):
+    def test_no_variants(self):
+        self.assertEqual(config.parse.parse_variants({}), [])
+
+    def test_variant_overrides_configuration(self):
+        result = config.parse.parse_variants({'L1D': {'prefetcher': 'no'}, 'variants': [{'name': 'nl', 'L1D': {'prefetcher': 'next_line'}}]})
+        self.assertEqual(len(result), 1)
+        name, (_, elements, *_) = result[0]
+        self.assertEqual(name, 'nl')
+        l1d = next(c for c in elements['caches'] if c['name'] == 'cpu0_L1D')
+        self.assertEqual([p['class'] for p in l1d['_prefetcher_data']], ['next_line'])
+
+    def test_variants_from_each_configuration(self):
+        result = config.parse.parse_variants({'variants': [{'name': 'a'}]}, {'variants': [{'name': 'b'}]})
+        self.assertEqual([n for n,_ in result], ['a', 'b'])
+
+    def test_variant_needs_name(self):
+        with self.assertRaises(ValueError):
+            config.parse.parse_variants({'variants': [{'L1D': {'prefetcher': 'next_line'}}]})
+
+    def test_variant_names_are_unique(self):
+        for names in (('a', 'a'), ('base',)):
+            with self.subTest(names=names):
+                with self.assertRaises(ValueError):
+                    config.parse.parse_variants({'variants': [{'name': n} for n in names]})
+
+    def test_variant_keeps_shared_parameters(self):
+        for key in ('num_cores', 'block_size', 'page_size'):
+            with self.subTest(key=key):
+                with self.assertRaises(ValueError):
+                    config.parse.parse_variants({'variants': [{'name': 'a', key: 2}]})